@@ -18,6 +18,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if TINT_BUILD_SPV_READER
@@ -46,6 +47,11 @@ struct Options {
   bool parse_only = false;
   bool dump_ast = false;
   bool dawn_validation = false;
+#ifndef NDEBUG
+  bool check_structure = true;
+#else
+  bool check_structure = false;
+#endif
   bool demangle = false;
 
   Format format = Format::kNone;
@@ -81,6 +87,10 @@ const char kUsage[] = R"(Usage: tint [options] <input-file>
   --dump-ast                -- Dump the generated AST to stdout
   --dawn-validation         -- SPIRV outputs are validated with the same flags
                                as Dawn does. Has no effect on non-SPIRV outputs.
+  --check-structure         -- SPIRV outputs are checked for structural errors,
+                               a cheap subset of validation. Enabled by default
+                               in debug builds.
+  --no-check-structure      -- Disables --check-structure.
   --demangle                -- Preserve original source names. Demangle them.
                                Affects AST dumping, and text-based output languages.
   -h                        -- This help text)";
@@ -248,6 +258,10 @@ bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
       opts->dump_ast = true;
     } else if (arg == "--dawn-validation") {
       opts->dawn_validation = true;
+    } else if (arg == "--check-structure") {
+      opts->check_structure = true;
+    } else if (arg == "--no-check-structure") {
+      opts->check_structure = false;
     } else if (arg == "--demangle") {
       opts->demangle = true;
     } else if (!arg.empty()) {
@@ -367,6 +381,67 @@ bool WriteFile(const std::string& output_file,
 }
 
 #if TINT_BUILD_SPV_WRITER
+/// An OutputSink that writes the SPIR-V words to a FILE
+class FileOutputSink : public tint::writer::spirv::OutputSink {
+ public:
+  explicit FileOutputSink(FILE* file) : file_(file) {}
+
+  void Write(const uint32_t* words, size_t count) override {
+    if (!failed_ && fwrite(words, sizeof(uint32_t), count, file_) != count) {
+      failed_ = true;
+    }
+  }
+
+  /// @returns true if any of the writes failed
+  bool failed() const { return failed_; }
+
+ private:
+  FILE* const file_;
+  bool failed_ = false;
+};
+
+/// Generates the SPIR-V binary with `generator`, streaming it to
+/// `output_file` as it is assembled. If `output_file` is empty or "-", writes
+/// to standard output. If any error occurs, returns false and outputs error
+/// message to standard error.
+/// @returns true on success
+bool StreamSpirv(const std::string& output_file,
+                 tint::writer::spirv::Generator* generator) {
+  const bool use_stdout = output_file.empty() || output_file == "-";
+  FILE* file = stdout;
+
+  if (!use_stdout) {
+#if defined(_MSC_VER)
+    fopen_s(&file, output_file.c_str(), "wb");
+#else
+    file = fopen(output_file.c_str(), "wb");
+#endif
+    if (!file) {
+      std::cerr << "Could not open file " << output_file << " for writing"
+                << std::endl;
+      return false;
+    }
+  }
+
+  FileOutputSink sink(file);
+  bool ok = generator->Generate(&sink);
+  if (!ok) {
+    std::cerr << "Failed to generate: " << generator->error() << std::endl;
+  } else if (sink.failed()) {
+    if (use_stdout) {
+      std::cerr << "Could not write all output to standard output" << std::endl;
+    } else {
+      std::cerr << "Could not write to file " << output_file << std::endl;
+    }
+    ok = false;
+  }
+  if (!use_stdout) {
+    fclose(file);
+  }
+
+  return ok;
+}
+
 std::string Disassemble(const std::vector<uint32_t>& data) {
   std::string spv_errors;
   spv_target_env target_env = SPV_ENV_UNIVERSAL_1_0;
@@ -548,7 +623,10 @@ int main(int argc, const char** argv) {
 
 #if TINT_BUILD_SPV_WRITER
   if (options.format == Format::kSpirv || options.format == Format::kSpvAsm) {
-    writer = std::make_unique<tint::writer::spirv::Generator>(program.get());
+    auto generator =
+        std::make_unique<tint::writer::spirv::Generator>(program.get());
+    generator->set_check_structure(options.check_structure);
+    writer = std::move(generator);
   }
 #endif  // TINT_BUILD_SPV_WRITER
 
@@ -575,6 +653,16 @@ int main(int argc, const char** argv) {
     return 1;
   }
 
+#if TINT_BUILD_SPV_WRITER
+  // The binary is written out unmodified, so stream it to the output file as
+  // it is assembled instead of holding a copy of the whole module.
+  if (options.format == Format::kSpirv && !options.dawn_validation &&
+      !options.emit_single_entry_point) {
+    auto* w = static_cast<tint::writer::spirv::Generator*>(writer.get());
+    return StreamSpirv(options.output_file, w) ? 0 : 1;
+  }
+#endif  // TINT_BUILD_SPV_WRITER
+
   if (options.emit_single_entry_point) {
     if (!writer->GenerateEntryPoint(options.stage, options.ep_name)) {
       std::cerr << "Failed to generate: " << writer->error() << std::endl;
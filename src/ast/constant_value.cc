@@ -0,0 +1,48 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ast/constant_value.h"
+
+#include <utility>
+
+#include "src/type/matrix_type.h"
+#include "src/type/vector_type.h"
+
+namespace tint {
+namespace ast {
+namespace {
+
+type::Type* ElementTypeOf(type::Type* type) {
+  if (auto* vec = type->As<type::Vector>()) {
+    return vec->type();
+  }
+  if (auto* mat = type->As<type::Matrix>()) {
+    return mat->type();
+  }
+  return type;
+}
+
+}  // namespace
+
+ConstantValue::ConstantValue(type::Type* type, std::vector<Scalar> elements)
+    : type_(type),
+      element_type_(ElementTypeOf(type)),
+      elements_(std::move(elements)) {}
+
+ConstantValue::ConstantValue(const ConstantValue&) = default;
+
+ConstantValue::~ConstantValue() = default;
+
+}  // namespace ast
+}  // namespace tint
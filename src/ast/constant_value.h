@@ -0,0 +1,79 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_AST_CONSTANT_VALUE_H_
+#define SRC_AST_CONSTANT_VALUE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "src/type/type.h"
+
+namespace tint {
+namespace ast {
+
+/// ConstantValue holds the value of an expression that was evaluated at shader
+/// creation time by the ConstantEvaluator.
+class ConstantValue {
+ public:
+  /// Scalar holds a single scalar element of a ConstantValue. The active member
+  /// is given by the element type of the value.
+  union Scalar {
+    /// Constructs a zero scalar
+    Scalar() : u32(0) {}
+    /// @param v the value of a bool element
+    explicit Scalar(bool v) : b(v) {}
+    /// @param v the value of an i32 element
+    explicit Scalar(int32_t v) : i32(v) {}
+    /// @param v the value of a u32 element
+    explicit Scalar(uint32_t v) : u32(v) {}
+    /// @param v the value of a f32 element
+    explicit Scalar(float v) : f32(v) {}
+
+    /// The value of a bool element
+    bool b;
+    /// The value of an i32 element
+    int32_t i32;
+    /// The value of a u32 element
+    uint32_t u32;
+    /// The value of a f32 element
+    float f32;
+  };
+
+  /// Constructor
+  /// @param type the type of the value. Must be a scalar, vector or matrix.
+  /// @param elements the scalar elements of the value. Matrices are stored in
+  /// column-major order.
+  ConstantValue(type::Type* type, std::vector<Scalar> elements);
+  /// Copy constructor
+  ConstantValue(const ConstantValue&);
+  ~ConstantValue();
+
+  /// @returns the type of the value
+  type::Type* type() const { return type_; }
+  /// @returns the scalar type of the elements of the value
+  type::Type* element_type() const { return element_type_; }
+  /// @returns the scalar elements of the value
+  const std::vector<Scalar>& elements() const { return elements_; }
+
+ private:
+  type::Type* const type_;
+  type::Type* const element_type_;
+  std::vector<Scalar> const elements_;
+};
+
+}  // namespace ast
+}  // namespace tint
+
+#endif  // SRC_AST_CONSTANT_VALUE_H_
@@ -23,7 +23,6 @@
 #include "src/program_builder.h"
 #include "src/type/multisampled_texture_type.h"
 #include "src/type/sampled_texture_type.h"
-#include "src/type/texture_type.h"
 
 TINT_INSTANTIATE_CLASS_ID(tint::ast::Function);
 
@@ -41,165 +40,75 @@ Function::Function(const Source& source,
       params_(std::move(params)),
       return_type_(return_type),
       body_(body),
-      decorations_(std::move(decorations)) {}
-
-Function::Function(Function&&) = default;
-
-Function::~Function() = default;
-
-std::tuple<uint32_t, uint32_t, uint32_t> Function::workgroup_size() const {
-  for (auto* deco : decorations_) {
-    if (auto* workgroup = deco->As<WorkgroupDecoration>()) {
-      return workgroup->values();
-    }
-  }
-  return {1, 1, 1};
-}
-
-PipelineStage Function::pipeline_stage() const {
+      decorations_(std::move(decorations)) {
+  bool has_workgroup_size = false;
   for (auto* deco : decorations_) {
     if (auto* stage = deco->As<StageDecoration>()) {
-      return stage->value();
+      if (pipeline_stage_ == PipelineStage::kNone) {
+        pipeline_stage_ = stage->value();
+      }
+    } else if (auto* workgroup = deco->As<WorkgroupDecoration>()) {
+      if (!has_workgroup_size) {
+        workgroup_size_ = workgroup->values();
+        has_workgroup_size = true;
+      }
     }
   }
-  return PipelineStage::kNone;
 }
 
+Function::Function(Function&&) = default;
+
+Function::~Function() = default;
+
 void Function::add_referenced_module_variable(Variable* var) {
-  for (const auto* v : referenced_module_vars_) {
-    if (v->symbol() == var->symbol()) {
-      return;
-    }
+  if (referenced_module_var_symbols_.emplace(var->symbol()).second) {
+    referenced_module_vars_.push_back(var);
+    partition_referenced_module_variable(var);
   }
-  referenced_module_vars_.push_back(var);
 }
 
 void Function::add_local_referenced_module_variable(Variable* var) {
-  for (const auto* v : local_referenced_module_vars_) {
-    if (v->symbol() == var->symbol()) {
-      return;
+  if (local_referenced_module_var_symbols_.emplace(var->symbol()).second) {
+    local_referenced_module_vars_.push_back(var);
+    if (auto* builtin = var->GetBuiltinDecoration()) {
+      local_referenced_builtin_vars_.push_back({var, builtin});
     }
   }
-  local_referenced_module_vars_.push_back(var);
 }
 
-const std::vector<std::pair<Variable*, LocationDecoration*>>
-Function::referenced_location_variables() const {
-  std::vector<std::pair<Variable*, LocationDecoration*>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    for (auto* deco : var->decorations()) {
-      if (auto* location = deco->As<LocationDecoration>()) {
-        ret.push_back({var, location});
-        break;
-      }
-    }
+void Function::partition_referenced_module_variable(Variable* var) {
+  if (auto* location = var->GetLocationDecoration()) {
+    referenced_location_vars_.push_back({var, location});
   }
-  return ret;
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_uniform_variables() const {
-  std::vector<std::pair<Variable*, Function::BindingInfo>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    if (var->storage_class() != StorageClass::kUniform) {
-      continue;
-    }
-
-    BindingDecoration* binding = nullptr;
-    GroupDecoration* group = nullptr;
-    for (auto* deco : var->decorations()) {
-      if (auto* b = deco->As<BindingDecoration>()) {
-        binding = b;
-      } else if (auto* g = deco->As<GroupDecoration>()) {
-        group = g;
-      }
-    }
-    if (binding == nullptr || group == nullptr) {
-      continue;
-    }
-
-    ret.push_back({var, BindingInfo{binding, group}});
+  if (auto* builtin = var->GetBuiltinDecoration()) {
+    referenced_builtin_vars_.push_back({var, builtin});
   }
-  return ret;
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_storagebuffer_variables() const {
-  std::vector<std::pair<Variable*, Function::BindingInfo>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    if (var->storage_class() != StorageClass::kStorage) {
-      continue;
-    }
 
-    BindingDecoration* binding = nullptr;
-    GroupDecoration* group = nullptr;
-    for (auto* deco : var->decorations()) {
-      if (auto* b = deco->As<BindingDecoration>()) {
-        binding = b;
-      } else if (auto* s = deco->As<GroupDecoration>()) {
-        group = s;
-      }
-    }
-    if (binding == nullptr || group == nullptr) {
-      continue;
-    }
-
-    ret.push_back({var, BindingInfo{binding, group}});
+  auto* binding = var->GetBindingDecoration();
+  auto* group = var->GetGroupDecoration();
+  if (binding == nullptr || group == nullptr) {
+    return;
   }
-  return ret;
-}
+  BindingInfo info{binding, group};
 
-const std::vector<std::pair<Variable*, BuiltinDecoration*>>
-Function::referenced_builtin_variables() const {
-  std::vector<std::pair<Variable*, BuiltinDecoration*>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    for (auto* deco : var->decorations()) {
-      if (auto* builtin = deco->As<BuiltinDecoration>()) {
-        ret.push_back({var, builtin});
-        break;
-      }
-    }
+  if (var->storage_class() == StorageClass::kUniform) {
+    referenced_uniform_vars_.push_back({var, info});
+  } else if (var->storage_class() == StorageClass::kStorage) {
+    referenced_storagebuffer_vars_.push_back({var, info});
   }
-  return ret;
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_sampler_variables() const {
-  return ReferencedSamplerVariablesImpl(type::SamplerKind::kSampler);
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_comparison_sampler_variables() const {
-  return ReferencedSamplerVariablesImpl(type::SamplerKind::kComparisonSampler);
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_sampled_texture_variables() const {
-  return ReferencedSampledTextureVariablesImpl(false);
-}
 
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::referenced_multisampled_texture_variables() const {
-  return ReferencedSampledTextureVariablesImpl(true);
-}
-
-const std::vector<std::pair<Variable*, BuiltinDecoration*>>
-Function::local_referenced_builtin_variables() const {
-  std::vector<std::pair<Variable*, BuiltinDecoration*>> ret;
-
-  for (auto* var : local_referenced_module_variables()) {
-    for (auto* deco : var->decorations()) {
-      if (auto* builtin = deco->As<BuiltinDecoration>()) {
-        ret.push_back({var, builtin});
-        break;
-      }
+  auto* unwrapped_type = var->type()->UnwrapIfNeeded();
+  if (auto* sampler = unwrapped_type->As<type::Sampler>()) {
+    if (sampler->kind() == type::SamplerKind::kSampler) {
+      referenced_sampler_vars_.push_back({var, info});
+    } else if (sampler->kind() == type::SamplerKind::kComparisonSampler) {
+      referenced_comparison_sampler_vars_.push_back({var, info});
     }
+  } else if (unwrapped_type->Is<type::MultisampledTexture>()) {
+    referenced_multisampled_texture_vars_.push_back({var, info});
+  } else if (unwrapped_type->Is<type::SampledTexture>()) {
+    referenced_sampled_texture_vars_.push_back({var, info});
   }
-  return ret;
 }
 
 void Function::add_ancestor_entry_point(Symbol ep) {
@@ -293,73 +202,6 @@ std::string Function::type_name() const {
   return out.str();
 }
 
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::ReferencedSamplerVariablesImpl(type::SamplerKind kind) const {
-  std::vector<std::pair<Variable*, Function::BindingInfo>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    auto* unwrapped_type = var->type()->UnwrapIfNeeded();
-    auto* sampler = unwrapped_type->As<type::Sampler>();
-    if (sampler == nullptr || sampler->kind() != kind) {
-      continue;
-    }
-
-    BindingDecoration* binding = nullptr;
-    GroupDecoration* group = nullptr;
-    for (auto* deco : var->decorations()) {
-      if (auto* b = deco->As<BindingDecoration>()) {
-        binding = b;
-      }
-      if (auto* s = deco->As<GroupDecoration>()) {
-        group = s;
-      }
-    }
-    if (binding == nullptr || group == nullptr) {
-      continue;
-    }
-
-    ret.push_back({var, BindingInfo{binding, group}});
-  }
-  return ret;
-}
-
-const std::vector<std::pair<Variable*, Function::BindingInfo>>
-Function::ReferencedSampledTextureVariablesImpl(bool multisampled) const {
-  std::vector<std::pair<Variable*, Function::BindingInfo>> ret;
-
-  for (auto* var : referenced_module_variables()) {
-    auto* unwrapped_type = var->type()->UnwrapIfNeeded();
-    auto* texture = unwrapped_type->As<type::Texture>();
-    if (texture == nullptr) {
-      continue;
-    }
-
-    auto is_multisampled = texture->Is<type::MultisampledTexture>();
-    auto is_sampled = texture->Is<type::SampledTexture>();
-
-    if ((multisampled && !is_multisampled) || (!multisampled && !is_sampled)) {
-      continue;
-    }
-
-    BindingDecoration* binding = nullptr;
-    GroupDecoration* group = nullptr;
-    for (auto* deco : var->decorations()) {
-      if (auto* b = deco->As<BindingDecoration>()) {
-        binding = b;
-      } else if (auto* s = deco->As<GroupDecoration>()) {
-        group = s;
-      }
-    }
-    if (binding == nullptr || group == nullptr) {
-      continue;
-    }
-
-    ret.push_back({var, BindingInfo{binding, group}});
-  }
-
-  return ret;
-}
-
 Function* FunctionList::Find(Symbol sym) const {
   for (auto* func : *this) {
     if (func->symbol() == sym) {
@@ -19,6 +19,7 @@
 #include <ostream>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -79,10 +80,12 @@ class Function : public Castable<Function, Node> {
 
   /// @returns the workgroup size {x, y, z} for the function. {1, 1, 1} will be
   /// return if no workgroup size was set.
-  std::tuple<uint32_t, uint32_t, uint32_t> workgroup_size() const;
+  std::tuple<uint32_t, uint32_t, uint32_t> workgroup_size() const {
+    return workgroup_size_;
+  }
 
   /// @returns the functions pipeline stage or None if not set
-  PipelineStage pipeline_stage() const;
+  PipelineStage pipeline_stage() const { return pipeline_stage_; }
 
   /// @returns true if this function is an entry point
   bool IsEntryPoint() const { return pipeline_stage() != PipelineStage::kNone; }
@@ -107,47 +110,65 @@ class Function : public Castable<Function, Node> {
   }
   /// Retrieves any referenced location variables
   /// @returns the <variable, decoration> pair.
-  const std::vector<std::pair<Variable*, LocationDecoration*>>
-  referenced_location_variables() const;
+  const std::vector<std::pair<Variable*, LocationDecoration*>>&
+  referenced_location_variables() const {
+    return referenced_location_vars_;
+  }
   /// Retrieves any referenced builtin variables
   /// @returns the <variable, decoration> pair.
-  const std::vector<std::pair<Variable*, BuiltinDecoration*>>
-  referenced_builtin_variables() const;
+  const std::vector<std::pair<Variable*, BuiltinDecoration*>>&
+  referenced_builtin_variables() const {
+    return referenced_builtin_vars_;
+  }
   /// Retrieves any referenced uniform variables. Note, the variables must be
   /// decorated with both binding and group decorations.
   /// @returns the referenced uniforms
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_uniform_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_uniform_variables() const {
+    return referenced_uniform_vars_;
+  }
   /// Retrieves any referenced storagebuffer variables. Note, the variables
   /// must be decorated with both binding and group decorations.
   /// @returns the referenced storagebuffers
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_storagebuffer_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_storagebuffer_variables() const {
+    return referenced_storagebuffer_vars_;
+  }
   /// Retrieves any referenced regular Sampler variables. Note, the
   /// variables must be decorated with both binding and group decorations.
   /// @returns the referenced storagebuffers
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_sampler_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_sampler_variables() const {
+    return referenced_sampler_vars_;
+  }
   /// Retrieves any referenced comparison Sampler variables. Note, the
   /// variables must be decorated with both binding and group decorations.
   /// @returns the referenced storagebuffers
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_comparison_sampler_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_comparison_sampler_variables() const {
+    return referenced_comparison_sampler_vars_;
+  }
   /// Retrieves any referenced sampled textures variables. Note, the
   /// variables must be decorated with both binding and group decorations.
   /// @returns the referenced sampled textures
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_sampled_texture_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_sampled_texture_variables() const {
+    return referenced_sampled_texture_vars_;
+  }
   /// Retrieves any referenced multisampled textures variables. Note, the
   /// variables must be decorated with both binding and group decorations.
   /// @returns the referenced sampled textures
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  referenced_multisampled_texture_variables() const;
+  const std::vector<std::pair<Variable*, Function::BindingInfo>>&
+  referenced_multisampled_texture_variables() const {
+    return referenced_multisampled_texture_vars_;
+  }
 
   /// Retrieves any locally referenced builtin variables
   /// @returns the <variable, decoration> pairs.
-  const std::vector<std::pair<Variable*, BuiltinDecoration*>>
-  local_referenced_builtin_variables() const;
+  const std::vector<std::pair<Variable*, BuiltinDecoration*>>&
+  local_referenced_builtin_variables() const {
+    return local_referenced_builtin_vars_;
+  }
 
   /// Adds an ancestor entry point
   /// @param ep the entry point ancestor
@@ -193,10 +214,14 @@ class Function : public Castable<Function, Node> {
 
  private:
   Function(const Function&) = delete;
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  ReferencedSamplerVariablesImpl(type::SamplerKind kind) const;
-  const std::vector<std::pair<Variable*, Function::BindingInfo>>
-  ReferencedSampledTextureVariablesImpl(bool multisampled) const;
+
+  /// A list of referenced variables and their binding decorations
+  using BindingList = std::vector<std::pair<Variable*, BindingInfo>>;
+
+  /// Adds `var` to the referenced variable lists it belongs to, by its
+  /// decorations, storage class and type.
+  /// @param var the newly referenced module variable
+  void partition_referenced_module_variable(Variable* var);
 
   Symbol const symbol_;
   VariableList const params_;
@@ -207,6 +232,26 @@ class Function : public Castable<Function, Node> {
   std::vector<Variable*> local_referenced_module_vars_;  // Semantic info
   std::vector<Symbol> ancestor_entry_points_;            // Semantic info
   FunctionDecorationList decorations_;                   // Semantic info
+  PipelineStage pipeline_stage_ = PipelineStage::kNone;
+  std::tuple<uint32_t, uint32_t, uint32_t> workgroup_size_{1, 1, 1};
+  // The symbols of referenced_module_vars_ and local_referenced_module_vars_,
+  // used to deduplicate the lists.
+  std::unordered_set<Symbol> referenced_module_var_symbols_;
+  std::unordered_set<Symbol> local_referenced_module_var_symbols_;
+  // referenced_module_vars_ and local_referenced_module_vars_ partitioned by
+  // the kind of variable, maintained as variables are added.
+  std::vector<std::pair<Variable*, LocationDecoration*>>
+      referenced_location_vars_;
+  std::vector<std::pair<Variable*, BuiltinDecoration*>>
+      referenced_builtin_vars_;
+  BindingList referenced_uniform_vars_;
+  BindingList referenced_storagebuffer_vars_;
+  BindingList referenced_sampler_vars_;
+  BindingList referenced_comparison_sampler_vars_;
+  BindingList referenced_sampled_texture_vars_;
+  BindingList referenced_multisampled_texture_vars_;
+  std::vector<std::pair<Variable*, BuiltinDecoration*>>
+      local_referenced_builtin_vars_;
 };
 
 /// A list of functions
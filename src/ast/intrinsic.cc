@@ -14,279 +14,207 @@
 
 #include "src/ast/intrinsic.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace tint {
 namespace ast {
 
+namespace {
+
+/// Classification bits for an intrinsic
+enum Flags : uint8_t {
+  kDerivative = 1 << 0,
+  kCoarseDerivative = 1 << 1,
+  kFineDerivative = 1 << 2,
+  kFloatClassification = 1 << 3,
+  kTexture = 1 << 4,
+  kImageQuery = 1 << 5,
+};
+
+/// IntrinsicInfo holds the WGSL name and classification of an intrinsic
+struct IntrinsicInfo {
+  Intrinsic intrinsic;
+  const char* name;
+  uint8_t flags;
+};
+
+/// The table of all intrinsics, indexed by Intrinsic enumerator value.
+/// As the enumerators are declared in alphabetical order of their WGSL names,
+/// the table is also sorted by name.
+constexpr IntrinsicInfo kIntrinsics[] = {
+    {Intrinsic::kAbs, "abs", 0},
+    {Intrinsic::kAcos, "acos", 0},
+    {Intrinsic::kAll, "all", 0},
+    {Intrinsic::kAny, "any", 0},
+    {Intrinsic::kArrayLength, "arrayLength", 0},
+    {Intrinsic::kAsin, "asin", 0},
+    {Intrinsic::kAtan, "atan", 0},
+    {Intrinsic::kAtan2, "atan2", 0},
+    {Intrinsic::kCeil, "ceil", 0},
+    {Intrinsic::kClamp, "clamp", 0},
+    {Intrinsic::kCos, "cos", 0},
+    {Intrinsic::kCosh, "cosh", 0},
+    {Intrinsic::kCountOneBits, "countOneBits", 0},
+    {Intrinsic::kCross, "cross", 0},
+    {Intrinsic::kDeterminant, "determinant", 0},
+    {Intrinsic::kDistance, "distance", 0},
+    {Intrinsic::kDot, "dot", 0},
+    {Intrinsic::kDpdx, "dpdx", kDerivative},
+    {Intrinsic::kDpdxCoarse, "dpdxCoarse", kDerivative | kCoarseDerivative},
+    {Intrinsic::kDpdxFine, "dpdxFine", kDerivative | kFineDerivative},
+    {Intrinsic::kDpdy, "dpdy", kDerivative},
+    {Intrinsic::kDpdyCoarse, "dpdyCoarse", kDerivative | kCoarseDerivative},
+    {Intrinsic::kDpdyFine, "dpdyFine", kDerivative | kFineDerivative},
+    {Intrinsic::kExp, "exp", 0},
+    {Intrinsic::kExp2, "exp2", 0},
+    {Intrinsic::kFaceForward, "faceForward", 0},
+    {Intrinsic::kFloor, "floor", 0},
+    {Intrinsic::kFma, "fma", 0},
+    {Intrinsic::kFract, "fract", 0},
+    {Intrinsic::kFrexp, "frexp", 0},
+    {Intrinsic::kFwidth, "fwidth", kDerivative},
+    {Intrinsic::kFwidthCoarse, "fwidthCoarse", kDerivative | kCoarseDerivative},
+    {Intrinsic::kFwidthFine, "fwidthFine", kDerivative | kFineDerivative},
+    {Intrinsic::kInverseSqrt, "inverseSqrt", 0},
+    {Intrinsic::kIsFinite, "isFinite", kFloatClassification},
+    {Intrinsic::kIsInf, "isInf", kFloatClassification},
+    {Intrinsic::kIsNan, "isNan", kFloatClassification},
+    {Intrinsic::kIsNormal, "isNormal", kFloatClassification},
+    {Intrinsic::kLdexp, "ldexp", 0},
+    {Intrinsic::kLength, "length", 0},
+    {Intrinsic::kLog, "log", 0},
+    {Intrinsic::kLog2, "log2", 0},
+    {Intrinsic::kMax, "max", 0},
+    {Intrinsic::kMin, "min", 0},
+    {Intrinsic::kMix, "mix", 0},
+    {Intrinsic::kModf, "modf", 0},
+    {Intrinsic::kNormalize, "normalize", 0},
+    {Intrinsic::kPow, "pow", 0},
+    {Intrinsic::kReflect, "reflect", 0},
+    {Intrinsic::kReverseBits, "reverseBits", 0},
+    {Intrinsic::kRound, "round", 0},
+    {Intrinsic::kSelect, "select", 0},
+    {Intrinsic::kSign, "sign", 0},
+    {Intrinsic::kSin, "sin", 0},
+    {Intrinsic::kSinh, "sinh", 0},
+    {Intrinsic::kSmoothStep, "smoothStep", 0},
+    {Intrinsic::kSqrt, "sqrt", 0},
+    {Intrinsic::kStep, "step", 0},
+    {Intrinsic::kTan, "tan", 0},
+    {Intrinsic::kTanh, "tanh", 0},
+    {Intrinsic::kTextureDimensions, "textureDimensions",
+     kTexture | kImageQuery},
+    {Intrinsic::kTextureLoad, "textureLoad", kTexture},
+    {Intrinsic::kTextureNumLayers, "textureNumLayers", kTexture | kImageQuery},
+    {Intrinsic::kTextureNumLevels, "textureNumLevels", kTexture | kImageQuery},
+    {Intrinsic::kTextureNumSamples, "textureNumSamples",
+     kTexture | kImageQuery},
+    {Intrinsic::kTextureSample, "textureSample", kTexture},
+    {Intrinsic::kTextureSampleBias, "textureSampleBias", kTexture},
+    {Intrinsic::kTextureSampleCompare, "textureSampleCompare", kTexture},
+    {Intrinsic::kTextureSampleGrad, "textureSampleGrad", kTexture},
+    {Intrinsic::kTextureSampleLevel, "textureSampleLevel", kTexture},
+    {Intrinsic::kTextureStore, "textureStore", kTexture},
+    {Intrinsic::kTrunc, "trunc", 0},
+};
+
+constexpr size_t kNumIntrinsics = sizeof(kIntrinsics) / sizeof(kIntrinsics[0]);
+
+constexpr bool IsLess(const char* a, const char* b) {
+  for (; *a != 0 && *a == *b; a++, b++) {
+  }
+  return static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+}
+
+constexpr bool IsValidTable() {
+  for (size_t i = 0; i < kNumIntrinsics; i++) {
+    if (static_cast<size_t>(kIntrinsics[i].intrinsic) != i) {
+      return false;
+    }
+    if (i > 0 && !IsLess(kIntrinsics[i - 1].name, kIntrinsics[i].name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(kNumIntrinsics == static_cast<size_t>(Intrinsic::kTrunc) + 1,
+              "kIntrinsics must have an entry for every intrinsic");
+static_assert(IsValidTable(),
+              "kIntrinsics must be in enumerator order and sorted by name");
+
+/// @returns the table entry for `i`, or nullptr if `i` is not an intrinsic
+const IntrinsicInfo* Info(Intrinsic i) {
+  auto idx = static_cast<int>(i);
+  if (idx < 0 || static_cast<size_t>(idx) >= kNumIntrinsics) {
+    return nullptr;
+  }
+  return &kIntrinsics[idx];
+}
+
+bool HasFlags(Intrinsic i, uint8_t flags) {
+  auto* info = Info(i);
+  return info != nullptr && (info->flags & flags) != 0;
+}
+
+}  // namespace
+
 std::ostream& operator<<(std::ostream& out, Intrinsic i) {
   /// The emitted name matches the spelling in the WGSL spec.
   /// including case.
-  switch (i) {
-    case Intrinsic::kNone:
-      return out;
-    case Intrinsic::kAbs:
-      out << "abs";
-      return out;
-    case Intrinsic::kAcos:
-      out << "acos";
-      return out;
-    case Intrinsic::kAll:
-      out << "all";
-      return out;
-    case Intrinsic::kAny:
-      out << "any";
-      return out;
-    case Intrinsic::kArrayLength:
-      out << "arrayLength";
-      return out;
-    case Intrinsic::kAsin:
-      out << "asin";
-      return out;
-    case Intrinsic::kAtan:
-      out << "atan";
-      return out;
-    case Intrinsic::kAtan2:
-      out << "atan2";
-      return out;
-    case Intrinsic::kCeil:
-      out << "ceil";
-      return out;
-    case Intrinsic::kClamp:
-      out << "clamp";
-      return out;
-    case Intrinsic::kCos:
-      out << "cos";
-      return out;
-    case Intrinsic::kCosh:
-      out << "cosh";
-      return out;
-    case Intrinsic::kCountOneBits:
-      out << "countOneBits";
-      return out;
-    case Intrinsic::kCross:
-      out << "cross";
-      return out;
-    case Intrinsic::kDeterminant:
-      out << "determinant";
-      return out;
-    case Intrinsic::kDistance:
-      out << "distance";
-      return out;
-    case Intrinsic::kDot:
-      out << "dot";
-      return out;
-    case Intrinsic::kDpdx:
-      out << "dpdx";
-      return out;
-    case Intrinsic::kDpdxCoarse:
-      out << "dpdxCoarse";
-      return out;
-    case Intrinsic::kDpdxFine:
-      out << "dpdxFine";
-      return out;
-    case Intrinsic::kDpdy:
-      out << "dpdy";
-      return out;
-    case Intrinsic::kDpdyCoarse:
-      out << "dpdyCoarse";
-      return out;
-    case Intrinsic::kDpdyFine:
-      out << "dpdyFine";
-      return out;
-    case Intrinsic::kExp:
-      out << "exp";
-      return out;
-    case Intrinsic::kExp2:
-      out << "exp2";
-      return out;
-    case Intrinsic::kFaceForward:
-      out << "faceForward";
-      return out;
-    case Intrinsic::kFloor:
-      out << "floor";
-      return out;
-    case Intrinsic::kFma:
-      out << "fma";
-      return out;
-    case Intrinsic::kFract:
-      out << "fract";
-      return out;
-    case Intrinsic::kFrexp:
-      out << "frexp";
-      return out;
-    case Intrinsic::kFwidth:
-      out << "fwidth";
-      return out;
-    case Intrinsic::kFwidthCoarse:
-      out << "fwidthCoarse";
-      return out;
-    case Intrinsic::kFwidthFine:
-      out << "fwidthFine";
-      return out;
-    case Intrinsic::kInverseSqrt:
-      out << "inverseSqrt";
-      return out;
-    case Intrinsic::kIsFinite:
-      out << "isFinite";
-      return out;
-    case Intrinsic::kIsInf:
-      out << "isInf";
-      return out;
-    case Intrinsic::kIsNan:
-      out << "isNan";
-      return out;
-    case Intrinsic::kIsNormal:
-      out << "isNormal";
-      return out;
-    case Intrinsic::kLdexp:
-      out << "ldexp";
-      return out;
-    case Intrinsic::kLength:
-      out << "length";
-      return out;
-    case Intrinsic::kLog:
-      out << "log";
-      return out;
-    case Intrinsic::kLog2:
-      out << "log2";
-      return out;
-    case Intrinsic::kMax:
-      out << "max";
-      return out;
-    case Intrinsic::kMin:
-      out << "min";
-      return out;
-    case Intrinsic::kMix:
-      out << "mix";
-      return out;
-    case Intrinsic::kModf:
-      out << "modf";
-      return out;
-    case Intrinsic::kNormalize:
-      out << "normalize";
-      return out;
-    case Intrinsic::kPow:
-      out << "pow";
-      return out;
-    case Intrinsic::kReflect:
-      out << "reflect";
-      return out;
-    case Intrinsic::kReverseBits:
-      out << "reverseBits";
-      return out;
-    case Intrinsic::kRound:
-      out << "round";
-      return out;
-    case Intrinsic::kSelect:
-      out << "select";
-      return out;
-    case Intrinsic::kSign:
-      out << "sign";
-      return out;
-    case Intrinsic::kSin:
-      out << "sin";
-      return out;
-    case Intrinsic::kSinh:
-      out << "sinh";
-      return out;
-    case Intrinsic::kSmoothStep:
-      out << "smoothStep";
-      return out;
-    case Intrinsic::kSqrt:
-      out << "sqrt";
-      return out;
-    case Intrinsic::kStep:
-      out << "step";
-      return out;
-    case Intrinsic::kTan:
-      out << "tan";
-      return out;
-    case Intrinsic::kTanh:
-      out << "tanh";
-      return out;
-    case Intrinsic::kTextureDimensions:
-      out << "textureDimensions";
-      return out;
-    case Intrinsic::kTextureLoad:
-      out << "textureLoad";
-      return out;
-    case Intrinsic::kTextureNumLayers:
-      out << "textureNumLayers";
-      return out;
-    case Intrinsic::kTextureNumLevels:
-      out << "textureNumLevels";
-      return out;
-    case Intrinsic::kTextureNumSamples:
-      out << "textureNumSamples";
-      return out;
-    case Intrinsic::kTextureSample:
-      out << "textureSample";
-      return out;
-    case Intrinsic::kTextureSampleBias:
-      out << "textureSampleBias";
-      return out;
-    case Intrinsic::kTextureSampleCompare:
-      out << "textureSampleCompare";
-      return out;
-    case Intrinsic::kTextureSampleGrad:
-      out << "textureSampleGrad";
-      return out;
-    case Intrinsic::kTextureSampleLevel:
-      out << "textureSampleLevel";
-      return out;
-    case Intrinsic::kTextureStore:
-      out << "textureStore";
-      return out;
-    case Intrinsic::kTrunc:
-      out << "trunc";
-      return out;
+  if (i == Intrinsic::kNone) {
+    return out;
   }
-  out << "Unknown";
+  auto* info = Info(i);
+  out << (info != nullptr ? info->name : "Unknown");
   return out;
 }
 
+Intrinsic ParseIntrinsic(const std::string& name) {
+  auto* begin = std::begin(kIntrinsics);
+  auto* end = std::end(kIntrinsics);
+  auto* it = std::lower_bound(
+      begin, end, name, [](const IntrinsicInfo& info, const std::string& n) {
+        return n.compare(info.name) > 0;
+      });
+  if (it != end && name.compare(it->name) == 0) {
+    return it->intrinsic;
+  }
+  return Intrinsic::kNone;
+}
+
 namespace intrinsic {
 
 Signature::~Signature() = default;
 TextureSignature::~TextureSignature() = default;
+OverloadSignature::~OverloadSignature() = default;
 
 TextureSignature::Parameters::Index::Index() = default;
 TextureSignature::Parameters::Index::Index(const Index&) = default;
 
 bool IsCoarseDerivative(Intrinsic i) {
-  return i == Intrinsic::kDpdxCoarse || i == Intrinsic::kDpdyCoarse ||
-         i == Intrinsic::kFwidthCoarse;
+  return HasFlags(i, kCoarseDerivative);
 }
 
 bool IsFineDerivative(Intrinsic i) {
-  return i == Intrinsic::kDpdxFine || i == Intrinsic::kDpdyFine ||
-         i == Intrinsic::kFwidthFine;
+  return HasFlags(i, kFineDerivative);
 }
 
 bool IsDerivative(Intrinsic i) {
-  return i == Intrinsic::kDpdx || i == Intrinsic::kDpdy ||
-         i == Intrinsic::kFwidth || IsCoarseDerivative(i) ||
-         IsFineDerivative(i);
+  return HasFlags(i, kDerivative);
 }
 
 bool IsFloatClassificationIntrinsic(Intrinsic i) {
-  return i == Intrinsic::kIsFinite || i == Intrinsic::kIsInf ||
-         i == Intrinsic::kIsNan || i == Intrinsic::kIsNormal;
+  return HasFlags(i, kFloatClassification);
 }
 
 bool IsTextureIntrinsic(Intrinsic i) {
-  return IsImageQueryIntrinsic(i) || i == Intrinsic::kTextureLoad ||
-         i == Intrinsic::kTextureSample ||
-         i == Intrinsic::kTextureSampleLevel ||
-         i == Intrinsic::kTextureSampleBias ||
-         i == Intrinsic::kTextureSampleCompare ||
-         i == Intrinsic::kTextureSampleGrad || i == Intrinsic::kTextureStore;
+  return HasFlags(i, kTexture);
 }
 
 bool IsImageQueryIntrinsic(Intrinsic i) {
-  return i == ast::Intrinsic::kTextureDimensions ||
-         i == Intrinsic::kTextureNumLayers ||
-         i == Intrinsic::kTextureNumLevels ||
-         i == Intrinsic::kTextureNumSamples;
+  return HasFlags(i, kImageQuery);
 }
 
 }  // namespace intrinsic
@@ -15,7 +15,9 @@
 #ifndef SRC_AST_INTRINSIC_H_
 #define SRC_AST_INTRINSIC_H_
 
+#include <cstdint>
 #include <ostream>
+#include <string>
 
 namespace tint {
 namespace ast {
@@ -101,6 +103,13 @@ enum class Intrinsic {
 /// including case, matches the name in the WGSL spec.
 std::ostream& operator<<(std::ostream& out, Intrinsic i);
 
+/// Looks up an intrinsic by its WGSL name.
+/// @param name the name of the intrinsic, with the same spelling and case as
+/// the WGSL spec
+/// @returns the intrinsic with the name `name`, or Intrinsic::kNone if `name`
+/// is not the name of an intrinsic
+Intrinsic ParseIntrinsic(const std::string& name);
+
 namespace intrinsic {
 
 /// Signature is the base struct for all intrinsic signature types.
@@ -165,6 +174,37 @@ struct TextureSignature : public Signature {
   const Parameters params;
 };
 
+/// OverloadSignature describes the overload of a non-texture intrinsic
+/// function that was selected by the TypeDeterminer.
+struct OverloadSignature : public Signature {
+  /// ScalarKind is the scalar type of the overload's first parameter.
+  enum class ScalarKind {
+    /// The first parameter is not a scalar, vector or matrix
+    kOther,
+    /// The first parameter is a bool scalar or vector
+    kBool,
+    /// The first parameter is a f32 scalar, vector or matrix
+    kFloat,
+    /// The first parameter is an i32 scalar or vector
+    kSignedInteger,
+    /// The first parameter is a u32 scalar or vector
+    kUnsignedInteger,
+  };
+
+  /// Construct an immutable `OverloadSignature`.
+  /// @param k the scalar kind of the overload
+  /// @param w the number of elements of the overload's first parameter. 1 for
+  /// scalars, the number of columns for matrices.
+  OverloadSignature(ScalarKind k, uint32_t w) : kind(k), width(w) {}
+
+  ~OverloadSignature() override;
+
+  /// The scalar kind of the overload
+  const ScalarKind kind;
+  /// The number of elements of the overload's first parameter
+  const uint32_t width;
+};
+
 /// Determines if the given `i` is a coarse derivative
 /// @param i the intrinsic
 /// @returns true if the given derivative is coarse.
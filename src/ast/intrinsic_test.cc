@@ -0,0 +1,87 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ast/intrinsic.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace tint {
+namespace ast {
+namespace {
+
+using IntrinsicTest = testing::Test;
+
+std::string ToString(Intrinsic i) {
+  std::stringstream out;
+  out << i;
+  return out.str();
+}
+
+TEST_F(IntrinsicTest, ParseRoundTrips) {
+  for (int i = static_cast<int>(Intrinsic::kAbs);
+       i <= static_cast<int>(Intrinsic::kTrunc); i++) {
+    auto intrinsic = static_cast<Intrinsic>(i);
+    auto name = ToString(intrinsic);
+    ASSERT_FALSE(name.empty());
+    EXPECT_EQ(ParseIntrinsic(name), intrinsic) << name;
+  }
+}
+
+TEST_F(IntrinsicTest, Parse) {
+  EXPECT_EQ(ParseIntrinsic("abs"), Intrinsic::kAbs);
+  EXPECT_EQ(ParseIntrinsic("dpdxCoarse"), Intrinsic::kDpdxCoarse);
+  EXPECT_EQ(ParseIntrinsic("textureSampleLevel"),
+            Intrinsic::kTextureSampleLevel);
+  EXPECT_EQ(ParseIntrinsic("trunc"), Intrinsic::kTrunc);
+}
+
+TEST_F(IntrinsicTest, ParseNotIntrinsic) {
+  EXPECT_EQ(ParseIntrinsic(""), Intrinsic::kNone);
+  EXPECT_EQ(ParseIntrinsic("a"), Intrinsic::kNone);
+  EXPECT_EQ(ParseIntrinsic("Abs"), Intrinsic::kNone);
+  EXPECT_EQ(ParseIntrinsic("absx"), Intrinsic::kNone);
+  EXPECT_EQ(ParseIntrinsic("texture"), Intrinsic::kNone);
+  EXPECT_EQ(ParseIntrinsic("zzz"), Intrinsic::kNone);
+}
+
+TEST_F(IntrinsicTest, Print) {
+  EXPECT_EQ(ToString(Intrinsic::kNone), "");
+  EXPECT_EQ(ToString(Intrinsic::kCountOneBits), "countOneBits");
+}
+
+TEST_F(IntrinsicTest, Classification) {
+  EXPECT_TRUE(intrinsic::IsDerivative(Intrinsic::kDpdx));
+  EXPECT_TRUE(intrinsic::IsDerivative(Intrinsic::kFwidthFine));
+  EXPECT_FALSE(intrinsic::IsDerivative(Intrinsic::kAbs));
+  EXPECT_TRUE(intrinsic::IsCoarseDerivative(Intrinsic::kDpdyCoarse));
+  EXPECT_FALSE(intrinsic::IsCoarseDerivative(Intrinsic::kDpdy));
+  EXPECT_TRUE(intrinsic::IsFineDerivative(Intrinsic::kDpdxFine));
+  EXPECT_FALSE(intrinsic::IsFineDerivative(Intrinsic::kDpdxCoarse));
+  EXPECT_TRUE(intrinsic::IsFloatClassificationIntrinsic(Intrinsic::kIsNan));
+  EXPECT_FALSE(intrinsic::IsFloatClassificationIntrinsic(Intrinsic::kSign));
+  EXPECT_TRUE(intrinsic::IsTextureIntrinsic(Intrinsic::kTextureStore));
+  EXPECT_TRUE(intrinsic::IsTextureIntrinsic(Intrinsic::kTextureNumLevels));
+  EXPECT_FALSE(intrinsic::IsTextureIntrinsic(Intrinsic::kArrayLength));
+  EXPECT_TRUE(intrinsic::IsImageQueryIntrinsic(Intrinsic::kTextureDimensions));
+  EXPECT_FALSE(intrinsic::IsImageQueryIntrinsic(Intrinsic::kTextureLoad));
+  EXPECT_FALSE(intrinsic::IsTextureIntrinsic(Intrinsic::kNone));
+  EXPECT_FALSE(intrinsic::IsDerivative(Intrinsic::kNone));
+}
+
+}  // namespace
+}  // namespace ast
+}  // namespace tint
@@ -16,7 +16,11 @@
 
 #include <assert.h>
 
+#include "src/ast/binding_decoration.h"
+#include "src/ast/builtin_decoration.h"
 #include "src/ast/constant_id_decoration.h"
+#include "src/ast/group_decoration.h"
+#include "src/ast/location_decoration.h"
 #include "src/clone_context.h"
 #include "src/program_builder.h"
 
@@ -38,56 +42,35 @@ Variable::Variable(const Source& source,
       is_const_(is_const),
       constructor_(constructor),
       decorations_(std::move(decorations)),
-      storage_class_(sc) {}
-
-Variable::Variable(Variable&&) = default;
-
-Variable::~Variable() = default;
-
-bool Variable::HasLocationDecoration() const {
-  for (auto* deco : decorations_) {
-    if (deco->Is<LocationDecoration>()) {
-      return true;
-    }
-  }
-  return false;
-}
-
-bool Variable::HasBuiltinDecoration() const {
+      storage_class_(sc) {
   for (auto* deco : decorations_) {
-    if (deco->Is<BuiltinDecoration>()) {
-      return true;
+    if (auto* location = deco->As<LocationDecoration>()) {
+      if (!location_) {
+        location_ = location;
+      }
+    } else if (auto* builtin = deco->As<BuiltinDecoration>()) {
+      if (!builtin_) {
+        builtin_ = builtin;
+      }
+    } else if (auto* constant_id = deco->As<ConstantIdDecoration>()) {
+      if (!constant_id_) {
+        constant_id_ = constant_id;
+      }
+    } else if (auto* binding = deco->As<BindingDecoration>()) {
+      binding_ = binding;
+    } else if (auto* group = deco->As<GroupDecoration>()) {
+      group_ = group;
     }
   }
-  return false;
 }
 
-bool Variable::HasConstantIdDecoration() const {
-  for (auto* deco : decorations_) {
-    if (deco->Is<ConstantIdDecoration>()) {
-      return true;
-    }
-  }
-  return false;
-}
+Variable::Variable(Variable&&) = default;
 
-LocationDecoration* Variable::GetLocationDecoration() const {
-  for (auto* deco : decorations_) {
-    if (deco->Is<LocationDecoration>()) {
-      return deco->As<LocationDecoration>();
-    }
-  }
-  return nullptr;
-}
+Variable::~Variable() = default;
 
 uint32_t Variable::constant_id() const {
   assert(HasConstantIdDecoration());
-  for (auto* deco : decorations_) {
-    if (auto* cid = deco->As<ConstantIdDecoration>()) {
-      return cid->value();
-    }
-  }
-  return 0;
+  return constant_id_->value();
 }
 
 Variable* Variable::Clone(CloneContext* ctx) const {
@@ -30,6 +30,10 @@
 namespace tint {
 namespace ast {
 
+class BindingDecoration;
+class BuiltinDecoration;
+class ConstantIdDecoration;
+class GroupDecoration;
 class LocationDecoration;
 
 /// A Variable statement.
@@ -125,14 +129,22 @@ class Variable : public Castable<Variable, Node> {
   const VariableDecorationList& decorations() const { return decorations_; }
 
   /// @returns true if the decorations include a LocationDecoration
-  bool HasLocationDecoration() const;
+  bool HasLocationDecoration() const { return location_ != nullptr; }
   /// @returns true if the deocrations include a BuiltinDecoration
-  bool HasBuiltinDecoration() const;
+  bool HasBuiltinDecoration() const { return builtin_ != nullptr; }
   /// @returns true if the decorations include a ConstantIdDecoration
-  bool HasConstantIdDecoration() const;
+  bool HasConstantIdDecoration() const { return constant_id_ != nullptr; }
 
   /// @returns pointer to LocationDecoration in decorations, otherwise NULL.
-  LocationDecoration* GetLocationDecoration() const;
+  LocationDecoration* GetLocationDecoration() const { return location_; }
+  /// @returns pointer to BuiltinDecoration in decorations, otherwise NULL.
+  BuiltinDecoration* GetBuiltinDecoration() const { return builtin_; }
+  /// @returns pointer to the last BindingDecoration in decorations, otherwise
+  /// NULL.
+  BindingDecoration* GetBindingDecoration() const { return binding_; }
+  /// @returns pointer to the last GroupDecoration in decorations, otherwise
+  /// NULL.
+  GroupDecoration* GetGroupDecoration() const { return group_; }
 
   /// @returns the constant_id value for the variable. Assumes that
   /// HasConstantIdDecoration() has been called first.
@@ -174,6 +186,13 @@ class Variable : public Castable<Variable, Node> {
   Expression* const constructor_;
   VariableDecorationList const decorations_;
 
+  // Summary of decorations_, gathered on construction
+  LocationDecoration* location_ = nullptr;
+  BuiltinDecoration* builtin_ = nullptr;
+  BindingDecoration* binding_ = nullptr;
+  GroupDecoration* group_ = nullptr;
+  ConstantIdDecoration* constant_id_ = nullptr;
+
   StorageClass storage_class_ = StorageClass::kNone;  // Semantic info
 };
 
@@ -129,6 +129,31 @@ TEST_F(VariableTest, WithDecorations) {
   EXPECT_EQ(1u, location->value());
 }
 
+TEST_F(VariableTest, WithoutDecorations) {
+  auto* var = Var("my_var", StorageClass::kFunction, ty.i32());
+
+  EXPECT_FALSE(var->HasLocationDecoration());
+  EXPECT_FALSE(var->HasBuiltinDecoration());
+  EXPECT_FALSE(var->HasConstantIdDecoration());
+  EXPECT_EQ(var->GetLocationDecoration(), nullptr);
+  EXPECT_EQ(var->GetBuiltinDecoration(), nullptr);
+  EXPECT_EQ(var->GetBindingDecoration(), nullptr);
+  EXPECT_EQ(var->GetGroupDecoration(), nullptr);
+}
+
+TEST_F(VariableTest, BindingDecorations) {
+  auto* binding = create<BindingDecoration>(2);
+  auto* group = create<GroupDecoration>(1);
+  auto* builtin = create<BuiltinDecoration>(Builtin::kPosition);
+  auto* var = Var("my_var", StorageClass::kUniform, ty.i32(), nullptr,
+                  VariableDecorationList{group, builtin, binding});
+
+  EXPECT_EQ(var->GetBindingDecoration(), binding);
+  EXPECT_EQ(var->GetGroupDecoration(), group);
+  EXPECT_EQ(var->GetBuiltinDecoration(), builtin);
+  EXPECT_EQ(var->GetLocationDecoration(), nullptr);
+}
+
 TEST_F(VariableTest, ConstantId) {
   auto* var = Var("my_var", StorageClass::kFunction, ty.i32(), nullptr,
                   VariableDecorationList{
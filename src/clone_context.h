@@ -86,9 +86,13 @@ class CloneContext {
   /// TODO(bclayton) - Currently this 'clone' is a shallow copy. If/when
   /// `Source.File`s are owned by the Program this should make a copy of the
   /// file.
+  /// If a function has been registered with ReplaceSources() then the
+  /// returned Source is the result of calling that function with `s`.
   /// @param s the `Source` to clone
   /// @return the cloned source
-  Source Clone(const Source& s) const { return s; }
+  Source Clone(const Source& s) const {
+    return source_transform_ ? source_transform_(s) : s;
+  }
 
   /// Clones the Symbol `s` into `dst`
   ///
@@ -177,6 +181,23 @@ class CloneContext {
     return *this;
   }
 
+  /// ReplaceSources() registers `replacer` to be called whenever a Source is
+  /// cloned. The Source returned by `replacer` is used in place of the
+  /// original. Only a single source replacer can be registered; calling
+  /// ReplaceSources() again replaces the previously registered function.
+  ///
+  /// `replacer` must be function-like with the signature:
+  ///   `Source (const Source&)`
+  ///
+  /// @param replacer a function or function-like object with the signature
+  ///        `Source (const Source&)`
+  /// @returns this CloneContext so calls can be chained
+  template <typename F>
+  CloneContext& ReplaceSources(F replacer) {
+    source_transform_ = replacer;
+    return *this;
+  }
+
   /// Clone performs the clone of the entire Program #src to #dst.
   void Clone();
 
@@ -217,6 +238,7 @@ class CloneContext {
 
   std::unordered_map<CastableBase*, CastableBase*> cloned_;
   std::vector<Transform> transforms_;
+  std::function<Source(const Source&)> source_transform_;
 };
 
 }  // namespace tint
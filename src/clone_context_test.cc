@@ -193,6 +193,30 @@ TEST(CloneContext, CloneWithReplace) {
   EXPECT_NE(cloned_root->c, replacement);
 }
 
+TEST(CloneContext, CloneWithReplaceSources) {
+  ProgramBuilder builder;
+  Program original(std::move(builder));
+
+  Source::File file("test.wgsl", "");
+
+  ProgramBuilder cloned;
+  CloneContext ctx(&cloned, &original);
+  ctx.ReplaceSources([&](const Source& in) {
+    Source out = in;
+    out.file = &file;
+    out.range.begin.line += 10;
+    out.range.end.line += 10;
+    return out;
+  });
+
+  auto out = ctx.Clone(Source{Source::Range{{1, 2}, {3, 4}}});
+  EXPECT_EQ(out.file, &file);
+  EXPECT_EQ(out.range.begin.line, 11u);
+  EXPECT_EQ(out.range.begin.column, 2u);
+  EXPECT_EQ(out.range.end.line, 13u);
+  EXPECT_EQ(out.range.end.column, 4u);
+}
+
 }  // namespace
 
 TINT_INSTANTIATE_CLASS_ID(Cloneable);
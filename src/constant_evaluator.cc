@@ -0,0 +1,938 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/constant_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "src/ast/array_accessor_expression.h"
+#include "src/ast/binary_expression.h"
+#include "src/ast/bitcast_expression.h"
+#include "src/ast/bool_literal.h"
+#include "src/ast/call_expression.h"
+#include "src/ast/float_literal.h"
+#include "src/ast/identifier_expression.h"
+#include "src/ast/intrinsic.h"
+#include "src/ast/member_accessor_expression.h"
+#include "src/ast/module.h"
+#include "src/ast/scalar_constructor_expression.h"
+#include "src/ast/sint_literal.h"
+#include "src/ast/type_constructor_expression.h"
+#include "src/ast/uint_literal.h"
+#include "src/ast/unary_op_expression.h"
+#include "src/ast/variable.h"
+#include "src/type/bool_type.h"
+#include "src/type/f32_type.h"
+#include "src/type/i32_type.h"
+#include "src/type/matrix_type.h"
+#include "src/type/u32_type.h"
+#include "src/type/vector_type.h"
+
+namespace tint {
+namespace {
+
+using Scalar = ast::ConstantValue::Scalar;
+using Scalars = std::vector<Scalar>;
+
+/// Kind is the type of a scalar
+enum class Kind { kBool, kI32, kU32, kF32, kOther };
+
+Kind KindOf(type::Type* ty) {
+  if (ty->Is<type::Bool>()) {
+    return Kind::kBool;
+  }
+  if (ty->Is<type::I32>()) {
+    return Kind::kI32;
+  }
+  if (ty->Is<type::U32>()) {
+    return Kind::kU32;
+  }
+  if (ty->Is<type::F32>()) {
+    return Kind::kF32;
+  }
+  return Kind::kOther;
+}
+
+/// @returns the number of scalar elements of `ty`, or 0 if `ty` is not a
+/// scalar, vector or matrix type
+uint32_t ElementCount(type::Type* ty) {
+  if (auto* vec = ty->As<type::Vector>()) {
+    return vec->size();
+  }
+  if (auto* mat = ty->As<type::Matrix>()) {
+    return mat->rows() * mat->columns();
+  }
+  if (KindOf(ty) != Kind::kOther) {
+    return 1;
+  }
+  return 0;
+}
+
+/// @returns the result type of `expr`, if it can hold a constant value
+type::Type* ValueTypeOf(ast::Expression* expr) {
+  if (expr->result_type() == nullptr) {
+    return nullptr;
+  }
+  auto* ty = expr->result_type()->UnwrapAll();
+  return ElementCount(ty) > 0 ? ty : nullptr;
+}
+
+uint32_t BitsOf(Scalar s) {
+  uint32_t bits;
+  static_assert(sizeof(bits) == sizeof(s.f32), "f32 is not 32 bits wide");
+  std::memcpy(&bits, &s.f32, sizeof(bits));
+  return bits;
+}
+
+Scalar FromBits(Kind kind, uint32_t bits) {
+  switch (kind) {
+    case Kind::kI32:
+      return Scalar(static_cast<int32_t>(bits));
+    case Kind::kF32: {
+      float f;
+      std::memcpy(&f, &bits, sizeof(f));
+      return Scalar(f);
+    }
+    default:
+      return Scalar(bits);
+  }
+}
+
+/// Integer arithmetic wraps, so i32 operations are performed on u32s
+int32_t Wrap(uint32_t v) {
+  return static_cast<int32_t>(v);
+}
+
+/// @returns false if `f` cannot be the result of a constant expression
+bool IsValid(float f) {
+  return std::isfinite(f);
+}
+
+/// Converts the scalar `in` of kind `from` to kind `to`
+/// @returns false if the value cannot be represented by `to`
+bool Convert(Kind from, Kind to, Scalar in, Scalar* out) {
+  if (from == to) {
+    *out = in;
+    return true;
+  }
+  switch (to) {
+    case Kind::kBool:
+      switch (from) {
+        case Kind::kI32:
+          *out = Scalar(in.i32 != 0);
+          return true;
+        case Kind::kU32:
+          *out = Scalar(in.u32 != 0);
+          return true;
+        case Kind::kF32:
+          *out = Scalar(in.f32 != 0.f);
+          return true;
+        default:
+          return false;
+      }
+    case Kind::kI32:
+      switch (from) {
+        case Kind::kBool:
+          *out = Scalar(static_cast<int32_t>(in.b ? 1 : 0));
+          return true;
+        case Kind::kU32:
+          *out = Scalar(Wrap(in.u32));
+          return true;
+        case Kind::kF32:
+          if (!(in.f32 >= -2147483648.f && in.f32 < 2147483648.f)) {
+            return false;
+          }
+          *out = Scalar(static_cast<int32_t>(in.f32));
+          return true;
+        default:
+          return false;
+      }
+    case Kind::kU32:
+      switch (from) {
+        case Kind::kBool:
+          *out = Scalar(static_cast<uint32_t>(in.b ? 1u : 0u));
+          return true;
+        case Kind::kI32:
+          *out = Scalar(static_cast<uint32_t>(in.i32));
+          return true;
+        case Kind::kF32:
+          if (!(in.f32 > -1.f && in.f32 < 4294967296.f)) {
+            return false;
+          }
+          *out = Scalar(static_cast<uint32_t>(in.f32));
+          return true;
+        default:
+          return false;
+      }
+    case Kind::kF32:
+      switch (from) {
+        case Kind::kBool:
+          *out = Scalar(in.b ? 1.f : 0.f);
+          return true;
+        case Kind::kI32:
+          *out = Scalar(static_cast<float>(in.i32));
+          return true;
+        case Kind::kU32:
+          *out = Scalar(static_cast<float>(in.u32));
+          return true;
+        default:
+          return false;
+      }
+    case Kind::kOther:
+      break;
+  }
+  return false;
+}
+
+/// Evaluates `a op b`, where `a` and `b` are scalars of kind `kind`.
+/// Shifts are handled by Shift().
+/// @returns false if the result is not a constant
+bool Binary(ast::BinaryOp op, Kind kind, Scalar a, Scalar b, Scalar* out) {
+  switch (op) {
+    case ast::BinaryOp::kEqual:
+    case ast::BinaryOp::kNotEqual: {
+      bool equal = false;
+      switch (kind) {
+        case Kind::kBool:
+          equal = a.b == b.b;
+          break;
+        case Kind::kI32:
+          equal = a.i32 == b.i32;
+          break;
+        case Kind::kU32:
+          equal = a.u32 == b.u32;
+          break;
+        case Kind::kF32:
+          equal = a.f32 == b.f32;
+          break;
+        case Kind::kOther:
+          return false;
+      }
+      *out = Scalar(op == ast::BinaryOp::kEqual ? equal : !equal);
+      return true;
+    }
+    case ast::BinaryOp::kLessThan:
+    case ast::BinaryOp::kGreaterThan:
+    case ast::BinaryOp::kLessThanEqual:
+    case ast::BinaryOp::kGreaterThanEqual: {
+      // Compare by swapping the operands, so that only < and <= are needed.
+      bool swap = op == ast::BinaryOp::kGreaterThan ||
+                  op == ast::BinaryOp::kGreaterThanEqual;
+      bool or_equal = op == ast::BinaryOp::kLessThanEqual ||
+                      op == ast::BinaryOp::kGreaterThanEqual;
+      if (swap) {
+        std::swap(a, b);
+      }
+      switch (kind) {
+        case Kind::kI32:
+          *out = Scalar(or_equal ? a.i32 <= b.i32 : a.i32 < b.i32);
+          return true;
+        case Kind::kU32:
+          *out = Scalar(or_equal ? a.u32 <= b.u32 : a.u32 < b.u32);
+          return true;
+        case Kind::kF32:
+          *out = Scalar(or_equal ? a.f32 <= b.f32 : a.f32 < b.f32);
+          return true;
+        default:
+          return false;
+      }
+    }
+    case ast::BinaryOp::kLogicalAnd:
+      if (kind != Kind::kBool) {
+        return false;
+      }
+      *out = Scalar(a.b && b.b);
+      return true;
+    case ast::BinaryOp::kLogicalOr:
+      if (kind != Kind::kBool) {
+        return false;
+      }
+      *out = Scalar(a.b || b.b);
+      return true;
+    case ast::BinaryOp::kAnd:
+    case ast::BinaryOp::kOr:
+    case ast::BinaryOp::kXor: {
+      if (kind == Kind::kBool) {
+        if (op == ast::BinaryOp::kXor) {
+          return false;
+        }
+        *out = Scalar(op == ast::BinaryOp::kAnd ? a.b && b.b : a.b || b.b);
+        return true;
+      }
+      if (kind != Kind::kI32 && kind != Kind::kU32) {
+        return false;
+      }
+      uint32_t bits = 0;
+      if (op == ast::BinaryOp::kAnd) {
+        bits = a.u32 & b.u32;
+      } else if (op == ast::BinaryOp::kOr) {
+        bits = a.u32 | b.u32;
+      } else {
+        bits = a.u32 ^ b.u32;
+      }
+      *out = FromBits(kind, bits);
+      return true;
+    }
+    case ast::BinaryOp::kAdd:
+    case ast::BinaryOp::kSubtract:
+    case ast::BinaryOp::kMultiply:
+    case ast::BinaryOp::kDivide:
+    case ast::BinaryOp::kModulo:
+      break;
+    default:
+      return false;
+  }
+
+  // Arithmetic
+  switch (kind) {
+    case Kind::kF32: {
+      float f = 0;
+      switch (op) {
+        case ast::BinaryOp::kAdd:
+          f = a.f32 + b.f32;
+          break;
+        case ast::BinaryOp::kSubtract:
+          f = a.f32 - b.f32;
+          break;
+        case ast::BinaryOp::kMultiply:
+          f = a.f32 * b.f32;
+          break;
+        case ast::BinaryOp::kDivide:
+          if (b.f32 == 0.f) {
+            return false;
+          }
+          f = a.f32 / b.f32;
+          break;
+        default:
+          if (b.f32 == 0.f) {
+            return false;
+          }
+          f = std::fmod(a.f32, b.f32);
+          break;
+      }
+      if (!IsValid(f)) {
+        return false;
+      }
+      *out = Scalar(f);
+      return true;
+    }
+    case Kind::kI32: {
+      auto x = static_cast<uint32_t>(a.i32);
+      auto y = static_cast<uint32_t>(b.i32);
+      switch (op) {
+        case ast::BinaryOp::kAdd:
+          *out = Scalar(Wrap(x + y));
+          return true;
+        case ast::BinaryOp::kSubtract:
+          *out = Scalar(Wrap(x - y));
+          return true;
+        case ast::BinaryOp::kMultiply:
+          *out = Scalar(Wrap(x * y));
+          return true;
+        default:
+          if (b.i32 == 0 || (a.i32 == std::numeric_limits<int32_t>::min() &&
+                             b.i32 == -1)) {
+            return false;
+          }
+          *out = Scalar(op == ast::BinaryOp::kDivide ? a.i32 / b.i32
+                                                      : a.i32 % b.i32);
+          return true;
+      }
+    }
+    case Kind::kU32:
+      switch (op) {
+        case ast::BinaryOp::kAdd:
+          *out = Scalar(static_cast<uint32_t>(a.u32 + b.u32));
+          return true;
+        case ast::BinaryOp::kSubtract:
+          *out = Scalar(static_cast<uint32_t>(a.u32 - b.u32));
+          return true;
+        case ast::BinaryOp::kMultiply:
+          *out = Scalar(static_cast<uint32_t>(a.u32 * b.u32));
+          return true;
+        default:
+          if (b.u32 == 0) {
+            return false;
+          }
+          *out = Scalar(op == ast::BinaryOp::kDivide ? a.u32 / b.u32
+                                                      : a.u32 % b.u32);
+          return true;
+      }
+    default:
+      return false;
+  }
+}
+
+/// Evaluates `a op b` for the shift operator `op`, where `a` is of kind
+/// `kind` and `b` is of kind `shift_kind`
+/// @returns false if the result is not a constant
+bool Shift(ast::BinaryOp op,
+           Kind kind,
+           Kind shift_kind,
+           Scalar a,
+           Scalar b,
+           Scalar* out) {
+  if (kind != Kind::kI32 && kind != Kind::kU32) {
+    return false;
+  }
+  uint32_t shift = 0;
+  if (shift_kind == Kind::kU32) {
+    shift = b.u32;
+  } else if (shift_kind == Kind::kI32 && b.i32 >= 0) {
+    shift = static_cast<uint32_t>(b.i32);
+  } else {
+    return false;
+  }
+  if (shift >= 32) {
+    return false;
+  }
+  if (op == ast::BinaryOp::kShiftLeft) {
+    *out = FromBits(kind, a.u32 << shift);
+  } else if (kind == Kind::kI32 && a.i32 < 0) {
+    // Arithmetic shift right
+    *out = FromBits(kind, ~(~a.u32 >> shift));
+  } else {
+    *out = FromBits(kind, a.u32 >> shift);
+  }
+  return true;
+}
+
+/// @returns the dot product of `count` elements of `a` and `b`, starting at
+/// `a_begin` and `b_begin` and advancing by `a_stride` and `b_stride`
+bool Dot(const Scalars& a,
+         size_t a_begin,
+         size_t a_stride,
+         const Scalars& b,
+         size_t b_begin,
+         size_t b_stride,
+         uint32_t count,
+         Scalar* out) {
+  float sum = 0.f;
+  for (uint32_t i = 0; i < count; i++) {
+    float product =
+        a[a_begin + i * a_stride].f32 * b[b_begin + i * b_stride].f32;
+    sum = i == 0 ? product : sum + product;
+    if (!IsValid(product) || !IsValid(sum)) {
+      return false;
+    }
+  }
+  *out = Scalar(sum);
+  return true;
+}
+
+/// Evaluates a matrix multiplication, or returns false if `lhs * rhs` is not
+/// a constant matrix multiplication.
+bool MatrixMultiply(const ast::ConstantValue* lhs,
+                    const ast::ConstantValue* rhs,
+                    Scalars* out) {
+  auto* lhs_mat = lhs->type()->As<type::Matrix>();
+  auto* rhs_mat = rhs->type()->As<type::Matrix>();
+  auto* lhs_vec = lhs->type()->As<type::Vector>();
+  auto* rhs_vec = rhs->type()->As<type::Vector>();
+  auto& a = lhs->elements();
+  auto& b = rhs->elements();
+  Scalar s;
+
+  if (lhs_mat && rhs_vec) {
+    // The rows of the matrix dotted with the vector
+    for (uint32_t r = 0; r < lhs_mat->rows(); r++) {
+      if (!Dot(a, r, lhs_mat->rows(), b, 0, 1, lhs_mat->columns(), &s)) {
+        return false;
+      }
+      out->emplace_back(s);
+    }
+    return true;
+  }
+  if (lhs_vec && rhs_mat) {
+    // The vector dotted with the columns of the matrix
+    for (uint32_t c = 0; c < rhs_mat->columns(); c++) {
+      if (!Dot(a, 0, 1, b, c * rhs_mat->rows(), 1, rhs_mat->rows(), &s)) {
+        return false;
+      }
+      out->emplace_back(s);
+    }
+    return true;
+  }
+  if (lhs_mat && rhs_mat) {
+    for (uint32_t c = 0; c < rhs_mat->columns(); c++) {
+      for (uint32_t r = 0; r < lhs_mat->rows(); r++) {
+        if (!Dot(a, r, lhs_mat->rows(), b, c * rhs_mat->rows(), 1,
+                 lhs_mat->columns(), &s)) {
+          return false;
+        }
+        out->emplace_back(s);
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+/// Evaluates the intrinsic `intrinsic` on the scalar arguments `args` of
+/// kind `kind`
+/// @returns false if the intrinsic cannot be evaluated
+bool EvaluateIntrinsic(ast::Intrinsic intrinsic,
+                       Kind kind,
+                       const Scalars& args,
+                       Scalar* out) {
+  switch (intrinsic) {
+    case ast::Intrinsic::kAbs:
+      switch (kind) {
+        case Kind::kF32:
+          *out = Scalar(std::fabs(args[0].f32));
+          return true;
+        case Kind::kI32:
+          *out = Scalar(args[0].i32 < 0
+                            ? Wrap(0u - static_cast<uint32_t>(args[0].i32))
+                            : args[0].i32);
+          return true;
+        case Kind::kU32:
+          *out = args[0];
+          return true;
+        default:
+          return false;
+      }
+    case ast::Intrinsic::kMin:
+    case ast::Intrinsic::kMax: {
+      Scalar less;
+      if (!Binary(ast::BinaryOp::kLessThan, kind, args[1], args[0], &less)) {
+        return false;
+      }
+      if (intrinsic == ast::Intrinsic::kMin) {
+        *out = less.b ? args[1] : args[0];
+      } else {
+        *out = less.b ? args[0] : args[1];
+      }
+      return true;
+    }
+    case ast::Intrinsic::kClamp: {
+      Scalar low;
+      if (!EvaluateIntrinsic(ast::Intrinsic::kMax, kind, {args[0], args[1]},
+                             &low)) {
+        return false;
+      }
+      return EvaluateIntrinsic(ast::Intrinsic::kMin, kind, {low, args[2]},
+                               out);
+    }
+    default:
+      break;
+  }
+
+  if (kind != Kind::kF32) {
+    return false;
+  }
+  float x = args[0].f32;
+  float f = 0;
+  switch (intrinsic) {
+    case ast::Intrinsic::kCeil:
+      f = std::ceil(x);
+      break;
+    case ast::Intrinsic::kFloor:
+      f = std::floor(x);
+      break;
+    case ast::Intrinsic::kTrunc:
+      f = std::trunc(x);
+      break;
+    case ast::Intrinsic::kSign:
+      f = x > 0.f ? 1.f : (x < 0.f ? -1.f : x);
+      break;
+    case ast::Intrinsic::kSqrt:
+      if (x < 0.f) {
+        return false;
+      }
+      f = std::sqrt(x);
+      break;
+    default:
+      return false;
+  }
+  *out = Scalar(f);
+  return true;
+}
+
+}  // namespace
+
+ConstantEvaluator::ConstantEvaluator(const ast::Module* module,
+                                     const SymbolTable* symbols)
+    : symbols_(symbols) {
+  for (auto* var : module->GlobalVariables()) {
+    globals_.emplace(var->symbol(), var);
+  }
+}
+
+ConstantEvaluator::~ConstantEvaluator() = default;
+
+ConstantEvaluator::Value ConstantEvaluator::Evaluate(ast::Expression* expr) {
+  Value value;
+  if (auto* a = expr->As<ast::ArrayAccessorExpression>()) {
+    value = EvaluateArrayAccessor(a);
+  } else if (auto* b = expr->As<ast::BinaryExpression>()) {
+    value = EvaluateBinary(b);
+  } else if (auto* b = expr->As<ast::BitcastExpression>()) {
+    value = EvaluateBitcast(b);
+  } else if (auto* c = expr->As<ast::CallExpression>()) {
+    value = EvaluateCall(c);
+  } else if (auto* i = expr->As<ast::IdentifierExpression>()) {
+    value = EvaluateIdentifier(i);
+  } else if (auto* m = expr->As<ast::MemberAccessorExpression>()) {
+    value = EvaluateMemberAccessor(m);
+  } else if (auto* s = expr->As<ast::ScalarConstructorExpression>()) {
+    value = EvaluateScalarConstructor(s);
+  } else if (auto* t = expr->As<ast::TypeConstructorExpression>()) {
+    value = EvaluateTypeConstructor(t);
+  } else if (auto* u = expr->As<ast::UnaryOpExpression>()) {
+    value = EvaluateUnaryOp(u);
+  }
+  return value;
+}
+
+const ast::ConstantValue* ConstantEvaluator::ValueOf(ast::Variable* var) {
+  auto it = global_values_.find(var);
+  if (it != global_values_.end()) {
+    return it->second.get();
+  }
+  Value value;
+  if (var->is_const() && var->has_constructor() &&
+      !var->HasConstantIdDecoration()) {
+    value = Evaluate(var->constructor());
+  }
+  // Constants that are not constant expressions are cached too, so that they
+  // are not evaluated again for each reference.
+  auto* result = value.get();
+  global_values_.emplace(var, std::move(value));
+  return result;
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateArrayAccessor(
+    ast::ArrayAccessorExpression* expr) {
+  auto array = Evaluate(expr->array());
+  auto idx = Evaluate(expr->idx_expr());
+  auto* ty = ValueTypeOf(expr);
+  if (array == nullptr || idx == nullptr || ty == nullptr) {
+    return nullptr;
+  }
+
+  int64_t index = 0;
+  switch (KindOf(idx->type())) {
+    case Kind::kI32:
+      index = idx->elements()[0].i32;
+      break;
+    case Kind::kU32:
+      index = idx->elements()[0].u32;
+      break;
+    default:
+      return nullptr;
+  }
+
+  // Vectors are indexed by element, matrices by column.
+  auto stride = ElementCount(ty);
+  auto count = array->elements().size() / stride;
+  if (index < 0 || static_cast<uint64_t>(index) >= count) {
+    return nullptr;
+  }
+  auto begin = array->elements().begin() + static_cast<size_t>(index) * stride;
+  return std::make_unique<ast::ConstantValue>(ty,
+                                              Scalars(begin, begin + stride));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateBinary(
+    ast::BinaryExpression* expr) {
+  auto lhs = Evaluate(expr->lhs());
+  auto rhs = Evaluate(expr->rhs());
+  auto* ty = ValueTypeOf(expr);
+  if (lhs == nullptr || rhs == nullptr || ty == nullptr) {
+    return nullptr;
+  }
+
+  Scalars elements;
+  if (expr->IsMultiply() && MatrixMultiply(lhs.get(), rhs.get(), &elements)) {
+    if (elements.size() != ElementCount(ty)) {
+      return nullptr;
+    }
+    return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+  }
+  if (lhs->type()->Is<type::Matrix>() != rhs->type()->Is<type::Matrix>() &&
+      lhs->elements().size() > 1 && rhs->elements().size() > 1) {
+    // A matrix multiplication that could not be evaluated
+    return nullptr;
+  }
+
+  // Component-wise, with a scalar operand applied to each component of the
+  // other operand.
+  auto lhs_count = lhs->elements().size();
+  auto rhs_count = rhs->elements().size();
+  if (lhs_count != rhs_count && lhs_count != 1 && rhs_count != 1) {
+    return nullptr;
+  }
+  auto count = std::max(lhs_count, rhs_count);
+  if (count != ElementCount(ty)) {
+    return nullptr;
+  }
+
+  auto kind = KindOf(lhs->element_type());
+  bool is_shift = expr->IsShiftLeft() || expr->IsShiftRight();
+  if (!is_shift && kind != KindOf(rhs->element_type())) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < count; i++) {
+    auto a = lhs->elements()[lhs_count == 1 ? 0 : i];
+    auto b = rhs->elements()[rhs_count == 1 ? 0 : i];
+    Scalar s;
+    bool ok = is_shift ? Shift(expr->op(), kind, KindOf(rhs->element_type()),
+                               a, b, &s)
+                       : Binary(expr->op(), kind, a, b, &s);
+    if (!ok) {
+      return nullptr;
+    }
+    elements.emplace_back(s);
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateBitcast(
+    ast::BitcastExpression* expr) {
+  auto value = Evaluate(expr->expr());
+  auto* ty = ValueTypeOf(expr);
+  if (value == nullptr || ty == nullptr ||
+      value->elements().size() != ElementCount(ty)) {
+    return nullptr;
+  }
+  auto from = KindOf(value->element_type());
+  auto to = KindOf(ElementCount(ty) == 1 ? ty : ty->As<type::Vector>()->type());
+  if (from == Kind::kBool || from == Kind::kOther || to == Kind::kBool ||
+      to == Kind::kOther) {
+    return nullptr;
+  }
+
+  Scalars elements;
+  for (auto& el : value->elements()) {
+    elements.emplace_back(FromBits(to, BitsOf(el)));
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateCall(
+    ast::CallExpression* expr) {
+  std::vector<Value> args;
+  bool all_constant = true;
+  for (auto* param : expr->params()) {
+    args.emplace_back(Evaluate(param));
+    all_constant = all_constant && args.back() != nullptr;
+  }
+
+  auto* ident = expr->func()->As<ast::IdentifierExpression>();
+  auto* ty = ValueTypeOf(expr);
+  if (!all_constant || args.empty() || ident == nullptr ||
+      !ident->IsIntrinsic() || ty == nullptr) {
+    return nullptr;
+  }
+
+  Scalars elements;
+  auto intrinsic = ident->intrinsic();
+  if (intrinsic == ast::Intrinsic::kAll || intrinsic == ast::Intrinsic::kAny) {
+    bool is_all = intrinsic == ast::Intrinsic::kAll;
+    bool result = is_all;
+    for (auto& el : args[0]->elements()) {
+      result = is_all ? result && el.b : result || el.b;
+    }
+    elements.emplace_back(Scalar(result));
+    return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+  }
+
+  // The remaining intrinsics are component-wise, with all arguments of the
+  // same type.
+  auto count = args[0]->elements().size();
+  for (auto& arg : args) {
+    if (arg->type() != args[0]->type()) {
+      return nullptr;
+    }
+  }
+  if (count != ElementCount(ty)) {
+    return nullptr;
+  }
+  auto kind = KindOf(args[0]->element_type());
+  for (size_t i = 0; i < count; i++) {
+    Scalars scalars;
+    for (auto& arg : args) {
+      scalars.emplace_back(arg->elements()[i]);
+    }
+    Scalar s;
+    if (!EvaluateIntrinsic(intrinsic, kind, scalars, &s)) {
+      return nullptr;
+    }
+    elements.emplace_back(s);
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateIdentifier(
+    ast::IdentifierExpression* expr) {
+  auto it = globals_.find(expr->symbol());
+  if (it == globals_.end()) {
+    return nullptr;
+  }
+  auto* value = ValueOf(it->second);
+  if (value == nullptr || value->type() != ValueTypeOf(expr)) {
+    return nullptr;
+  }
+  return std::make_unique<ast::ConstantValue>(*value);
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateMemberAccessor(
+    ast::MemberAccessorExpression* expr) {
+  auto value = Evaluate(expr->structure());
+  auto* ty = ValueTypeOf(expr);
+  if (value == nullptr || ty == nullptr ||
+      !value->type()->Is<type::Vector>()) {
+    return nullptr;
+  }
+
+  auto swizzle = symbols_->NameFor(expr->member()->symbol());
+  if (swizzle.size() != ElementCount(ty)) {
+    return nullptr;
+  }
+  Scalars elements;
+  for (auto c : swizzle) {
+    size_t index = 0;
+    switch (c) {
+      case 'x':
+      case 'r':
+        index = 0;
+        break;
+      case 'y':
+      case 'g':
+        index = 1;
+        break;
+      case 'z':
+      case 'b':
+        index = 2;
+        break;
+      case 'w':
+      case 'a':
+        index = 3;
+        break;
+      default:
+        return nullptr;
+    }
+    if (index >= value->elements().size()) {
+      return nullptr;
+    }
+    elements.emplace_back(value->elements()[index]);
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateScalarConstructor(
+    ast::ScalarConstructorExpression* expr) {
+  auto* lit = expr->literal();
+  auto* ty = lit->type()->UnwrapAll();
+  Scalar s;
+  if (auto* b = lit->As<ast::BoolLiteral>()) {
+    s = Scalar(b->IsTrue());
+  } else if (auto* i = lit->As<ast::SintLiteral>()) {
+    s = Scalar(i->value());
+  } else if (auto* u = lit->As<ast::UintLiteral>()) {
+    s = Scalar(u->value());
+  } else if (auto* f = lit->As<ast::FloatLiteral>()) {
+    s = Scalar(f->value());
+  } else {
+    return nullptr;
+  }
+  return std::make_unique<ast::ConstantValue>(ty, Scalars{s});
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateTypeConstructor(
+    ast::TypeConstructorExpression* expr) {
+  std::vector<Value> values;
+  bool all_constant = true;
+  for (auto* value : expr->values()) {
+    values.emplace_back(Evaluate(value));
+    all_constant = all_constant && values.back() != nullptr;
+  }
+
+  auto* ty = expr->type()->UnwrapAll();
+  auto count = ElementCount(ty);
+  if (!all_constant || count == 0) {
+    return nullptr;
+  }
+
+  // The zero value
+  if (values.empty()) {
+    return std::make_unique<ast::ConstantValue>(ty, Scalars(count));
+  }
+
+  // A scalar conversion
+  auto* el_type = ast::ConstantValue(ty, {}).element_type();
+  auto kind = KindOf(el_type);
+  if (count == 1) {
+    Scalar s;
+    if (values.size() != 1 ||
+        !Convert(KindOf(values[0]->element_type()), kind,
+                 values[0]->elements()[0], &s)) {
+      return nullptr;
+    }
+    return std::make_unique<ast::ConstantValue>(ty, Scalars{s});
+  }
+
+  // A vector or matrix built from its components or columns
+  Scalars elements;
+  for (auto& value : values) {
+    if (value->element_type() != el_type) {
+      return nullptr;
+    }
+    elements.insert(elements.end(), value->elements().begin(),
+                    value->elements().end());
+  }
+  if (elements.size() == 1 && ty->Is<type::Vector>()) {
+    elements.resize(count, elements[0]);
+  }
+  if (elements.size() != count) {
+    return nullptr;
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+ConstantEvaluator::Value ConstantEvaluator::EvaluateUnaryOp(
+    ast::UnaryOpExpression* expr) {
+  auto value = Evaluate(expr->expr());
+  auto* ty = ValueTypeOf(expr);
+  if (value == nullptr || ty == nullptr ||
+      value->elements().size() != ElementCount(ty)) {
+    return nullptr;
+  }
+
+  auto kind = KindOf(value->element_type());
+  Scalars elements;
+  for (auto& el : value->elements()) {
+    if (expr->op() == ast::UnaryOp::kNot) {
+      if (kind != Kind::kBool) {
+        return nullptr;
+      }
+      elements.emplace_back(Scalar(!el.b));
+    } else if (kind == Kind::kF32) {
+      elements.emplace_back(Scalar(-el.f32));
+    } else if (kind == Kind::kI32) {
+      elements.emplace_back(Scalar(Wrap(0u - static_cast<uint32_t>(el.i32))));
+    } else {
+      return nullptr;
+    }
+  }
+  return std::make_unique<ast::ConstantValue>(ty, std::move(elements));
+}
+
+}  // namespace tint
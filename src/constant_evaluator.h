@@ -0,0 +1,94 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_CONSTANT_EVALUATOR_H_
+#define SRC_CONSTANT_EVALUATOR_H_
+
+#include <memory>
+#include <unordered_map>
+
+#include "src/ast/constant_value.h"
+#include "src/symbol.h"
+#include "src/symbol_table.h"
+
+namespace tint {
+namespace ast {
+
+class ArrayAccessorExpression;
+class BinaryExpression;
+class BitcastExpression;
+class CallExpression;
+class Expression;
+class IdentifierExpression;
+class MemberAccessorExpression;
+class Module;
+class ScalarConstructorExpression;
+class TypeConstructorExpression;
+class UnaryOpExpression;
+class Variable;
+
+}  // namespace ast
+
+/// Evaluates expressions that only depend on literals and module-scope
+/// constants. Values are computed on demand and are not stored on the AST.
+///
+/// Scalar, vector and matrix arithmetic, conversions, bitcasts, swizzles,
+/// constant indexing and a subset of the intrinsics are evaluated.
+/// Floating point operations are evaluated with f32 precision, rounding the
+/// result of each operation to nearest. Expressions whose evaluation would
+/// overflow a f32, produce a NaN, divide by zero or shift by more than the bit
+/// width are left unevaluated, as are constants decorated with
+/// `[[constant_id]]`, as the pipeline can override their values.
+class ConstantEvaluator {
+ public:
+  /// Constructor
+  /// @param module the module declaring the constants. The module must have
+  /// been resolved by the TypeDeterminer.
+  /// @param symbols the symbol table of the module
+  ConstantEvaluator(const ast::Module* module, const SymbolTable* symbols);
+
+  /// Destructor
+  ~ConstantEvaluator();
+
+  /// Evaluates `expr`
+  /// @param expr the expression to evaluate
+  /// @returns the value of `expr` or nullptr if `expr` is not a constant
+  /// expression
+  std::unique_ptr<ast::ConstantValue> Evaluate(ast::Expression* expr);
+
+ private:
+  using Value = std::unique_ptr<ast::ConstantValue>;
+
+  /// @returns the value of the module-scope variable `var`, or nullptr if
+  /// `var` is not a constant with a constant expression initializer
+  const ast::ConstantValue* ValueOf(ast::Variable* var);
+
+  Value EvaluateArrayAccessor(ast::ArrayAccessorExpression* expr);
+  Value EvaluateBinary(ast::BinaryExpression* expr);
+  Value EvaluateBitcast(ast::BitcastExpression* expr);
+  Value EvaluateCall(ast::CallExpression* expr);
+  Value EvaluateIdentifier(ast::IdentifierExpression* expr);
+  Value EvaluateMemberAccessor(ast::MemberAccessorExpression* expr);
+  Value EvaluateScalarConstructor(ast::ScalarConstructorExpression* expr);
+  Value EvaluateTypeConstructor(ast::TypeConstructorExpression* expr);
+  Value EvaluateUnaryOp(ast::UnaryOpExpression* expr);
+
+  const SymbolTable* symbols_;
+  std::unordered_map<Symbol, ast::Variable*> globals_;
+  std::unordered_map<const ast::Variable*, Value> global_values_;
+};
+
+}  // namespace tint
+
+#endif  // SRC_CONSTANT_EVALUATOR_H_
@@ -0,0 +1,229 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/constant_evaluator.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/ast/binary_expression.h"
+#include "src/ast/bitcast_expression.h"
+#include "src/ast/constant_id_decoration.h"
+#include "src/ast/unary_op_expression.h"
+#include "src/program_builder.h"
+#include "src/type_determiner.h"
+
+namespace tint {
+namespace {
+
+class ConstantEvaluatorTest : public ProgramBuilder, public testing::Test {
+ protected:
+  /// Declares a module-scope constant of type `type` initialized with `expr`,
+  /// runs the TypeDeterminer and evaluates `expr`.
+  /// @returns the value of `expr`
+  const ast::ConstantValue* Eval(type::Type* type, ast::Expression* expr) {
+    AST().AddGlobalVariable(
+        Const("c" + std::to_string(AST().GlobalVariables().size()),
+              ast::StorageClass::kNone, type, expr, {}));
+    TypeDeterminer td(this);
+    EXPECT_TRUE(td.Determine()) << td.error();
+    value_ = ConstantEvaluator(&AST(), &Symbols()).Evaluate(expr);
+    return value_.get();
+  }
+
+  ast::Expression* Binary(ast::BinaryOp op,
+                          ast::Expression* lhs,
+                          ast::Expression* rhs) {
+    return create<ast::BinaryExpression>(op, lhs, rhs);
+  }
+
+  static std::vector<float> F32s(const ast::ConstantValue* value) {
+    std::vector<float> out;
+    for (auto& el : value->elements()) {
+      out.emplace_back(el.f32);
+    }
+    return out;
+  }
+
+  static std::vector<int32_t> I32s(const ast::ConstantValue* value) {
+    std::vector<int32_t> out;
+    for (auto& el : value->elements()) {
+      out.emplace_back(el.i32);
+    }
+    return out;
+  }
+
+ private:
+  std::unique_ptr<ast::ConstantValue> value_;
+};
+
+TEST_F(ConstantEvaluatorTest, ScalarArithmetic) {
+  auto* value = Eval(ty.i32(), Add(Mul(2, 3), Sub(10, 4)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->type(), ty.i32());
+  EXPECT_EQ(I32s(value), (std::vector<int32_t>{12}));
+}
+
+TEST_F(ConstantEvaluatorTest, SignedIntegerOverflowWraps) {
+  auto* value = Eval(ty.i32(), Add(2147483647, 1));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(I32s(value), (std::vector<int32_t>{-2147483647 - 1}));
+}
+
+TEST_F(ConstantEvaluatorTest, ShiftRight_Signed) {
+  auto* value =
+      Eval(ty.i32(), Binary(ast::BinaryOp::kShiftRight, Expr(-8), Expr(1u)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(I32s(value), (std::vector<int32_t>{-4}));
+}
+
+TEST_F(ConstantEvaluatorTest, Comparison) {
+  auto* value =
+      Eval(ty.bool_(), Binary(ast::BinaryOp::kLessThan, Expr(1.f), Expr(2.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->type(), ty.bool_());
+  EXPECT_TRUE(value->elements()[0].b);
+}
+
+TEST_F(ConstantEvaluatorTest, VectorArithmetic) {
+  auto* value = Eval(ty.vec3<f32>(), Add(vec3<f32>(1.f, 2.f, 3.f),
+                                         vec3<f32>(4.f, 5.f, 6.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->type(), ty.vec3<f32>());
+  EXPECT_EQ(value->element_type(), ty.f32());
+  EXPECT_EQ(F32s(value), (std::vector<float>{5.f, 7.f, 9.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, VectorTimesScalar) {
+  auto* value = Eval(ty.vec2<f32>(), Mul(vec2<f32>(1.f, 2.f), 3.f));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{3.f, 6.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, MatrixTimesVector) {
+  // Columns (1, 2) and (3, 4)
+  auto* mat = mat2x2<f32>(vec2<f32>(1.f, 2.f), vec2<f32>(3.f, 4.f));
+  auto* value = Eval(ty.vec2<f32>(), Mul(mat, vec2<f32>(1.f, 1.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{4.f, 6.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, VectorTimesMatrix) {
+  auto* mat = mat2x2<f32>(vec2<f32>(1.f, 2.f), vec2<f32>(3.f, 4.f));
+  auto* value = Eval(ty.vec2<f32>(), Mul(vec2<f32>(1.f, 1.f), mat));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{3.f, 7.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, GlobalConstant) {
+  AST().AddGlobalVariable(
+      Const("a", ast::StorageClass::kNone, ty.f32(), Expr(2.f), {}));
+  auto* value = Eval(ty.f32(), Mul("a", 4.f));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{8.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, GlobalVariable_NotEvaluated) {
+  AST().AddGlobalVariable(
+      Var("a", ast::StorageClass::kPrivate, ty.f32(), Expr(2.f), {}));
+  EXPECT_EQ(Eval(ty.f32(), Mul("a", 4.f)), nullptr);
+}
+
+TEST_F(ConstantEvaluatorTest, ConstantId_NotEvaluated) {
+  AST().AddGlobalVariable(
+      Const("a", ast::StorageClass::kNone, ty.f32(), Expr(2.f),
+            {create<ast::ConstantIdDecoration>(0)}));
+  EXPECT_EQ(Eval(ty.f32(), Mul("a", 4.f)), nullptr);
+}
+
+TEST_F(ConstantEvaluatorTest, DivideByZero_NotEvaluated) {
+  EXPECT_EQ(Eval(ty.i32(), Binary(ast::BinaryOp::kDivide, Expr(1), Expr(0))),
+            nullptr);
+}
+
+TEST_F(ConstantEvaluatorTest, FloatOverflow_NotEvaluated) {
+  EXPECT_EQ(Eval(ty.f32(), Mul(3e38f, 10.f)), nullptr);
+}
+
+TEST_F(ConstantEvaluatorTest, Conversion) {
+  auto* value = Eval(ty.i32(), Construct(ty.i32(), -2.5f));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(I32s(value), (std::vector<int32_t>{-2}));
+}
+
+TEST_F(ConstantEvaluatorTest, Conversion_OutOfRange) {
+  EXPECT_EQ(Eval(ty.u32(), Construct(ty.u32(), -2.5f)), nullptr);
+}
+
+TEST_F(ConstantEvaluatorTest, Splat) {
+  auto* value = Eval(ty.vec3<f32>(), vec3<f32>(2.f));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{2.f, 2.f, 2.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, Bitcast) {
+  auto* value =
+      Eval(ty.u32(), create<ast::BitcastExpression>(ty.u32(), Expr(1.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->elements()[0].u32, 0x3f800000u);
+}
+
+TEST_F(ConstantEvaluatorTest, Swizzle) {
+  auto* value =
+      Eval(ty.vec2<f32>(), MemberAccessor(vec3<f32>(1.f, 2.f, 3.f), "zx"));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->type(), ty.vec2<f32>());
+  EXPECT_EQ(F32s(value), (std::vector<float>{3.f, 1.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, Index) {
+  auto* value = Eval(ty.f32(), IndexAccessor(vec3<f32>(1.f, 2.f, 3.f), 1));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{2.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, Negation) {
+  auto* value = Eval(ty.f32(), create<ast::UnaryOpExpression>(
+                                   ast::UnaryOp::kNegation, Expr(2.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{-2.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, Intrinsic) {
+  auto* value = Eval(ty.vec2<f32>(),
+                     Call("clamp", vec2<f32>(-1.f, 5.f), vec2<f32>(0.f, 0.f),
+                          vec2<f32>(2.f, 2.f)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(F32s(value), (std::vector<float>{0.f, 2.f}));
+}
+
+TEST_F(ConstantEvaluatorTest, Intrinsic_Any) {
+  auto* value = Eval(ty.bool_(), Call("any", vec2<bool>(false, true)));
+  ASSERT_NE(value, nullptr);
+  EXPECT_TRUE(value->elements()[0].b);
+}
+
+TEST_F(ConstantEvaluatorTest, ConstantOfConstant) {
+  AST().AddGlobalVariable(
+      Const("a", ast::StorageClass::kNone, ty.i32(), Expr(2), {}));
+  AST().AddGlobalVariable(
+      Const("b", ast::StorageClass::kNone, ty.i32(), Mul("a", 3), {}));
+  auto* value = Eval(ty.i32(), Add("b", "a"));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(I32s(value), (std::vector<int32_t>{8}));
+}
+
+}  // namespace
+}  // namespace tint
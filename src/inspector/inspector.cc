@@ -207,7 +207,9 @@ std::vector<ResourceBinding> Inspector::GetUniformBufferResourceBindings(
     entry.bind_group = binding_info.group->value();
     entry.binding = binding_info.binding->value();
     entry.min_buffer_binding_size =
-        var->type()->MinBufferBindingSize(type::MemoryLayout::kUniformBuffer);
+        program_->Types()
+            .LayoutOf(var->type(), type::MemoryLayout::kUniformBuffer)
+            .size;
 
     result.push_back(entry);
   }
@@ -330,7 +332,9 @@ std::vector<ResourceBinding> Inspector::GetStorageBufferResourceBindingsImpl(
     entry.bind_group = binding_info.group->value();
     entry.binding = binding_info.binding->value();
     entry.min_buffer_binding_size =
-        var->type()->MinBufferBindingSize(type::MemoryLayout::kStorageBuffer);
+        program_->Types()
+            .LayoutOf(var->type(), type::MemoryLayout::kStorageBuffer)
+            .size;
 
     result.push_back(entry);
   }
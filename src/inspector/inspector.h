@@ -71,7 +71,9 @@ struct ResourceBinding {
 class Inspector {
  public:
   /// Constructor
-  /// @param program Shader program to extract information from.
+  /// @param program Shader program to extract information from. This may
+  /// also be a program from reader::wgsl::ParseForReflection(), which is not
+  /// resolved but has the referenced module variables of each function.
   explicit Inspector(const Program* program);
 
   /// Destructor
@@ -0,0 +1,41 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_READER_WGSL_INPUT_STREAM_H_
+#define SRC_READER_WGSL_INPUT_STREAM_H_
+
+#include <string>
+
+namespace tint {
+namespace reader {
+namespace wgsl {
+
+/// InputStream is the interface for WGSL source text that is produced in
+/// chunks, instead of being held in a single Source::File.
+/// Chunks may be split at any byte.
+class InputStream {
+ public:
+  virtual ~InputStream();
+
+  /// Appends the next chunk of source text to `out`.
+  /// @param out the string to append the chunk to
+  /// @returns false if the end of the input has been reached
+  virtual bool Read(std::string* out) = 0;
+};
+
+}  // namespace wgsl
+}  // namespace reader
+}  // namespace tint
+
+#endif  // SRC_READER_WGSL_INPUT_STREAM_H_
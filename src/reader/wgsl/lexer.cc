@@ -30,18 +30,183 @@ bool is_whitespace(char c) {
   return std::isspace(c);
 }
 
+/// @returns the value of the digit `c` in base 16, or 16 if `c` is not a
+/// hexadecimal digit
+uint32_t digit_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return static_cast<uint32_t>(c - '0');
+  }
+  if (c >= 'a' && c <= 'f') {
+    return static_cast<uint32_t>(c - 'a' + 10);
+  }
+  if (c >= 'A' && c <= 'F') {
+    return static_cast<uint32_t>(c - 'A' + 10);
+  }
+  return 16;
+}
+
+/// Parses the integer in [`begin`, `end`), which may start with a `-` and,
+/// for base 16, a `0x` prefix. Like strtoll(), values that do not fit in an
+/// int64_t saturate to the nearest limit.
+int64_t parse_int(const char* begin, const char* end, uint32_t base) {
+  bool negative = false;
+  if (begin != end && *begin == '-') {
+    negative = true;
+    begin++;
+  }
+  if (base == 16 && end - begin >= 2 && begin[0] == '0' && begin[1] == 'x') {
+    begin += 2;
+  }
+
+  const uint64_t limit =
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) +
+      (negative ? 1 : 0);
+  uint64_t magnitude = 0;
+  for (; begin != end; begin++) {
+    auto digit = digit_value(*begin);
+    if (digit >= base) {
+      break;
+    }
+    if (magnitude > (limit - digit) / base) {
+      magnitude = limit;
+    } else {
+      magnitude = magnitude * base + digit;
+    }
+  }
+
+  if (!negative) {
+    return static_cast<int64_t>(magnitude);
+  }
+  if (magnitude == 0) {
+    return 0;
+  }
+  return -static_cast<int64_t>(magnitude - 1) - 1;
+}
+
+/// Parses the float literal in [`begin`, `end`) to the nearest double, if this
+/// can be done exactly with a single double multiplication or division.
+/// This is the case when the significant digits fit in 53 bits and the scale
+/// is an exactly representable power of ten, which holds for the vast majority
+/// of literals found in shaders.
+/// @param begin the first character of the literal
+/// @param end one past the last character of the literal
+/// @param out set to the parsed value on success
+/// @returns true on success, false if the literal needs the slow path
+bool parse_float_fast(const char* begin, const char* end, double* out) {
+  static constexpr double kPowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr int64_t kMaxExactPower = 22;
+  constexpr uint64_t kMaxExactInteger = uint64_t{1} << 53;
+  constexpr int kMaxDigits = 19;
+  constexpr int64_t kMaxExponent = 100000;
+
+  bool negative = false;
+  if (begin != end && *begin == '-') {
+    negative = true;
+    begin++;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int64_t exponent = 0;
+  bool after_point = false;
+  for (; begin != end; begin++) {
+    char c = *begin;
+    if (c == '.') {
+      after_point = true;
+      continue;
+    }
+    if (c < '0' || c > '9') {
+      break;
+    }
+    if (after_point) {
+      exponent--;
+    }
+    if (mantissa == 0 && c == '0') {
+      continue;
+    }
+    if (++digits > kMaxDigits) {
+      return false;
+    }
+    mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+  }
+
+  if (begin != end && *begin == 'e') {
+    begin++;
+    bool negative_exponent = false;
+    if (begin != end && (*begin == '+' || *begin == '-')) {
+      negative_exponent = *begin == '-';
+      begin++;
+    }
+    int64_t value = 0;
+    for (; begin != end && *begin >= '0' && *begin <= '9'; begin++) {
+      value = value * 10 + (*begin - '0');
+      if (value > kMaxExponent) {
+        return false;
+      }
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+
+  if (mantissa > kMaxExactInteger) {
+    return false;
+  }
+
+  double result = 0.0;
+  if (mantissa != 0) {
+    if (exponent < 0) {
+      if (exponent < -kMaxExactPower) {
+        return false;
+      }
+      result = static_cast<double>(mantissa) / kPowersOfTen[-exponent];
+    } else {
+      // Exponents beyond the table may still be exact if the excess can be
+      // folded into the mantissa, e.g. 1e30 == 100000000 * 1e22.
+      for (; exponent > kMaxExactPower; exponent--) {
+        mantissa *= 10;
+        if (mantissa > kMaxExactInteger) {
+          return false;
+        }
+      }
+      result = static_cast<double>(mantissa) * kPowersOfTen[exponent];
+    }
+  }
+
+  *out = negative ? -result : result;
+  return true;
+}
+
 }  // namespace
 
 Lexer::Lexer(Source::File const* file)
     : file_(file),
+      content_(&file->content),
       len_(static_cast<uint32_t>(file->content.size())),
       location_{1, 1} {}
 
+Lexer::Lexer(Source::File const* file,
+             uint32_t begin,
+             uint32_t end,
+             Source::Location location)
+    : file_(file),
+      content_(&file->content),
+      len_(end),
+      pos_(begin),
+      location_(location) {}
+
+Lexer::Lexer(Source::File const* file, InputStream* stream)
+    : file_(file), stream_(stream), content_(&buffer_), location_{1, 1} {}
+
 Lexer::~Lexer() = default;
 
 Token Lexer::next() {
   skip_whitespace();
   skip_comments();
+  while (is_eof() && fill()) {
+    skip_whitespace();
+    skip_comments();
+  }
 
   if (is_eof()) {
     return {Token::Type::kEOF, begin_source()};
@@ -92,6 +257,33 @@ void Lexer::end_source(Source& src) const {
   src.range.end = location_;
 }
 
+bool Lexer::fill() {
+  if (stream_ == nullptr || stream_ended_) {
+    return false;
+  }
+
+  // Everything before the cursor has been tokenized, so can be dropped.
+  buffer_.erase(0, pos_);
+  pos_ = 0;
+
+  // Only expose whole lines to the tokenizer. No token spans a line break, so
+  // this ensures that a token is never split across two chunks.
+  for (;;) {
+    auto size = buffer_.size();
+    if (!stream_->Read(&buffer_)) {
+      stream_ended_ = true;
+      len_ = static_cast<uint32_t>(buffer_.size());
+      break;
+    }
+    auto newline = buffer_.rfind('\n');
+    if (newline != std::string::npos && newline >= size) {
+      len_ = static_cast<uint32_t>(newline + 1);
+      break;
+    }
+  }
+  return !is_eof();
+}
+
 bool Lexer::is_eof() const {
   return pos_ >= len_;
 }
@@ -113,15 +305,15 @@ bool Lexer::is_hex(char ch) const {
 }
 
 bool Lexer::matches(size_t pos, const std::string& substr) {
-  if (pos >= len_)
+  if (pos >= len_ || substr.size() > len_ - pos)
     return false;
-  return file_->content.substr(pos, substr.size()) == substr;
+  return content_->compare(pos, substr.size(), substr) == 0;
 }
 
 void Lexer::skip_whitespace() {
   for (;;) {
     auto pos = pos_;
-    while (!is_eof() && is_whitespace(file_->content[pos_])) {
+    while (!is_eof() && is_whitespace((*content_)[pos_])) {
       if (matches(pos_, "\n")) {
         pos_++;
         location_.line++;
@@ -162,7 +354,7 @@ Token Lexer::try_float() {
   if (matches(end, "-")) {
     end++;
   }
-  while (end < len_ && is_digit(file_->content[end])) {
+  while (end < len_ && is_digit((*content_)[end])) {
     end++;
   }
 
@@ -171,7 +363,7 @@ Token Lexer::try_float() {
   }
   end++;
 
-  while (end < len_ && is_digit(file_->content[end])) {
+  while (end < len_ && is_digit((*content_)[end])) {
     end++;
   }
 
@@ -183,7 +375,7 @@ Token Lexer::try_float() {
     }
 
     auto exp_start = end;
-    while (end < len_ && isdigit(file_->content[end])) {
+    while (end < len_ && isdigit((*content_)[end])) {
       end++;
     }
 
@@ -192,26 +384,34 @@ Token Lexer::try_float() {
       return {};
   }
 
-  auto str = file_->content.substr(start, end - start);
-  if (str == "." || str == "-.")
+  auto len = end - start;
+  if ((len == 1 && matches(start, ".")) || (len == 2 && matches(start, "-."))) {
     return {};
+  }
 
   pos_ = end;
   location_.column += (end - start);
 
   end_source(source);
 
-  auto res = strtod(file_->content.c_str() + start, nullptr);
+  const char* str = content_->c_str();
+  double res = 0.0;
+  if (!parse_float_fast(str + start, str + end, &res)) {
+    res = strtod(str + start, nullptr);
+  }
   // This handles if the number is a really small in the exponent
   if (res > 0 && res < static_cast<double>(std::numeric_limits<float>::min())) {
-    return {Token::Type::kError, source, "f32 (" + str + " too small"};
+    return {Token::Type::kError, source,
+            "f32 (" + content_->substr(start, len) + " too small"};
   }
   // This handles if the number is really large negative number
   if (res < static_cast<double>(std::numeric_limits<float>::lowest())) {
-    return {Token::Type::kError, source, "f32 (" + str + ") too small"};
+    return {Token::Type::kError, source,
+            "f32 (" + content_->substr(start, len) + ") too small"};
   }
   if (res > static_cast<double>(std::numeric_limits<float>::max())) {
-    return {Token::Type::kError, source, "f32 (" + str + ") too large"};
+    return {Token::Type::kError, source,
+            "f32 (" + content_->substr(start, len) + ") too large"};
   }
 
   return {source, static_cast<float>(res)};
@@ -221,13 +421,14 @@ Token Lexer::build_token_from_int_if_possible(Source source,
                                               size_t start,
                                               size_t end,
                                               int32_t base) {
-  auto res = strtoll(file_->content.c_str() + start, nullptr, base);
+  const char* str = content_->c_str();
+  auto res = parse_int(str + start, str + end, static_cast<uint32_t>(base));
   if (matches(pos_, "u")) {
     if (static_cast<uint64_t>(res) >
         static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())) {
       return {
           Token::Type::kError, source,
-          "u32 (" + file_->content.substr(start, end - start) + ") too large"};
+          "u32 (" + content_->substr(start, end - start) + ") too large"};
     }
     pos_ += 1;
     location_.column += 1;
@@ -238,12 +439,12 @@ Token Lexer::build_token_from_int_if_possible(Source source,
   if (res < static_cast<int64_t>(std::numeric_limits<int32_t>::min())) {
     return {
         Token::Type::kError, source,
-        "i32 (" + file_->content.substr(start, end - start) + ") too small"};
+        "i32 (" + content_->substr(start, end - start) + ") too small"};
   }
   if (res > static_cast<int64_t>(std::numeric_limits<int32_t>::max())) {
     return {
         Token::Type::kError, source,
-        "i32 (" + file_->content.substr(start, end - start) + ") too large"};
+        "i32 (" + content_->substr(start, end - start) + ") too large"};
   }
   end_source(source);
   return {source, static_cast<int32_t>(res)};
@@ -263,7 +464,7 @@ Token Lexer::try_hex_integer() {
   }
   end += 2;
 
-  while (!is_eof() && is_hex(file_->content[end])) {
+  while (end < len_ && is_hex((*content_)[end])) {
     end += 1;
   }
 
@@ -282,18 +483,18 @@ Token Lexer::try_integer() {
   if (matches(end, "-")) {
     end++;
   }
-  if (end >= len_ || !is_digit(file_->content[end])) {
+  if (end >= len_ || !is_digit((*content_)[end])) {
     return {};
   }
 
   auto first = end;
-  while (end < len_ && is_digit(file_->content[end])) {
+  while (end < len_ && is_digit((*content_)[end])) {
     end++;
   }
 
   // If the first digit is a zero this must only be zero as leading zeros
   // are not allowed.
-  if (file_->content[first] == '0' && (end - first != 1))
+  if ((*content_)[first] == '0' && (end - first != 1))
     return {};
 
   pos_ = end;
@@ -304,19 +505,19 @@ Token Lexer::try_integer() {
 
 Token Lexer::try_ident() {
   // Must begin with an a-zA-Z_
-  if (!is_alpha(file_->content[pos_])) {
+  if (!is_alpha((*content_)[pos_])) {
     return {};
   }
 
   auto source = begin_source();
 
   auto s = pos_;
-  while (!is_eof() && is_alphanum(file_->content[pos_])) {
+  while (!is_eof() && is_alphanum((*content_)[pos_])) {
     pos_++;
     location_.column++;
   }
 
-  auto str = file_->content.substr(s, pos_ - s);
+  auto str = content_->substr(s, pos_ - s);
   auto t = check_reserved(source, str);
   if (!t.IsUninitialized()) {
     return t;
@@ -352,7 +553,7 @@ Token Lexer::try_string() {
   end_source(source);
 
   return {Token::Type::kStringLiteral, source,
-          file_->content.substr(start, end - start)};
+          content_->substr(start, end - start)};
 }
 
 Token Lexer::try_punctuation() {
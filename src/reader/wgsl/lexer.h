@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "src/reader/wgsl/input_stream.h"
 #include "src/reader/wgsl/token.h"
 #include "src/source.h"
 
@@ -30,6 +31,24 @@ class Lexer {
   /// Creates a new Lexer
   /// @param file the input file to parse
   explicit Lexer(Source::File const* file);
+  /// Creates a new Lexer that only tokenizes the byte range [begin, end) of
+  /// `file`. Token sources start at `location`, which must be the location of
+  /// the byte at `begin`.
+  /// @param file the input file to parse
+  /// @param begin the byte offset of the first character to tokenize
+  /// @param end the byte offset one past the last character to tokenize
+  /// @param location the source location of the byte at `begin`
+  Lexer(Source::File const* file,
+        uint32_t begin,
+        uint32_t end,
+        Source::Location location);
+  /// Creates a new Lexer that pulls its input from `stream` as it is needed,
+  /// so the full source text never has to be held in memory.
+  /// Tokens are attributed to `file`, which only needs to provide the path.
+  /// Diagnostics print source lines from `file`'s content, if it has any.
+  /// @param file the file that tokens are attributed to
+  /// @param stream the input stream to tokenize. Must outlive the Lexer.
+  Lexer(Source::File const* file, InputStream* stream);
   ~Lexer();
 
   /// Returns the next token in the input stream
@@ -56,6 +75,11 @@ class Lexer {
   Source begin_source() const;
   void end_source(Source&) const;
 
+  /// Pulls more input from the stream once the buffered input has been
+  /// consumed.
+  /// @returns true if more input was made available
+  bool fill();
+
   bool is_eof() const;
   bool is_alpha(char ch) const;
   bool is_digit(char ch) const;
@@ -65,6 +89,14 @@ class Lexer {
 
   /// The source to parse
   Source::File const* file_;
+  /// The stream to pull input from, or nullptr if reading from `file_`
+  InputStream* stream_ = nullptr;
+  /// True once `stream_` has reached the end of its input
+  bool stream_ended_ = false;
+  /// The buffered, not yet tokenized, input pulled from `stream_`
+  std::string buffer_;
+  /// The text to tokenize, either `file_`'s content or `buffer_`
+  std::string const* content_;
   /// The length of the input
   uint32_t len_ = 0;
   /// The current position within the input
@@ -14,7 +14,12 @@
 
 #include "src/reader/wgsl/lexer.h"
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -128,6 +133,82 @@ TEST_F(LexerTest, StringTest_Unterminated) {
   EXPECT_TRUE(t.IsEof());
 }
 
+/// ChunkedStream is an InputStream that splits a string into fixed size chunks
+class ChunkedStream : public InputStream {
+ public:
+  ChunkedStream(const std::string& content, size_t chunk_size)
+      : content_(content), chunk_size_(chunk_size) {}
+
+  bool Read(std::string* out) override {
+    if (pos_ >= content_.size()) {
+      return false;
+    }
+    out->append(content_, pos_, chunk_size_);
+    pos_ += chunk_size_;
+    return true;
+  }
+
+ private:
+  std::string content_;
+  size_t chunk_size_;
+  size_t pos_ = 0;
+};
+
+TEST_F(LexerTest, Stream_MatchesFile) {
+  std::string content = R"(// comment
+[[block]] struct S {
+  [[offset(0)]] a : f32;   // trailing comment
+};
+
+fn f(x : f32) -> vec4<f32> {
+  var y : i32 = -0x1F + 123 - 4u;
+
+  return vec4<f32>(x, 1.5e3, -.25, 7.);
+}
+
+  $)";
+  Source::File file("test.wgsl", content);
+  Source::File stream_file("test.wgsl", "");
+
+  for (size_t chunk_size = 1; chunk_size <= content.size(); chunk_size++) {
+    SCOPED_TRACE(chunk_size);
+    Lexer expected_lexer(&file);
+    ChunkedStream stream(content, chunk_size);
+    Lexer got_lexer(&stream_file, &stream);
+    for (;;) {
+      auto expected = expected_lexer.next();
+      auto got = got_lexer.next();
+      ASSERT_EQ(got.to_name(), expected.to_name());
+      EXPECT_EQ(got.to_str(), expected.to_str());
+      EXPECT_EQ(got.source().file, &stream_file);
+      EXPECT_EQ(got.source().range.begin.line,
+                expected.source().range.begin.line);
+      EXPECT_EQ(got.source().range.begin.column,
+                expected.source().range.begin.column);
+      EXPECT_EQ(got.source().range.end.line, expected.source().range.end.line);
+      EXPECT_EQ(got.source().range.end.column,
+                expected.source().range.end.column);
+      if (expected.IsEof()) {
+        break;
+      }
+      if (expected.IsError()) {
+        // The lexer does not advance past an invalid character.
+        EXPECT_EQ(expected.to_str(), "invalid character found");
+        break;
+      }
+    }
+  }
+}
+
+TEST_F(LexerTest, Stream_Empty) {
+  Source::File file("test.wgsl", "");
+  ChunkedStream stream("", 1);
+  Lexer l(&file, &stream);
+
+  auto t = l.next();
+  EXPECT_TRUE(t.IsEof());
+}
+
 struct FloatData {
   const char* input;
   float result;
@@ -171,7 +252,67 @@ INSTANTIATE_TEST_SUITE_P(LexerTest,
                                          FloatData{"1.2e-5", 1.2e-5f},
                                          FloatData{"2.57e23", 2.57e23f},
                                          FloatData{"2.5e+0", 2.5f},
-                                         FloatData{"2.5e-0", 2.5f}));
+                                         FloatData{"2.5e-0", 2.5f},
+                                         FloatData{"0.1", 0.1f},
+                                         FloatData{"00.5", 0.5f},
+                                         FloatData{"1.0e30", 1e30f},
+                                         FloatData{"3.4028234e38",
+                                                   3.4028234e38f},
+                                         FloatData{"1.1754944e-38",
+                                                   1.1754944e-38f},
+                                         FloatData{"0.333333333333333333333",
+                                                   0.333333333333333333333f}));
+
+TEST_F(LexerTest, FloatTest_MatchesStrtod) {
+  std::vector<std::string> literals = {
+      "0.1",
+      "-0.7",
+      "123456.789",
+      "0.000001",
+      "9007199254740993.0",
+      "1.00000000000000000001",
+      "0.30000000000000004",
+      "1.5e-7",
+      "1.5e+22",
+      "1.5e23",
+      "12345.0e-30",
+      "2.2250738585072014e-10",
+      "3.40282346638528859811704183484516925440e+38",
+      "1.401298464324817070923729583289916131280e-3",
+  };
+  // Digit strings of every length, each with the decimal point at every
+  // position and a range of exponents.
+  const std::string digits = "1234567890987654321234";
+  for (size_t len = 1; len <= digits.size(); len++) {
+    for (size_t point = 0; point <= len; point++) {
+      auto literal =
+          digits.substr(0, point) + "." + digits.substr(point, len - point);
+      for (const char* exponent : {"", "e-30", "e-5", "e3", "e21", "e25"}) {
+        literals.emplace_back(literal + exponent);
+      }
+    }
+  }
+
+  for (auto& literal : literals) {
+    SCOPED_TRACE(literal);
+    Source::File file("test.wgsl", literal);
+    Lexer l(&file);
+
+    auto t = l.next();
+    auto value = strtod(literal.c_str(), nullptr);
+    auto magnitude = std::fabs(value);
+    if (magnitude < static_cast<double>(std::numeric_limits<float>::min()) ||
+        magnitude > static_cast<double>(std::numeric_limits<float>::max())) {
+      EXPECT_TRUE(t.IsError());
+      continue;
+    }
+    ASSERT_TRUE(t.IsFloatLiteral());
+    auto expected = static_cast<float>(value);
+    auto got = t.to_f32();
+    EXPECT_EQ(memcmp(&got, &expected, sizeof(float)), 0)
+        << got << " != " << expected;
+  }
+}
 
 using FloatTest_Invalid = testing::TestWithParam<const char*>;
 TEST_P(FloatTest_Invalid, Handles) {
@@ -259,6 +400,14 @@ TEST_F(LexerTest, IntegerTest_HexSignedTooLarge) {
   EXPECT_EQ(t.to_str(), "i32 (0x80000000) too large");
 }
 
+TEST_F(LexerTest, IntegerTest_HexSignedOverflowsInt64) {
+  Source::File file("test.wgsl", "-0x800000000000000000000");
+  Lexer l(&file);
+  auto t = l.next();
+  ASSERT_TRUE(t.IsError());
+  EXPECT_EQ(t.to_str(), "i32 (-0x800000000000000000000) too small");
+}
+
 TEST_F(LexerTest, IntegerTest_HexSignedTooSmall) {
   Source::File file("test.wgsl", "-0x8000000F");
   Lexer l(&file);
@@ -383,7 +532,12 @@ TEST_P(IntegerTest_Invalid, Parses) {
 }
 INSTANTIATE_TEST_SUITE_P(LexerTest,
                          IntegerTest_Invalid,
-                         testing::Values("2147483648", "4294967296u"));
+                         testing::Values("2147483648",
+                                         "4294967296u",
+                                         "-2147483649",
+                                         "99999999999999999999999",
+                                         "-99999999999999999999999",
+                                         "-1u"));
 
 struct TokenData {
   const char* input;
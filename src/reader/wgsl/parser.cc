@@ -39,16 +39,36 @@ Program Parser::program() {
   return impl_->program();
 }
 
-Program Parse(Source::File const* file) {
-  ParserImpl parser(file);
-  parser.Parse();
-  ProgramBuilder builder = std::move(parser.builder());
+namespace {
+
+Program ParseProgram(ParserImpl* parser) {
+  parser->Parse();
+  ProgramBuilder builder = std::move(parser->builder());
   // TODO(bclayton): Remove ParserImpl::diagnostics() and put all diagnostic
   // into the builder.
-  builder.Diagnostics().add(parser.diagnostics());
+  builder.Diagnostics().add(parser->diagnostics());
   return Program(std::move(builder));
 }
 
+}  // namespace
+
+Program Parse(Source::File const* file) {
+  ParserImpl parser(file);
+  return ParseProgram(&parser);
+}
+
+Program Parse(Source::File const* file, InputStream* stream) {
+  ParserImpl parser(file, stream);
+  return ParseProgram(&parser);
+}
+
+Program ParseForReflection(Source::File const* file) {
+  ParserImpl parser(file);
+  parser.set_reflection_only(true);
+  parser.builder().SetResolveOnBuild(false);
+  return ParseProgram(&parser);
+}
+
 }  // namespace wgsl
 }  // namespace reader
 }  // namespace tint
@@ -19,6 +19,7 @@
 #include <string>
 
 #include "src/reader/reader.h"
+#include "src/reader/wgsl/input_stream.h"
 #include "src/source.h"
 
 namespace tint {
@@ -56,6 +57,28 @@ class Parser : public Reader {
 /// @returns the parsed program
 Program Parse(Source::File const* file);
 
+/// Parses the WGSL source pulled in chunks from `stream`, returning the parsed
+/// program. Only the unparsed remainder of the current line is buffered, so
+/// the source does not need to be assembled into a single string.
+/// If the source fails to parse then the returned
+/// `program.Diagnostics.contains_errors()` will be true, and the
+/// `program.Diagnostics()` will describe the error.
+/// @param file the file that the parsed program is attributed to. Its content
+/// is only used to print source lines in diagnostics, and may be empty.
+/// @param stream the source to parse
+/// @returns the parsed program
+Program Parse(Source::File const* file, InputStream* stream);
+
+/// Parses the WGSL source for reflection only, returning a program that has
+/// not been resolved and whose functions have empty bodies.
+/// Function bodies are skipped, but are scanned for the module scope
+/// variables that each function references, so the returned program can be
+/// used with inspector::Inspector to query entry points, workgroup sizes and
+/// resource bindings at a fraction of the cost of a full parse.
+/// @param file the source file
+/// @returns the parsed program
+Program ParseForReflection(Source::File const* file);
+
 }  // namespace wgsl
 }  // namespace reader
 }  // namespace tint
@@ -15,6 +15,8 @@
 #include "src/reader/wgsl/parser_impl.h"
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "src/ast/access_decoration.h"
@@ -205,6 +207,15 @@ ParserImpl::FunctionHeader& ParserImpl::FunctionHeader::operator=(
 ParserImpl::ParserImpl(Source::File const* file)
     : lexer_(std::make_unique<Lexer>(file)) {}
 
+ParserImpl::ParserImpl(Source::File const* file,
+                       uint32_t begin,
+                       uint32_t end,
+                       Source::Location location)
+    : lexer_(std::make_unique<Lexer>(file, begin, end, location)) {}
+
+ParserImpl::ParserImpl(Source::File const* file, InputStream* stream)
+    : lexer_(std::make_unique<Lexer>(file, stream)) {}
+
 ParserImpl::~ParserImpl() = default;
 
 ParserImpl::Failure::Errored ParserImpl::add_error(const Source& source,
@@ -255,19 +266,33 @@ Token ParserImpl::peek() {
 
 void ParserImpl::register_constructed(const std::string& name,
                                       type::Type* type) {
+  register_constructed(builder_.Symbols().Register(name), type);
+}
+
+void ParserImpl::register_constructed(Symbol symbol, type::Type* type) {
   assert(type);
-  registered_constructs_[name] = type;
+  registered_constructs_[symbol] = type;
 }
 
 type::Type* ParserImpl::get_constructed(const std::string& name) {
-  if (registered_constructs_.find(name) == registered_constructs_.end()) {
+  // Names that have never been registered cannot be constructed types.
+  auto symbol = builder_.Symbols().Get(name);
+  if (!symbol.IsValid()) {
     return nullptr;
   }
-  return registered_constructs_[name];
+  return get_constructed(symbol);
+}
+
+type::Type* ParserImpl::get_constructed(Symbol symbol) {
+  auto it = registered_constructs_.find(symbol);
+  return it != registered_constructs_.end() ? it->second : nullptr;
 }
 
 bool ParserImpl::Parse() {
   translation_unit();
+  if (reflection_only_ && !has_error()) {
+    resolve_skipped_body_references();
+  }
   return !has_error();
 }
 
@@ -353,8 +378,7 @@ Expect<bool> ParserImpl::expect_global_decl() {
       if (!expect("struct declaration", Token::Type::kSemicolon))
         return Failure::kErrored;
 
-      register_constructed(builder_.Symbols().NameFor(str.value->symbol()),
-                           str.value);
+      register_constructed(str.value->symbol(), str.value);
       builder_.AST().AddConstructedType(str.value);
       return true;
     }
@@ -882,9 +906,9 @@ Maybe<type::Type*> ParserImpl::type_alias() {
   if (!type.matched)
     return add_error(peek(), "invalid type alias");
 
-  auto* alias = builder_.create<type::Alias>(
-      builder_.Symbols().Register(name.value), type.value);
-  register_constructed(name.value, alias);
+  auto sym = builder_.Symbols().Register(name.value);
+  auto* alias = builder_.create<type::Alias>(sym, type.value);
+  register_constructed(sym, alias);
 
   return alias;
 }
@@ -1220,16 +1244,22 @@ Maybe<ast::Function*> ParserImpl::function_decl(ast::DecorationList& decos) {
   if (func_decos.errored)
     errored = true;
 
-  auto body = expect_body_stmt();
+  std::vector<Symbol> idents;
+  auto body = reflection_only_ ? expect_skipped_body_stmt(&idents)
+                               : expect_body_stmt();
   if (body.errored)
     errored = true;
 
   if (errored)
     return Failure::kErrored;
 
-  return create<ast::Function>(
+  auto* func = create<ast::Function>(
       header->source, builder_.Symbols().Register(header->name), header->params,
       header->return_type, body.value, func_decos.value);
+  if (reflection_only_) {
+    skipped_bodies_.emplace_back(func, std::move(idents));
+  }
+  return func;
 }
 
 // function_type_decl
@@ -1371,6 +1401,71 @@ Expect<ast::BlockStatement*> ParserImpl::expect_body_stmt() {
   });
 }
 
+Expect<ast::BlockStatement*> ParserImpl::expect_skipped_body_stmt(
+    std::vector<Symbol>* idents) {
+  return expect_brace_block("", [&]() -> Expect<ast::BlockStatement*> {
+    uint32_t depth = 0;
+    bool is_member = false;
+    for (;;) {
+      auto t = peek();
+      if (t.IsEof()) {
+        // The missing closing brace is reported by expect_brace_block().
+        break;
+      }
+      if (t.IsError()) {
+        return add_error(t, t.to_str());
+      }
+      if (t.IsBraceLeft()) {
+        depth++;
+      } else if (t.IsBraceRight()) {
+        if (depth == 0) {
+          break;
+        }
+        depth--;
+      } else if (t.IsIdentifier() && !is_member) {
+        idents->emplace_back(builder_.Symbols().Register(t.to_str()));
+      }
+      is_member = t.IsPeriod();
+      next();
+    }
+    return create<ast::BlockStatement>(Source{}, ast::StatementList{});
+  });
+}
+
+void ParserImpl::resolve_skipped_body_references() {
+  // Like the TypeDeterminer, only track module scope variables with a storage
+  // class.
+  std::unordered_map<Symbol, ast::Variable*> variables;
+  for (auto* var : builder_.AST().GlobalVariables()) {
+    if (var->storage_class() != ast::StorageClass::kNone) {
+      variables.emplace(var->symbol(), var);
+    }
+  }
+
+  // Functions can only call functions declared before them, so a callee's
+  // references are complete by the time its callers are visited.
+  std::unordered_map<Symbol, ast::Function*> functions;
+  for (auto& skipped : skipped_bodies_) {
+    auto* func = skipped.first;
+    for (auto symbol : skipped.second) {
+      auto var_it = variables.find(symbol);
+      if (var_it != variables.end()) {
+        func->add_referenced_module_variable(var_it->second);
+        func->add_local_referenced_module_variable(var_it->second);
+        continue;
+      }
+      auto func_it = functions.find(symbol);
+      if (func_it != functions.end()) {
+        // We inherit any referenced variables from the callee.
+        for (auto* var : func_it->second->referenced_module_variables()) {
+          func->add_referenced_module_variable(var);
+        }
+      }
+    }
+    functions.emplace(func->symbol(), func);
+  }
+}
+
 // paren_rhs_stmt
 //   : PAREN_LEFT logical_or_expression PAREN_RIGHT
 Expect<ast::Expression*> ParserImpl::expect_paren_rhs_stmt() {
@@ -2071,10 +2166,12 @@ Maybe<ast::Expression*> ParserImpl::primary_expression() {
     return create<ast::BitcastExpression>(source, type.value, params.value);
   }
 
-  if (t.IsIdentifier() && !get_constructed(t.to_str())) {
-    next();
-    return create<ast::IdentifierExpression>(
-        t.source(), builder_.Symbols().Register(t.to_str()));
+  if (t.IsIdentifier()) {
+    auto sym = builder_.Symbols().Register(t.to_str());
+    if (!get_constructed(sym)) {
+      next();
+      return create<ast::IdentifierExpression>(t.source(), sym);
+    }
   }
 
   auto type = type_decl();
@@ -53,6 +53,7 @@
 #include "src/diagnostic/diagnostic.h"
 #include "src/diagnostic/formatter.h"
 #include "src/program_builder.h"
+#include "src/reader/wgsl/input_stream.h"
 #include "src/reader/wgsl/parser_impl_detail.h"
 #include "src/reader/wgsl/token.h"
 #include "src/type/storage_texture_type.h"
@@ -277,6 +278,20 @@ class ParserImpl {
   /// Creates a new parser using the given file
   /// @param file the input source file to parse
   explicit ParserImpl(Source::File const* file);
+  /// Creates a new parser that only parses the byte range [begin, end) of
+  /// `file`.
+  /// @param file the input source file to parse
+  /// @param begin the byte offset of the first character to parse
+  /// @param end the byte offset one past the last character to parse
+  /// @param location the source location of the byte at `begin`
+  ParserImpl(Source::File const* file,
+             uint32_t begin,
+             uint32_t end,
+             Source::Location location);
+  /// Creates a new parser that pulls its input from `stream`
+  /// @param file the file that parsed nodes are attributed to
+  /// @param stream the input stream to parse. Must outlive the parser.
+  ParserImpl(Source::File const* file, InputStream* stream);
   ~ParserImpl();
 
   /// Run the parser
@@ -292,6 +307,15 @@ class ParserImpl {
   /// parsing.
   size_t get_max_errors() const { return max_errors_; }
 
+  /// Enables reflection-only parsing. When enabled, function bodies are not
+  /// parsed into statements. Instead they are brace-matched and scanned for
+  /// identifiers, which are used to populate each function's
+  /// referenced_module_variables() once the module has been parsed.
+  /// The identifier scan does not know about scoping, so a function may
+  /// report variables that are shadowed by a local of the same name.
+  /// @param enable true to enable reflection-only parsing
+  void set_reflection_only(bool enable) { reflection_only_ = enable; }
+
   /// @returns true if an error was encountered.
   bool has_error() const { return diags_.contains_errors(); }
 
@@ -350,10 +374,18 @@ class ParserImpl {
   /// @param name the constructed name
   /// @param type the constructed type
   void register_constructed(const std::string& name, type::Type* type);
+  /// Registers a constructed type into the parser
+  /// @param symbol the symbol of the constructed name
+  /// @param type the constructed type
+  void register_constructed(Symbol symbol, type::Type* type);
   /// Retrieves a constructed type
   /// @param name The name to lookup
   /// @returns the constructed type for `name` or `nullptr` if not found
   type::Type* get_constructed(const std::string& name);
+  /// Retrieves a constructed type
+  /// @param symbol The symbol of the name to lookup
+  /// @returns the constructed type for `symbol` or `nullptr` if not found
+  type::Type* get_constructed(Symbol symbol);
 
   /// Parses the `translation_unit` grammar element
   void translation_unit();
@@ -815,6 +847,16 @@ class ParserImpl {
 
   Expect<type::Type*> expect_type(const std::string& use);
 
+  /// Skips over a function body in reflection-only mode.
+  /// @param idents the identifiers used in the body, excluding member names,
+  /// are appended to this list
+  /// @returns an empty block statement, or an error
+  Expect<ast::BlockStatement*> expect_skipped_body_stmt(
+      std::vector<Symbol>* idents);
+  /// Populates the referenced module variables of the functions whose bodies
+  /// were skipped in reflection-only mode.
+  void resolve_skipped_body_references();
+
   Maybe<ast::Statement*> non_block_statement();
   Maybe<ast::Statement*> for_header_initializer();
   Maybe<ast::Statement*> for_header_continuing();
@@ -834,9 +876,11 @@ class ParserImpl {
   bool synchronized_ = true;
   std::vector<Token::Type> sync_tokens_;
   int silence_errors_ = 0;
-  std::unordered_map<std::string, type::Type*> registered_constructs_;
+  std::unordered_map<Symbol, type::Type*> registered_constructs_;
   ProgramBuilder builder_;
   size_t max_errors_ = 25;
+  bool reflection_only_ = false;
+  std::vector<std::pair<ast::Function*, std::vector<Symbol>>> skipped_bodies_;
 };
 
 }  // namespace wgsl
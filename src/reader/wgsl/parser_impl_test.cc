@@ -14,9 +14,12 @@
 
 #include "src/reader/wgsl/parser_impl.h"
 
+#include <string>
+
 #include "gtest/gtest.h"
 #include "src/reader/wgsl/parser_impl_test_helper.h"
 #include "src/type/i32_type.h"
+#include "src/type/struct_type.h"
 
 namespace tint {
 namespace reader {
@@ -64,12 +67,56 @@ TEST_F(ParserImplTest, GetRegisteredType) {
   ASSERT_EQ(alias, ty.i32());
 }
 
+TEST_F(ParserImplTest, GetRegisteredTypeBySymbol) {
+  auto p = parser("");
+  auto sym = p->builder().Symbols().Register("my_alias");
+  p->register_constructed(sym, ty.i32());
+
+  EXPECT_EQ(p->get_constructed(sym), ty.i32());
+  EXPECT_EQ(p->get_constructed("my_alias"), ty.i32());
+}
+
 TEST_F(ParserImplTest, GetUnregisteredType) {
   auto p = parser("");
   auto* alias = p->get_constructed("my_alias");
   ASSERT_EQ(alias, nullptr);
 }
 
+TEST_F(ParserImplTest, GetUnregisteredTypeWithRegisteredSymbol) {
+  auto p = parser("");
+  auto sym = p->builder().Symbols().Register("my_alias");
+  EXPECT_EQ(p->get_constructed(sym), nullptr);
+  EXPECT_EQ(p->get_constructed("my_alias"), nullptr);
+}
+
+TEST_F(ParserImplTest, ManyConstructedTypes) {
+  std::string src = "struct S0 { a : f32; };\n";
+  for (int i = 1; i < 100; i++) {
+    auto prev = "S" + std::to_string(i - 1);
+    auto cur = "S" + std::to_string(i);
+    src += "type A" + std::to_string(i) + " = " + prev + ";\n";
+    src += "struct " + cur + " { a : " + prev + "; b : A" +
+           std::to_string(i) + "; };\n";
+  }
+  auto p = parser(src);
+  ASSERT_TRUE(p->Parse()) << p->error();
+
+  auto& types = p->builder().AST().ConstructedTypes();
+  ASSERT_EQ(types.size(), 199u);
+  for (int i = 1; i < 100; i++) {
+    auto* alias = p->get_constructed("A" + std::to_string(i));
+    auto* cur = p->get_constructed("S" + std::to_string(i));
+    auto* prev = p->get_constructed("S" + std::to_string(i - 1));
+    ASSERT_NE(alias, nullptr);
+    ASSERT_NE(cur, nullptr);
+    ASSERT_TRUE(cur->Is<type::Struct>());
+    auto& members = cur->As<type::Struct>()->impl()->members();
+    ASSERT_EQ(members.size(), 2u);
+    EXPECT_EQ(members[0]->type(), prev);
+    EXPECT_EQ(members[1]->type(), alias);
+  }
+}
+
 }  // namespace
 }  // namespace wgsl
 }  // namespace reader
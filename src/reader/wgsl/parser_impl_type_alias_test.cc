@@ -44,7 +44,7 @@ TEST_F(ParserImplTest, TypeDecl_ParsesType) {
 TEST_F(ParserImplTest, TypeDecl_ParsesStruct_Ident) {
   auto p = parser("type a = B");
 
-  type::Struct str(p->builder().Symbols().Get("B"), {});
+  type::Struct str(p->builder().Symbols().Register("B"), {});
   p->register_constructed("B", &str);
 
   auto t = p->type_alias();
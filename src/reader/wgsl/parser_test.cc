@@ -14,9 +14,13 @@
 
 #include "src/reader/wgsl/parser.h"
 
+#include <string>
+
 #include "gtest/gtest.h"
 
 #include "src/ast/module.h"
+#include "src/demangler.h"
+#include "src/inspector/inspector.h"
 
 namespace tint {
 namespace reader {
@@ -25,6 +29,27 @@ namespace {
 
 using ParserTest = testing::Test;
 
+/// LineStream is an InputStream that yields one line per Read()
+class LineStream : public InputStream {
+ public:
+  explicit LineStream(const std::string& content) : content_(content) {}
+
+  bool Read(std::string* out) override {
+    if (pos_ >= content_.size()) {
+      return false;
+    }
+    auto end = content_.find('\n', pos_);
+    end = end == std::string::npos ? content_.size() : end + 1;
+    out->append(content_, pos_, end - pos_);
+    pos_ = end;
+    return true;
+  }
+
+ private:
+  std::string content_;
+  size_t pos_ = 0;
+};
+
 TEST_F(ParserTest, EmptyOld) {
   Source::File file("test.wgsl", "");
   Parser p(&file);
@@ -102,6 +127,199 @@ fn main() ->  {  // missing return type
 )");
 }
 
+TEST_F(ParserTest, ParsesStream) {
+  std::string content = R"(
+[[location(0)]] var<out> gl_FragColor : vec4<f32>;
+
+fn color() -> vec4<f32> {
+  return vec4<f32>(.4, .2, .3, 1.);
+}
+)";
+  // The stream is a generated prelude followed by the main shader.
+  for (int i = 0; i < 10; i++) {
+    content += "const c" + std::to_string(i) + " : f32 = " +
+               std::to_string(i) + ".5;\n";
+  }
+  content += R"(
+[[stage(vertex)]]
+fn main() -> void {
+  gl_FragColor = color();
+}
+)";
+
+  Source::File file("test.wgsl", content);
+  auto expected = Parse(&file);
+
+  Source::File stream_file("test.wgsl", "");
+  LineStream stream(content);
+  auto program = Parse(&stream_file, &stream);
+  auto errs = diag::Formatter().format(program.Diagnostics());
+  ASSERT_TRUE(program.IsValid()) << errs;
+
+  ASSERT_EQ(2u, program.AST().Functions().size());
+  ASSERT_EQ(11u, program.AST().GlobalVariables().size());
+  EXPECT_EQ(Demangler().Demangle(program), Demangler().Demangle(expected));
+
+  auto* main = program.AST().Functions()[1];
+  EXPECT_EQ(main->source().file, &stream_file);
+  EXPECT_EQ(main->source().range.begin.line, 19u);
+}
+
+TEST_F(ParserTest, HandlesErrorStream) {
+  Source::File file("test.wgsl", "");
+  LineStream stream(R"(
+fn main() ->  {  // missing return type
+  return;
+})");
+
+  auto program = Parse(&file, &stream);
+  auto errs = diag::Formatter().format(program.Diagnostics());
+  ASSERT_FALSE(program.IsValid()) << errs;
+  EXPECT_EQ(errs,
+            R"(test.wgsl:2:15 error: unable to determine function return type
+
+)");
+}
+
+TEST_F(ParserTest, ParseForReflection) {
+  Source::File file("test.wgsl", R"(
+[[location(0)]] var<in> a_pos : vec2<f32>;
+[[location(1)]] var<in> a_unused : vec2<f32>;
+[[builtin(position)]] var<out> gl_Position : vec4<f32>;
+[[location(0)]] var<out> frag_color : vec4<f32>;
+
+[[block]] struct Params {
+  [[offset(0)]] scale : f32;
+  [[offset(4)]] count : u32;
+};
+
+[[block]] struct Particles {
+  [[offset(0)]] pos : [[stride(8)]] array<vec2<f32>, 4>;
+};
+
+[[binding(0), group(0)]] var<uniform> params : [[access(read)]] Params;
+[[binding(1), group(0)]] var<storage> src : [[access(read)]] Particles;
+[[binding(2), group(1)]] var<storage> dst : [[access(read_write)]] Particles;
+
+fn scale(v : vec2<f32>) -> vec2<f32> {
+  return v * params.scale;
+}
+
+[[stage(vertex)]]
+fn vert_main() -> void {
+  gl_Position = vec4<f32>(scale(a_pos), 0.0, 1.0);
+}
+
+[[stage(fragment)]]
+fn frag_main() -> void {
+  var c : f32 = 1.0;
+  frag_color = vec4<f32>(c, 1.0, 1.0, 1.0);
+}
+
+[[stage(compute), workgroup_size(4, 2)]]
+fn comp_main() -> void {
+  for (var i : i32 = 0; i < 4; i = i + 1) {
+    if (i > 1) {
+      dst.pos[i] = scale(src.pos[i]);
+    }
+  }
+}
+)");
+
+  auto expected = Parse(&file);
+  ASSERT_TRUE(expected.IsValid())
+      << diag::Formatter().format(expected.Diagnostics());
+  auto program = ParseForReflection(&file);
+  ASSERT_TRUE(program.IsValid())
+      << diag::Formatter().format(program.Diagnostics());
+
+  for (auto* func : program.AST().Functions()) {
+    EXPECT_TRUE(func->body()->empty());
+  }
+
+  inspector::Inspector expected_inspector(&expected);
+  inspector::Inspector inspector(&program);
+  auto expected_eps = expected_inspector.GetEntryPoints();
+  auto eps = inspector.GetEntryPoints();
+  ASSERT_EQ(eps.size(), 3u);
+  ASSERT_EQ(eps.size(), expected_eps.size());
+
+  auto same_vars = [](const std::vector<inspector::StageVariable>& got,
+                      const std::vector<inspector::StageVariable>& expected) {
+    ASSERT_EQ(got.size(), expected.size());
+    for (size_t i = 0; i < got.size(); i++) {
+      EXPECT_EQ(got[i].name, expected[i].name);
+      EXPECT_EQ(got[i].location_decoration, expected[i].location_decoration);
+    }
+  };
+  auto same_bindings = [](const std::vector<inspector::ResourceBinding>& got,
+                          const std::vector<inspector::ResourceBinding>&
+                              expected) {
+    ASSERT_EQ(got.size(), expected.size());
+    for (size_t i = 0; i < got.size(); i++) {
+      EXPECT_EQ(got[i].bind_group, expected[i].bind_group);
+      EXPECT_EQ(got[i].binding, expected[i].binding);
+      EXPECT_EQ(got[i].min_buffer_binding_size,
+                expected[i].min_buffer_binding_size);
+    }
+  };
+
+  for (size_t i = 0; i < eps.size(); i++) {
+    auto& ep = eps[i];
+    SCOPED_TRACE(ep.name);
+    EXPECT_EQ(ep.name, expected_eps[i].name);
+    EXPECT_EQ(ep.stage, expected_eps[i].stage);
+    EXPECT_EQ(ep.workgroup_size(), expected_eps[i].workgroup_size());
+    same_vars(ep.input_variables, expected_eps[i].input_variables);
+    same_vars(ep.output_variables, expected_eps[i].output_variables);
+    same_bindings(inspector.GetUniformBufferResourceBindings(ep.name),
+                  expected_inspector.GetUniformBufferResourceBindings(ep.name));
+    same_bindings(
+        inspector.GetStorageBufferResourceBindings(ep.name),
+        expected_inspector.GetStorageBufferResourceBindings(ep.name));
+    same_bindings(
+        inspector.GetReadOnlyStorageBufferResourceBindings(ep.name),
+        expected_inspector.GetReadOnlyStorageBufferResourceBindings(ep.name));
+  }
+}
+
+TEST_F(ParserTest, ParseForReflection_ShadowedVariable) {
+  Source::File file("test.wgsl", R"(
+[[location(0)]] var<in> a : f32;
+
+[[stage(fragment)]]
+fn main() -> void {
+  var a : f32 = 1.0;
+}
+)");
+
+  auto program = ParseForReflection(&file);
+  ASSERT_TRUE(program.IsValid())
+      << diag::Formatter().format(program.Diagnostics());
+
+  // The identifier scan does not know about scoping, so the local `a` is
+  // reported as a reference to the module scope variable.
+  inspector::Inspector inspector(&program);
+  auto eps = inspector.GetEntryPoints();
+  ASSERT_EQ(eps.size(), 1u);
+  ASSERT_EQ(eps[0].input_variables.size(), 1u);
+  EXPECT_EQ(eps[0].input_variables[0].name, "a");
+}
+
+TEST_F(ParserTest, ParseForReflection_UnterminatedBody) {
+  Source::File file("test.wgsl", R"(
+fn main() -> void {
+  if (true) {
+)");
+
+  auto program = ParseForReflection(&file);
+  auto errs = diag::Formatter().format(program.Diagnostics());
+  ASSERT_FALSE(program.IsValid()) << errs;
+  EXPECT_EQ(errs, R"(test.wgsl:4:1 error: expected '}'
+
+)");
+}
+
 }  // namespace
 }  // namespace wgsl
 }  // namespace reader
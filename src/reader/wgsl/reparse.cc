@@ -0,0 +1,369 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/reader/wgsl/reparse.h"
+
+#include <cctype>
+#include <limits>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "src/clone_context.h"
+#include "src/program_builder.h"
+#include "src/reader/wgsl/parser.h"
+#include "src/reader/wgsl/parser_impl.h"
+#include "src/type/alias_type.h"
+#include "src/type/struct_type.h"
+
+namespace tint {
+namespace reader {
+namespace wgsl {
+namespace {
+
+/// DeclKind is the kind of AST node produced by a top-level declaration.
+enum class DeclKind {
+  kNone,
+  kConstructedType,
+  kGlobalVariable,
+  kFunction,
+};
+
+/// Decl is the byte range of a single top-level declaration.
+struct Decl {
+  size_t begin;
+  size_t end;
+  DeclKind kind;
+};
+
+/// Counts holds the number of AST nodes of each kind produced by a range of
+/// declarations.
+struct Counts {
+  size_t types = 0;
+  size_t globals = 0;
+  size_t functions = 0;
+
+  void Add(DeclKind kind) {
+    switch (kind) {
+      case DeclKind::kConstructedType:
+        types++;
+        break;
+      case DeclKind::kGlobalVariable:
+        globals++;
+        break;
+      case DeclKind::kFunction:
+        functions++;
+        break;
+      case DeclKind::kNone:
+        break;
+    }
+  }
+};
+
+bool is_ident_char(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/// @returns the offset of the first character at or after `pos` that is not
+/// whitespace or part of a line comment.
+size_t skip_trivia(const std::string& str, size_t pos) {
+  while (pos < str.size()) {
+    if (std::isspace(static_cast<unsigned char>(str[pos]))) {
+      pos++;
+    } else if (str.compare(pos, 2, "//") == 0) {
+      while (pos < str.size() && str[pos] != '\n') {
+        pos++;
+      }
+    } else {
+      break;
+    }
+  }
+  return pos;
+}
+
+/// @returns the kind of the declaration starting at `pos`
+DeclKind kind_of(const std::string& str, size_t pos) {
+  // Skip over any leading decorations.
+  for (;;) {
+    pos = skip_trivia(str, pos);
+    if (str.compare(pos, 2, "[[") != 0) {
+      break;
+    }
+    pos = str.find("]]", pos + 2);
+    if (pos == std::string::npos) {
+      return DeclKind::kNone;
+    }
+    pos += 2;
+  }
+
+  auto end = pos;
+  while (end < str.size() && is_ident_char(str[end])) {
+    end++;
+  }
+  auto is = [&](const char* keyword) {
+    return str.compare(pos, end - pos, keyword) == 0;
+  };
+  if (is("fn")) {
+    return DeclKind::kFunction;
+  }
+  if (is("var") || is("const")) {
+    return DeclKind::kGlobalVariable;
+  }
+  if (is("type") || is("struct")) {
+    return DeclKind::kConstructedType;
+  }
+  return DeclKind::kNone;
+}
+
+/// Splits `str` into its top-level declarations without tokenizing it.
+/// A declaration ends with a semicolon outside of any braces, or with the
+/// closing brace of its outermost brace pair (and an optional semicolon).
+std::vector<Decl> split_decls(const std::string& str) {
+  std::vector<Decl> decls;
+  auto pos = skip_trivia(str, 0);
+  while (pos < str.size()) {
+    Decl decl{pos, str.size(), kind_of(str, pos)};
+    int depth = 0;
+    while (pos < str.size()) {
+      char c = str[pos];
+      if (str.compare(pos, 2, "//") == 0) {
+        pos = skip_trivia(str, pos);
+        continue;
+      }
+      pos++;
+      if (c == '"') {
+        pos = str.find('"', pos);
+        pos = pos == std::string::npos ? str.size() : pos + 1;
+      } else if (c == '{') {
+        depth++;
+      } else if (c == '}') {
+        if (--depth <= 0) {
+          auto next = skip_trivia(str, pos);
+          if (next < str.size() && str[next] == ';') {
+            pos = next + 1;
+          }
+          break;
+        }
+      } else if (c == ';' && depth <= 0) {
+        break;
+      }
+    }
+    decl.end = pos;
+    decls.emplace_back(decl);
+    pos = skip_trivia(str, pos);
+  }
+  return decls;
+}
+
+/// @returns the location of the byte at `to`, given that `loc` is the location
+/// of the byte at `from`.
+Source::Location advance(Source::Location loc,
+                         const std::string& str,
+                         size_t from,
+                         size_t to) {
+  for (auto i = from; i < to; i++) {
+    if (str[i] == '\n') {
+      loc.line++;
+      loc.column = 1;
+    } else {
+      loc.column++;
+    }
+  }
+  return loc;
+}
+
+bool is_before(const Source::Location& a, const Source::Location& b) {
+  return a.line < b.line || (a.line == b.line && a.column < b.column);
+}
+
+Symbol symbol_of(type::Type* ty) {
+  if (auto* alias = ty->As<type::Alias>()) {
+    return alias->symbol();
+  }
+  if (auto* str = ty->As<type::Struct>()) {
+    return str->symbol();
+  }
+  return Symbol();
+}
+
+}  // namespace
+
+Program Reparse(const Program& program,
+                Source::File const* original,
+                Source::File const* file,
+                const TextEdit& edit) {
+  const auto& old_content = original->content;
+  const auto& new_content = file->content;
+
+  if (!program.IsValid() || edit.offset > old_content.size() ||
+      edit.length > old_content.size() - edit.offset ||
+      new_content.size() !=
+          old_content.size() - edit.length + edit.replacement.size() ||
+      new_content.size() > std::numeric_limits<uint32_t>::max()) {
+    return Parse(file);
+  }
+
+  auto old_edit_end = edit.offset + edit.length;
+  auto new_edit_end = edit.offset + edit.replacement.size();
+
+  auto old_decls = split_decls(old_content);
+  auto new_decls = split_decls(new_content);
+
+  // Count the unchanged declarations before the edit...
+  size_t prefix = 0;
+  while (prefix < old_decls.size() && prefix < new_decls.size()) {
+    auto& o = old_decls[prefix];
+    auto& n = new_decls[prefix];
+    if (o.end >= edit.offset || n.begin != o.begin || n.end != o.end ||
+        n.kind != o.kind) {
+      break;
+    }
+    prefix++;
+  }
+
+  // ... and after the edit.
+  size_t suffix = 0;
+  while (prefix + suffix < old_decls.size() &&
+         prefix + suffix < new_decls.size()) {
+    auto& o = old_decls[old_decls.size() - suffix - 1];
+    auto& n = new_decls[new_decls.size() - suffix - 1];
+    if (o.begin <= old_edit_end ||
+        n.begin != o.begin - old_edit_end + new_edit_end ||
+        n.end - n.begin != o.end - o.begin || n.kind != o.kind) {
+      break;
+    }
+    suffix++;
+  }
+
+  // Map the old declarations to the nodes of the module.
+  Counts before, edited, after;
+  for (size_t i = 0; i < old_decls.size(); i++) {
+    if (i < prefix) {
+      before.Add(old_decls[i].kind);
+    } else if (i < old_decls.size() - suffix) {
+      edited.Add(old_decls[i].kind);
+    } else {
+      after.Add(old_decls[i].kind);
+    }
+  }
+
+  auto& types = program.AST().ConstructedTypes();
+  auto& globals = program.AST().GlobalVariables();
+  auto& functions = program.AST().Functions();
+  if (before.types + edited.types + after.types != types.size() ||
+      before.globals + edited.globals + after.globals != globals.size() ||
+      before.functions + edited.functions + after.functions !=
+          functions.size()) {
+    return Parse(file);
+  }
+
+  auto begin = prefix > 0 ? new_decls[prefix - 1].end : 0;
+  auto end = suffix > 0 ? new_decls[new_decls.size() - suffix].begin
+                        : new_content.size();
+
+  auto edit_begin = advance({1, 1}, old_content, 0, edit.offset);
+  auto old_end = advance(edit_begin, old_content, edit.offset, old_edit_end);
+  auto new_end = advance(edit_begin, new_content, edit.offset, new_edit_end);
+
+  ParserImpl parser(file, static_cast<uint32_t>(begin),
+                    static_cast<uint32_t>(end),
+                    advance({1, 1}, new_content, 0, begin));
+  auto& builder = parser.builder();
+
+  auto remap = [&](Source::Location loc) {
+    if (loc.line == 0 || is_before(loc, edit_begin)) {
+      return loc;
+    }
+    if (loc.line == old_end.line) {
+      loc.column = loc.column - old_end.column + new_end.column;
+    }
+    loc.line = loc.line - old_end.line + new_end.line;
+    return loc;
+  };
+
+  CloneContext ctx(&builder, &program);
+  ctx.ReplaceSources([&](const Source& in) {
+    if (in.file != original) {
+      return in;
+    }
+    return Source{Source::Range{remap(in.range.begin), remap(in.range.end)},
+                  file};
+  });
+
+  // Clone the declarations before the edit.
+  for (size_t i = 0; i < before.types; i++) {
+    auto* ty = ctx.Clone(types[i]);
+    builder.AST().AddConstructedType(ty);
+    parser.register_constructed(symbol_of(ty), ty);
+  }
+  for (size_t i = 0; i < before.globals; i++) {
+    builder.AST().AddGlobalVariable(ctx.Clone(globals[i]));
+  }
+  for (size_t i = 0; i < before.functions; i++) {
+    builder.AST().Functions().Add(ctx.Clone(functions[i]));
+  }
+
+  // Parse the edited declarations. Errors may resynchronize the parser
+  // differently to a full parse, so let the full parse report them.
+  if (!parser.Parse()) {
+    return Parse(file);
+  }
+
+  // A re-parsed type that shadows an unchanged type changes which type the
+  // unchanged declarations refer to.
+  std::unordered_set<std::string> unchanged_types;
+  for (size_t i = 0; i < types.size(); i++) {
+    if (i < before.types || i >= types.size() - after.types) {
+      unchanged_types.emplace(program.Symbols().NameFor(symbol_of(types[i])));
+    }
+  }
+  auto& parsed_types = builder.AST().ConstructedTypes();
+  for (size_t i = before.types; i < parsed_types.size(); i++) {
+    auto name = builder.Symbols().NameFor(symbol_of(parsed_types[i]));
+    if (unchanged_types.count(name)) {
+      return Parse(file);
+    }
+  }
+
+  // The declarations after the edit may reference the re-parsed types. If a
+  // type was removed or renamed then a full parse is needed to report the
+  // error.
+  for (size_t i = before.types; i < before.types + edited.types; i++) {
+    auto name = program.Symbols().NameFor(symbol_of(types[i]));
+    auto* replacement = parser.get_constructed(name);
+    if (replacement == nullptr) {
+      return Parse(file);
+    }
+    ctx.Replace(types[i], replacement);
+  }
+
+  // Clone the declarations after the edit.
+  for (size_t i = types.size() - after.types; i < types.size(); i++) {
+    builder.AST().AddConstructedType(ctx.Clone(types[i]));
+  }
+  for (size_t i = globals.size() - after.globals; i < globals.size(); i++) {
+    builder.AST().AddGlobalVariable(ctx.Clone(globals[i]));
+  }
+  for (size_t i = functions.size() - after.functions; i < functions.size();
+       i++) {
+    builder.AST().Functions().Add(ctx.Clone(functions[i]));
+  }
+
+  return Program(std::move(builder));
+}
+
+}  // namespace wgsl
+}  // namespace reader
+}  // namespace tint
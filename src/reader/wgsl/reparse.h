@@ -0,0 +1,63 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_READER_WGSL_REPARSE_H_
+#define SRC_READER_WGSL_REPARSE_H_
+
+#include <string>
+
+#include "src/program.h"
+#include "src/source.h"
+
+namespace tint {
+namespace reader {
+namespace wgsl {
+
+/// TextEdit describes the replacement of a byte range of a source file.
+struct TextEdit {
+  /// The byte offset of the first replaced character in the original file
+  size_t offset = 0;
+  /// The number of bytes replaced in the original file
+  size_t length = 0;
+  /// The text that replaces the range
+  std::string replacement;
+};
+
+/// Reparses `file`, which is `original` with `edit` applied.
+///
+/// Only the top-level declarations touched by `edit` are re-lexed and
+/// re-parsed. The declarations before and after the edit are cloned from
+/// `program`, with their sources moved to `file`.
+///
+/// If the edit cannot be applied incrementally, for example because `program`
+/// has errors, the edited declarations fail to parse, or the edit changes how
+/// the following declarations are split, then `file` is parsed in full.
+/// Either way the returned program is equivalent to `Parse(file)`.
+///
+/// @param program the program that was parsed from `original`
+/// @param original the source file that `program` was parsed from. Must
+/// outlive `program`.
+/// @param file the source file with `edit` applied to `original`
+/// @param edit the edit that was applied to `original`
+/// @returns the parsed program
+Program Reparse(const Program& program,
+                Source::File const* original,
+                Source::File const* file,
+                const TextEdit& edit);
+
+}  // namespace wgsl
+}  // namespace reader
+}  // namespace tint
+
+#endif  // SRC_READER_WGSL_REPARSE_H_
@@ -0,0 +1,220 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/reader/wgsl/reparse.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "src/ast/module.h"
+#include "src/demangler.h"
+#include "src/diagnostic/formatter.h"
+#include "src/program_builder.h"
+#include "src/reader/wgsl/parser.h"
+#include "src/type_determiner.h"
+
+namespace tint {
+namespace reader {
+namespace wgsl {
+namespace {
+
+constexpr const char* kShader = R"(type Arr = [[stride(16)]] array<f32, 4>;
+
+[[block]]
+struct Uniforms {
+  [[offset(0)]] scale : f32;
+  [[offset(16)]] values : Arr;
+};
+
+[[binding(0), group(0)]] var<uniform> uniforms : Uniforms;
+[[location(0)]] var<out> frag_color : vec4<f32>;
+
+fn scaled(v : f32) -> f32 {
+  return v * uniforms.scale;
+}
+
+// A helper
+fn sum() -> f32 {
+  var total : f32 = 0.0;
+  for (var i : i32 = 0; i < 4; i = i + 1) {
+    total = total + scaled(uniforms.values[i]);
+  }
+  return total;
+}
+
+struct Unused {
+  a : i32;
+};
+
+[[stage(fragment)]]
+fn main() -> void {
+  frag_color = vec4<f32>(sum(), 0.0, 0.0, 1.0);
+}
+)";
+
+class ReparseTest : public testing::Test {
+ public:
+  /// Checks that reparsing `original` after `edit` gives the same program as a
+  /// full parse of the edited source.
+  void Check(const std::string& original, const TextEdit& edit) {
+    auto content = original;
+    content.replace(edit.offset, edit.length, edit.replacement);
+
+    Source::File old_file("test.wgsl", original);
+    Source::File new_file("test.wgsl", content);
+
+    auto old_program = Parse(&old_file);
+    auto expected = Parse(&new_file);
+    auto got = Reparse(old_program, &old_file, &new_file, edit);
+
+    SCOPED_TRACE(content);
+    diag::Formatter formatter;
+    EXPECT_EQ(got.IsValid(), expected.IsValid());
+    EXPECT_EQ(formatter.format(got.Diagnostics()),
+              formatter.format(expected.Diagnostics()));
+    if (!Resolves(expected)) {
+      // The TypeDeterminer stops at the first error, so the ASTs of programs
+      // that fail to resolve depend on how far it got.
+      return;
+    }
+    EXPECT_EQ(Demangler().Demangle(got), Demangler().Demangle(expected));
+
+    auto& got_funcs = got.AST().Functions();
+    auto& expected_funcs = expected.AST().Functions();
+    ASSERT_EQ(got_funcs.size(), expected_funcs.size());
+    for (size_t i = 0; i < got_funcs.size(); i++) {
+      ExpectSameSource(got_funcs[i]->source(), expected_funcs[i]->source());
+      ExpectSameSource(got_funcs[i]->body()->source(),
+                       expected_funcs[i]->body()->source());
+    }
+
+    auto& got_vars = got.AST().GlobalVariables();
+    auto& expected_vars = expected.AST().GlobalVariables();
+    ASSERT_EQ(got_vars.size(), expected_vars.size());
+    for (size_t i = 0; i < got_vars.size(); i++) {
+      ExpectSameSource(got_vars[i]->source(), expected_vars[i]->source());
+    }
+  }
+
+  bool Resolves(const Program& program) {
+    auto builder = program.CloneAsBuilder();
+    return TypeDeterminer(&builder).Determine();
+  }
+
+  void ExpectSameSource(const Source& got, const Source& expected) {
+    EXPECT_EQ(got.file, expected.file);
+    EXPECT_EQ(got.range.begin.line, expected.range.begin.line);
+    EXPECT_EQ(got.range.begin.column, expected.range.begin.column);
+    EXPECT_EQ(got.range.end.line, expected.range.end.line);
+    EXPECT_EQ(got.range.end.column, expected.range.end.column);
+  }
+
+  /// @returns the byte offset of `what` in kShader
+  size_t OffsetOf(const std::string& what) {
+    auto offset = std::string(kShader).find(what);
+    EXPECT_NE(offset, std::string::npos) << what;
+    return offset;
+  }
+};
+
+TEST_F(ReparseTest, EditFunctionBody) {
+  Check(kShader, {OffsetOf("v * uniforms"), 1, "(v + 1.0)"});
+}
+
+TEST_F(ReparseTest, InsertLinesInFunctionBody) {
+  Check(kShader, {OffsetOf("return total;"), 0,
+                  "total = total * 2.0;\n  total = total + 1.0;\n  "});
+}
+
+TEST_F(ReparseTest, RemoveLinesFromFunctionBody) {
+  auto begin = OffsetOf("  for (var i");
+  auto end = OffsetOf("  return total;");
+  Check(kShader, {begin, end - begin, ""});
+}
+
+TEST_F(ReparseTest, EditStructReferencedLater) {
+  Check(kShader, {OffsetOf("scale : f32"), 5, "factor"});
+}
+
+TEST_F(ReparseTest, AddStructMember) {
+  Check(kShader,
+        {OffsetOf("  [[offset(16)]] values"), 0, "  [[offset(4)]] b : i32;\n"});
+}
+
+TEST_F(ReparseTest, RenameStructUsedLater) {
+  Check(kShader, {OffsetOf("Uniforms {"), 8, "Renamed"});
+}
+
+TEST_F(ReparseTest, EditAlias) {
+  Check(kShader, {OffsetOf("f32, 4>"), 3, "i32"});
+}
+
+TEST_F(ReparseTest, InsertDeclaration) {
+  Check(kShader, {OffsetOf("// A helper"), 0,
+                  "fn helper() -> i32 {\n  return 1;\n}\n\n"});
+}
+
+TEST_F(ReparseTest, RemoveDeclaration) {
+  auto begin = OffsetOf("struct Unused");
+  auto end = OffsetOf("[[stage(fragment)]]");
+  Check(kShader, {begin, end - begin, ""});
+}
+
+TEST_F(ReparseTest, ShadowUnchangedType) {
+  Check(kShader, {OffsetOf("struct Unused"), 13, "struct Uniforms"});
+}
+
+TEST_F(ReparseTest, EditIntroducesError) {
+  Check(kShader, {OffsetOf("return total;"), 0, "return"});
+}
+
+TEST_F(ReparseTest, EditFixesError) {
+  std::string broken = kShader;
+  broken.replace(OffsetOf("return total;"), 0, "return");
+  Check(broken, {OffsetOf("return total;"), 6, ""});
+}
+
+TEST_F(ReparseTest, UnbalancedBrace) {
+  Check(kShader, {OffsetOf("fn sum() -> f32 {") + 17, 0, "{"});
+}
+
+TEST_F(ReparseTest, CommentOutDeclarations) {
+  Check(kShader, {OffsetOf("\nstruct Unused"), 1, "\n//"});
+}
+
+TEST_F(ReparseTest, EveryOffset) {
+  std::string shader = R"(struct S {
+  a : f32;
+};
+fn f() -> S {
+  var s : S;
+  return s;
+}
+fn g() -> f32 {
+  return f().a;
+}
+)";
+  for (size_t offset = 0; offset <= shader.size(); offset++) {
+    Check(shader, {offset, 0, " "});
+    Check(shader, {offset, 0, "\n"});
+    if (offset < shader.size()) {
+      Check(shader, {offset, 1, ""});
+    }
+  }
+}
+
+}  // namespace
+}  // namespace wgsl
+}  // namespace reader
+}  // namespace tint
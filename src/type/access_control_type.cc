@@ -50,14 +50,6 @@ std::string AccessControl::type_name() const {
   return name + subtype_->type_name();
 }
 
-uint64_t AccessControl::MinBufferBindingSize(MemoryLayout mem_layout) const {
-  return subtype_->MinBufferBindingSize(mem_layout);
-}
-
-uint64_t AccessControl::BaseAlignment(MemoryLayout mem_layout) const {
-  return subtype_->BaseAlignment(mem_layout);
-}
-
 AccessControl* AccessControl::Clone(CloneContext* ctx) const {
   return ctx->dst->create<AccessControl>(access_, ctx->Clone(subtype_));
 }
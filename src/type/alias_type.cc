@@ -37,14 +37,6 @@ std::string Alias::type_name() const {
   return "__alias_" + symbol_.to_str() + subtype_->type_name();
 }
 
-uint64_t Alias::MinBufferBindingSize(MemoryLayout mem_layout) const {
-  return subtype_->MinBufferBindingSize(mem_layout);
-}
-
-uint64_t Alias::BaseAlignment(MemoryLayout mem_layout) const {
-  return subtype_->BaseAlignment(mem_layout);
-}
-
 Alias* Alias::Clone(CloneContext* ctx) const {
   return ctx->dst->create<Alias>(ctx->Clone(symbol()), ctx->Clone(subtype_));
 }
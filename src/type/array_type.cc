@@ -14,13 +14,11 @@
 
 #include "src/type/array_type.h"
 
-#include <cmath>
 #include <memory>
 
 #include "src/ast/stride_decoration.h"
 #include "src/clone_context.h"
 #include "src/program_builder.h"
-#include "src/type/vector_type.h"
 
 TINT_INSTANTIATE_CLASS_ID(tint::type::Array);
 
@@ -34,37 +32,6 @@ Array::Array(Array&&) = default;
 
 Array::~Array() = default;
 
-uint64_t Array::MinBufferBindingSize(MemoryLayout mem_layout) const {
-  if (!has_array_stride()) {
-    // Arrays in buffers are required to have a stride.
-    return 0;
-  }
-
-  if (IsRuntimeArray()) {
-    // WebGPU spec 10.1.2:
-    // If the last field of the corresponding structure defined in the shader
-    // has an unbounded array type, then the value of minBufferBindingSize must
-    // be greater than or equal to the byte offset of that field plus the stride
-    // of the unbounded array
-    return array_stride();
-  } else {
-    // Not including the padding for the last element
-    return (size_ - 1) * array_stride() +
-           subtype_->MinBufferBindingSize(mem_layout);
-  }
-}
-
-uint64_t Array::BaseAlignment(MemoryLayout mem_layout) const {
-  if (mem_layout == MemoryLayout::kUniformBuffer) {
-    float aligment = 16;  // for a vec4
-    float unaligned = static_cast<float>(subtype_->BaseAlignment(mem_layout));
-    return static_cast<uint64_t>(aligment * std::ceil(unaligned / aligment));
-  } else if (mem_layout == MemoryLayout::kStorageBuffer) {
-    return subtype_->BaseAlignment(mem_layout);
-  }
-  return 0;
-}
-
 uint32_t Array::array_stride() const {
   for (auto* deco : decos_) {
     if (auto* stride = deco->As<ast::StrideDecoration>()) {
@@ -0,0 +1,182 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/type/layout.h"
+
+#include <algorithm>
+
+#include "src/ast/struct.h"
+#include "src/type/access_control_type.h"
+#include "src/type/alias_type.h"
+#include "src/type/array_type.h"
+#include "src/type/f32_type.h"
+#include "src/type/i32_type.h"
+#include "src/type/matrix_type.h"
+#include "src/type/struct_type.h"
+#include "src/type/u32_type.h"
+#include "src/type/vector_type.h"
+
+namespace tint {
+namespace type {
+namespace {
+
+/// @returns `value` rounded up to the next multiple of `alignment`, or
+/// `value` if `alignment` is 0
+uint64_t RoundUp(uint64_t value, uint64_t alignment) {
+  if (alignment == 0) {
+    return value;
+  }
+  return ((value + alignment - 1) / alignment) * alignment;
+}
+
+/// @returns the alignment of an array or matrix whose elements are aligned
+/// to `element_align`
+uint64_t ArrayAlignment(uint64_t element_align, MemoryLayout mem_layout) {
+  if (mem_layout == MemoryLayout::kUniformBuffer) {
+    // Round up to a vec4.
+    return RoundUp(element_align, 16);
+  }
+  return element_align;
+}
+
+/// Computes the layout of `type`, obtaining the layouts of the types it is
+/// composed of with `get`
+/// @param type the type
+/// @param mem_layout type of memory layout to use in calculation
+/// @param get the function returning the layout of a sub-type of `type`
+/// @returns the layout of `type`
+template <typename GET>
+Layout Compute(const Type* type, MemoryLayout mem_layout, GET&& get) {
+  Layout layout;
+
+  if (auto* alias = type->As<Alias>()) {
+    return get(alias->type());
+  }
+  if (auto* ac = type->As<AccessControl>()) {
+    return get(ac->type());
+  }
+
+  if (type->Is<F32>() || type->Is<I32>() || type->Is<U32>()) {
+    layout.size = 4;
+    layout.align = 4;
+    return layout;
+  }
+
+  if (auto* vec = type->As<Vector>()) {
+    const Layout& el = get(vec->type());
+    layout.size = vec->size() * el.size;
+    if (vec->size() == 2) {
+      layout.align = 2 * el.align;
+    } else if (vec->size() == 3 || vec->size() == 4) {
+      layout.align = 4 * el.align;
+    }
+    return layout;
+  }
+
+  if (auto* mat = type->As<Matrix>()) {
+    // A matrix is laid out as an array of column vectors
+    const Layout& el = get(mat->type());
+    uint64_t column_size = mat->rows() * el.size;
+    uint64_t column_align = (mat->rows() == 2 ? 2 : 4) * el.align;
+    layout.stride = column_align;
+    layout.size = (mat->columns() - 1) * column_align + column_size;
+    layout.align = ArrayAlignment(column_align, mem_layout);
+    return layout;
+  }
+
+  if (auto* arr = type->As<Array>()) {
+    const Layout& el = get(arr->type());
+    layout.align = ArrayAlignment(el.align, mem_layout);
+    layout.stride = arr->array_stride();
+    if (!arr->has_array_stride()) {
+      // Arrays in buffers are required to have a stride.
+      layout.size = 0;
+    } else if (arr->IsRuntimeArray()) {
+      // WebGPU spec 10.1.2:
+      // If the last field of the corresponding structure defined in the
+      // shader has an unbounded array type, then the value of
+      // minBufferBindingSize must be greater than or equal to the byte offset
+      // of that field plus the stride of the unbounded array
+      layout.size = layout.stride;
+    } else {
+      // Not including the padding for the last element
+      layout.size = (arr->size() - 1) * layout.stride + el.size;
+    }
+    return layout;
+  }
+
+  if (auto* str = type->As<Struct>()) {
+    auto& members = str->impl()->members();
+    uint64_t max_align = 0;
+    uint64_t last_size = 0;
+    for (auto* member : members) {
+      const Layout& member_layout = get(member->type());
+      max_align = std::max(max_align, member_layout.align);
+      last_size = member_layout.size;
+      layout.member_offsets.emplace_back(
+          member->has_offset_decoration() ? member->offset() : 0);
+    }
+    layout.align = mem_layout == MemoryLayout::kUniformBuffer
+                       ? RoundUp(max_align, 16)
+                       : max_align;
+
+    // If the last member has no offset, then this is not a host-shareable
+    // struct, and the size is 0.
+    if (!members.empty() && members.back()->has_offset_decoration() &&
+        last_size != 0) {
+      layout.size =
+          RoundUp(layout.member_offsets.back() + last_size, layout.align);
+    }
+    return layout;
+  }
+
+  return layout;
+}
+
+}  // namespace
+
+Layout ComputeLayout(const Type* type, MemoryLayout mem_layout) {
+  return Compute(type, mem_layout, [&](const Type* t) {
+    return ComputeLayout(t, mem_layout);
+  });
+}
+
+LayoutCache::LayoutCache() = default;
+
+LayoutCache::~LayoutCache() = default;
+
+const Layout& LayoutCache::Get(const Type* type, MemoryLayout mem_layout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return get_locked(type, mem_layout);
+}
+
+const Layout& LayoutCache::get_locked(const Type* type,
+                                      MemoryLayout mem_layout) {
+  auto& cache = mem_layout == MemoryLayout::kUniformBuffer ? uniform_buffer_
+                                                           : storage_buffer_;
+  auto it = cache.find(type);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  // The references to the elements of an unordered_map are not invalidated
+  // by insertions, so the layouts of the sub-types can be held while the
+  // layout of `type` is computed.
+  auto layout = Compute(type, mem_layout, [&](const Type* t) -> const Layout& {
+    return get_locked(t, mem_layout);
+  });
+  return cache.emplace(type, std::move(layout)).first->second;
+}
+
+}  // namespace type
+}  // namespace tint
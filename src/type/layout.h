@@ -0,0 +1,76 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TYPE_LAYOUT_H_
+#define SRC_TYPE_LAYOUT_H_
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "src/type/type.h"
+
+namespace tint {
+namespace type {
+
+/// Layout describes how a host-shareable type is laid out in a buffer
+struct Layout {
+  /// The minimum size of the type, in bytes. 0 for non host-shareable types.
+  uint64_t size = 0;
+  /// The base alignment of the type, in bytes. 0 for non host-shareable
+  /// types.
+  uint64_t align = 0;
+  /// The stride between the elements of an array, or the columns of a
+  /// matrix, in bytes. 0 for other types.
+  uint64_t stride = 0;
+  /// The byte offset of each member of a struct
+  std::vector<uint64_t> member_offsets;
+};
+
+/// Computes the Layout of a type without caching. LayoutCache should be
+/// preferred when the layouts of several types are needed.
+/// @param type the type
+/// @param mem_layout type of memory layout to use in calculation
+/// @returns the layout of `type`
+Layout ComputeLayout(const Type* type, MemoryLayout mem_layout);
+
+/// LayoutCache computes the Layout of types, memoizing the layout of each
+/// type and of all the types it is composed of. The LayoutCache can be used
+/// concurrently from multiple threads.
+class LayoutCache {
+ public:
+  /// Constructor
+  LayoutCache();
+  /// Destructor
+  ~LayoutCache();
+
+  /// @param type the type
+  /// @param mem_layout type of memory layout to use in calculation
+  /// @returns the layout of `type`. The reference remains valid for the
+  /// lifetime of the LayoutCache.
+  const Layout& Get(const Type* type, MemoryLayout mem_layout);
+
+ private:
+  const Layout& get_locked(const Type* type, MemoryLayout mem_layout);
+
+  std::mutex mutex_;
+  std::unordered_map<const Type*, Layout> uniform_buffer_;
+  std::unordered_map<const Type*, Layout> storage_buffer_;
+};
+
+}  // namespace type
+}  // namespace tint
+
+#endif  // SRC_TYPE_LAYOUT_H_
@@ -0,0 +1,147 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/type/layout.h"
+
+#include <vector>
+
+#include "src/ast/stride_decoration.h"
+#include "src/ast/struct_member.h"
+#include "src/ast/struct_member_offset_decoration.h"
+#include "src/type/array_type.h"
+#include "src/type/matrix_type.h"
+#include "src/type/struct_type.h"
+#include "src/type/test_helper.h"
+#include "src/type/type_manager.h"
+#include "src/type/vector_type.h"
+
+namespace tint {
+namespace type {
+namespace {
+
+using LayoutTest = TestHelper;
+
+TEST_F(LayoutTest, Scalar) {
+  auto& layout = Types().LayoutOf(ty.f32(), MemoryLayout::kUniformBuffer);
+  EXPECT_EQ(layout.size, 4u);
+  EXPECT_EQ(layout.align, 4u);
+  EXPECT_EQ(layout.stride, 0u);
+}
+
+TEST_F(LayoutTest, Bool) {
+  auto& layout = Types().LayoutOf(ty.bool_(), MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(layout.size, 0u);
+  EXPECT_EQ(layout.align, 0u);
+}
+
+TEST_F(LayoutTest, Vector) {
+  auto& layout =
+      Types().LayoutOf(ty.vec3<f32>(), MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(layout.size, 12u);
+  EXPECT_EQ(layout.align, 16u);
+}
+
+TEST_F(LayoutTest, Matrix) {
+  auto& uniform =
+      Types().LayoutOf(ty.mat3x2<f32>(), MemoryLayout::kUniformBuffer);
+  EXPECT_EQ(uniform.size, 24u);
+  EXPECT_EQ(uniform.align, 16u);
+  EXPECT_EQ(uniform.stride, 8u);
+
+  auto& storage =
+      Types().LayoutOf(ty.mat3x2<f32>(), MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(storage.size, 24u);
+  EXPECT_EQ(storage.align, 8u);
+  EXPECT_EQ(storage.stride, 8u);
+}
+
+TEST_F(LayoutTest, Array) {
+  auto* arr = create<Array>(
+      ty.u32(), 4, ast::ArrayDecorationList{create<ast::StrideDecoration>(8)});
+  auto& uniform = Types().LayoutOf(arr, MemoryLayout::kUniformBuffer);
+  EXPECT_EQ(uniform.size, 28u);
+  EXPECT_EQ(uniform.align, 16u);
+  EXPECT_EQ(uniform.stride, 8u);
+
+  auto& storage = Types().LayoutOf(arr, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(storage.size, 28u);
+  EXPECT_EQ(storage.align, 4u);
+}
+
+TEST_F(LayoutTest, RuntimeArray) {
+  auto* arr = create<Array>(
+      ty.u32(), 0, ast::ArrayDecorationList{create<ast::StrideDecoration>(4)});
+  auto& layout = Types().LayoutOf(arr, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(layout.size, 4u);
+  EXPECT_EQ(layout.stride, 4u);
+}
+
+TEST_F(LayoutTest, Struct) {
+  auto* inner = ty.struct_(
+      "inner", create<ast::Struct>(
+                   ast::StructMemberList{
+                       Member("a", ty.vec2<f32>(), {MemberOffset(0)}),
+                       Member("b", ty.f32(), {MemberOffset(8)}),
+                   },
+                   ast::StructDecorationList{}));
+  auto* outer = ty.struct_(
+      "outer", create<ast::Struct>(
+                   ast::StructMemberList{
+                       Member("c", ty.u32(), {MemberOffset(0)}),
+                       Member("d", inner, {MemberOffset(16)}),
+                   },
+                   ast::StructDecorationList{}));
+
+  auto& uniform = Types().LayoutOf(outer, MemoryLayout::kUniformBuffer);
+  EXPECT_EQ(uniform.member_offsets, (std::vector<uint64_t>{0, 16}));
+  EXPECT_EQ(uniform.align, 16u);
+  EXPECT_EQ(uniform.size, 32u);
+  EXPECT_EQ(uniform.size, outer->MinBufferBindingSize(
+                              MemoryLayout::kUniformBuffer));
+
+  auto& storage = Types().LayoutOf(outer, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(storage.align, 8u);
+  EXPECT_EQ(storage.size, 32u);
+  EXPECT_EQ(storage.size, outer->MinBufferBindingSize(
+                              MemoryLayout::kStorageBuffer));
+}
+
+TEST_F(LayoutTest, Struct_WithoutOffsets) {
+  auto* s = ty.struct_(
+      "s", create<ast::Struct>(ast::StructMemberList{Member("a", ty.f32(), {})},
+                               ast::StructDecorationList{}));
+  auto& layout = Types().LayoutOf(s, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(layout.size, 0u);
+  EXPECT_EQ(layout.align, 4u);
+}
+
+TEST_F(LayoutTest, Alias) {
+  auto* alias = ty.alias("a", ty.vec4<f32>());
+  auto& layout = Types().LayoutOf(alias, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(layout.size, 16u);
+  EXPECT_EQ(layout.align, 16u);
+}
+
+TEST_F(LayoutTest, Cached) {
+  auto* vec = ty.vec4<f32>();
+  auto& a = Types().LayoutOf(vec, MemoryLayout::kUniformBuffer);
+  auto& b = Types().LayoutOf(vec, MemoryLayout::kUniformBuffer);
+  auto& c = Types().LayoutOf(vec, MemoryLayout::kStorageBuffer);
+  EXPECT_EQ(&a, &b);
+  EXPECT_NE(&a, &c);
+}
+
+}  // namespace
+}  // namespace type
+}  // namespace tint
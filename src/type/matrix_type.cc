@@ -18,8 +18,6 @@
 
 #include "src/clone_context.h"
 #include "src/program_builder.h"
-#include "src/type/array_type.h"
-#include "src/type/vector_type.h"
 
 TINT_INSTANTIATE_CLASS_ID(tint::type::Matrix);
 
@@ -43,18 +41,6 @@ std::string Matrix::type_name() const {
          subtype_->type_name();
 }
 
-uint64_t Matrix::MinBufferBindingSize(MemoryLayout mem_layout) const {
-  Vector vec(subtype_, rows_);
-  return (columns_ - 1) * vec.BaseAlignment(mem_layout) +
-         vec.MinBufferBindingSize(mem_layout);
-}
-
-uint64_t Matrix::BaseAlignment(MemoryLayout mem_layout) const {
-  Vector vec(subtype_, rows_);
-  Array arr(&vec, columns_, ast::ArrayDecorationList{});
-  return arr.BaseAlignment(mem_layout);
-}
-
 Matrix* Matrix::Clone(CloneContext* ctx) const {
   return ctx->dst->create<Matrix>(ctx->Clone(subtype_), rows_, columns_);
 }
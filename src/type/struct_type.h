@@ -48,16 +48,6 @@ class Struct : public Castable<Struct, Type> {
   /// @returns the name for the type
   std::string type_name() const override;
 
-  /// @param mem_layout type of memory layout to use in calculation.
-  /// @returns minimum size required for this type, in bytes.
-  ///          0 for non-host shareable types.
-  uint64_t MinBufferBindingSize(MemoryLayout mem_layout) const override;
-
-  /// @param mem_layout type of memory layout to use in calculation.
-  /// @returns base alignment for the type, in bytes.
-  ///          0 for non-host shareable types.
-  uint64_t BaseAlignment(MemoryLayout mem_layout) const override;
-
   /// Clones this type and all transitive types using the `CloneContext` `ctx`.
   /// @param ctx the clone context
   /// @return the newly cloned type
@@ -66,8 +56,6 @@ class Struct : public Castable<Struct, Type> {
  private:
   Symbol const symbol_;
   ast::Struct* const struct_;
-
-  uint64_t LargestMemberBaseAlignment(MemoryLayout mem_layout) const;
 };
 
 }  // namespace type
@@ -22,6 +22,7 @@
 #include "src/type/bool_type.h"
 #include "src/type/f32_type.h"
 #include "src/type/i32_type.h"
+#include "src/type/layout.h"
 #include "src/type/matrix_type.h"
 #include "src/type/pointer_type.h"
 #include "src/type/sampler_type.h"
@@ -36,13 +37,45 @@ TINT_INSTANTIATE_CLASS_ID(tint::type::Type);
 namespace tint {
 namespace type {
 
+namespace {
+
+/// The classification bits of a type
+enum Classification : uint32_t {
+  /// Set once the classification has been computed
+  kClassified = 1u << 0,
+  kBool = 1u << 1,
+  kFloatScalar = 1u << 2,
+  kSignedScalar = 1u << 3,
+  kUnsignedScalar = 1u << 4,
+  kFloatVector = 1u << 5,
+  kSignedVector = 1u << 6,
+  kUnsignedVector = 1u << 7,
+  kFloatMatrix = 1u << 8,
+};
+
+}  // namespace
+
 Type::Type() = default;
 
-Type::Type(Type&&) = default;
+Type::Type(Type&&) : Castable<Type>() {}
 
 Type::~Type() = default;
 
+void Type::Canonicalize() {
+  unwrapped_ = compute_unwrap_if_needed();
+  if (auto* ptr = As<type::Pointer>()) {
+    unwrapped_ptr_ = ptr->type();
+  } else {
+    unwrapped_ptr_ = this;
+  }
+  unwrapped_all_ = UnwrapIfNeeded()->UnwrapPtrIfNeeded()->UnwrapIfNeeded();
+  classification_ = compute_classification();
+}
+
 Type* Type::UnwrapPtrIfNeeded() {
+  if (unwrapped_ptr_) {
+    return unwrapped_ptr_;
+  }
   if (auto* ptr = As<type::Pointer>()) {
     return ptr->type();
   }
@@ -50,6 +83,13 @@ Type* Type::UnwrapPtrIfNeeded() {
 }
 
 Type* Type::UnwrapIfNeeded() {
+  if (unwrapped_) {
+    return unwrapped_;
+  }
+  return compute_unwrap_if_needed();
+}
+
+Type* Type::compute_unwrap_if_needed() {
   auto* where = this;
   while (true) {
     if (auto* alias = where->As<type::Alias>()) {
@@ -64,59 +104,108 @@ Type* Type::UnwrapIfNeeded() {
 }
 
 Type* Type::UnwrapAll() {
+  if (unwrapped_all_) {
+    return unwrapped_all_;
+  }
   return UnwrapIfNeeded()->UnwrapPtrIfNeeded()->UnwrapIfNeeded();
 }
 
-uint64_t Type::MinBufferBindingSize(MemoryLayout) const {
-  return 0;
+uint64_t Type::MinBufferBindingSize(MemoryLayout mem_layout) const {
+  return ComputeLayout(this, mem_layout).size;
 }
 
-uint64_t Type::BaseAlignment(MemoryLayout) const {
-  return 0;
+uint64_t Type::BaseAlignment(MemoryLayout mem_layout) const {
+  return ComputeLayout(this, mem_layout).align;
+}
+
+uint32_t Type::classification() {
+  return classification_ ? classification_ : compute_classification();
+}
+
+uint32_t Type::compute_classification() {
+  auto scalar_bits = [](Type* ty) -> uint32_t {
+    if (ty->Is<F32>()) {
+      return kFloatScalar;
+    }
+    if (ty->Is<I32>()) {
+      return kSignedScalar;
+    }
+    if (ty->Is<U32>()) {
+      return kUnsignedScalar;
+    }
+    if (ty->Is<Bool>()) {
+      return kBool;
+    }
+    return 0;
+  };
+
+  uint32_t bits = kClassified | scalar_bits(this);
+  if (auto* vec = As<Vector>()) {
+    switch (scalar_bits(vec->type())) {
+      case kFloatScalar:
+        bits |= kFloatVector;
+        break;
+      case kSignedScalar:
+        bits |= kSignedVector;
+        break;
+      case kUnsignedScalar:
+        bits |= kUnsignedVector;
+        break;
+      default:
+        break;
+    }
+  } else if (auto* mat = As<Matrix>()) {
+    if (scalar_bits(mat->type()) == kFloatScalar) {
+      bits |= kFloatMatrix;
+    }
+  }
+  return bits;
 }
 
 bool Type::is_scalar() {
-  return is_float_scalar() || is_integer_scalar() || Is<Bool>();
+  return classification() &
+         (kFloatScalar | kSignedScalar | kUnsignedScalar | kBool);
 }
 
 bool Type::is_float_scalar() {
-  return Is<F32>();
+  return classification() & kFloatScalar;
 }
 
 bool Type::is_float_matrix() {
-  return Is<Matrix>() && As<Matrix>()->type()->is_float_scalar();
+  return classification() & kFloatMatrix;
 }
 
 bool Type::is_float_vector() {
-  return Is<Vector>() && As<Vector>()->type()->is_float_scalar();
+  return classification() & kFloatVector;
 }
 
 bool Type::is_float_scalar_or_vector() {
-  return is_float_scalar() || is_float_vector();
+  return classification() & (kFloatScalar | kFloatVector);
 }
 
 bool Type::is_integer_scalar() {
-  return Is<U32>() || Is<I32>();
+  return classification() & (kSignedScalar | kUnsignedScalar);
 }
 
 bool Type::is_unsigned_integer_vector() {
-  return Is<Vector>() && As<Vector>()->type()->Is<U32>();
+  return classification() & kUnsignedVector;
 }
 
 bool Type::is_signed_integer_vector() {
-  return Is<Vector>() && As<Vector>()->type()->Is<I32>();
+  return classification() & kSignedVector;
 }
 
 bool Type::is_unsigned_scalar_or_vector() {
-  return Is<U32>() || (Is<Vector>() && As<Vector>()->type()->Is<U32>());
+  return classification() & (kUnsignedScalar | kUnsignedVector);
 }
 
 bool Type::is_signed_scalar_or_vector() {
-  return Is<I32>() || (Is<Vector>() && As<Vector>()->type()->Is<I32>());
+  return classification() & (kSignedScalar | kSignedVector);
 }
 
 bool Type::is_integer_scalar_or_vector() {
-  return is_unsigned_scalar_or_vector() || is_signed_scalar_or_vector();
+  return classification() & (kSignedScalar | kUnsignedScalar |
+                             kSignedVector | kUnsignedVector);
 }
 
 }  // namespace type
@@ -33,7 +33,8 @@ enum class MemoryLayout { kUniformBuffer, kStorageBuffer };
 /// Base class for a type in the system
 class Type : public Castable<Type> {
  public:
-  /// Move constructor
+  /// Move constructor. The cached unwrapped types and classification are not
+  /// moved, as they may refer to the moved-from type.
   Type(Type&&);
   ~Type() override;
 
@@ -45,15 +46,24 @@ class Type : public Castable<Type> {
   /// @returns the name for this type. The type name is unique over all types.
   virtual std::string type_name() const = 0;
 
+  /// Computes the minimum size of the type. The layout of types owned by a
+  /// Manager is better obtained with Manager::LayoutOf(), which caches it.
   /// @param mem_layout type of memory layout to use in calculation.
   /// @returns minimum size required for this type, in bytes.
   ///          0 for non-host shareable types.
-  virtual uint64_t MinBufferBindingSize(MemoryLayout mem_layout) const;
+  uint64_t MinBufferBindingSize(MemoryLayout mem_layout) const;
 
+  /// Computes the base alignment of the type. The layout of types owned by a
+  /// Manager is better obtained with Manager::LayoutOf(), which caches it.
   /// @param mem_layout type of memory layout to use in calculation.
   /// @returns base alignment for the type, in bytes.
   ///          0 for non-host shareable types.
-  virtual uint64_t BaseAlignment(MemoryLayout mem_layout) const;
+  uint64_t BaseAlignment(MemoryLayout mem_layout) const;
+
+  /// @returns the index of the type in the Manager that created it, counting
+  /// from 1, or 0 if the type was not created by a Manager. The indices of the
+  /// types of a Manager are dense, so they can index tables of types.
+  uint32_t index() const { return index_; }
 
   /// @returns the pointee type if this is a pointer, `this` otherwise
   Type* UnwrapPtrIfNeeded();
@@ -99,6 +109,29 @@ class Type : public Castable<Type> {
  protected:
   Type();
 
+ private:
+  friend class Manager;
+
+  /// Computes the unwrapped types and the classification of the type, so that
+  /// the unwrapping methods and the `is_xxx()` predicates are simple loads.
+  /// Called by the Manager once the type has been constructed. Types that are
+  /// not created by a Manager compute these on each call.
+  void Canonicalize();
+
+  /// @returns the classification bits of the type, computing them if the
+  /// type has not been canonicalized
+  uint32_t classification();
+  /// @returns the classification bits of the type
+  uint32_t compute_classification();
+  /// @returns the type with all aliases and access control removed
+  Type* compute_unwrap_if_needed();
+
+  Type* unwrapped_ = nullptr;
+  Type* unwrapped_ptr_ = nullptr;
+  Type* unwrapped_all_ = nullptr;
+  uint32_t classification_ = 0;
+  uint32_t index_ = 0;
+
   /// A helper method for cloning the `Type` `t` if it is not null.
   /// If `t` is null, then `Clone()` returns null.
   /// @param b the program builder to clone `n` into
@@ -19,7 +19,7 @@
 namespace tint {
 namespace type {
 
-Manager::Manager() = default;
+Manager::Manager() : layouts_(std::make_unique<LayoutCache>()) {}
 Manager::Manager(Manager&&) = default;
 Manager& Manager::operator=(Manager&& rhs) = default;
 Manager::~Manager() = default;
@@ -15,11 +15,13 @@
 #ifndef SRC_TYPE_TYPE_MANAGER_H_
 #define SRC_TYPE_TYPE_MANAGER_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 
 #include "src/block_allocator.h"
+#include "src/type/layout.h"
 #include "src/type/type.h"
 
 namespace tint {
@@ -59,6 +61,8 @@ class Manager {
     }
 
     auto* type = types_.Create<T>(std::forward<ARGS>(args)...);
+    type->Canonicalize();
+    type->index_ = ++type_count_;
     by_name_.emplace(name, type);
     return type;
   }
@@ -73,6 +77,7 @@ class Manager {
   static Manager Wrap(const Manager& inner) {
     Manager out;
     out.by_name_ = inner.by_name_;
+    out.type_count_ = inner.type_count_;
     return out;
   }
 
@@ -82,6 +87,15 @@ class Manager {
     return by_name_;
   }
 
+  /// @param type the type. Must be owned by this Manager, or by the Manager
+  /// that this Manager wraps.
+  /// @param mem_layout type of memory layout to use in calculation
+  /// @returns the layout of `type`. The layout of each type is only computed
+  /// once, and is shared by all the types that contain it.
+  const Layout& LayoutOf(const Type* type, MemoryLayout mem_layout) const {
+    return layouts_->Get(type, mem_layout);
+  }
+
   /// @returns an iterator to the beginning of the types
   Iterator begin() const { return types_.Objects().begin(); }
   /// @returns an iterator to the end of the types
@@ -90,6 +104,8 @@ class Manager {
  private:
   std::unordered_map<std::string, type::Type*> by_name_;
   BlockAllocator<type::Type> types_;
+  std::unique_ptr<LayoutCache> layouts_;
+  uint32_t type_count_ = 0;
 };
 
 }  // namespace type
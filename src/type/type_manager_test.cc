@@ -15,8 +15,14 @@
 #include "src/type/type_manager.h"
 
 #include "gtest/gtest.h"
+#include "src/type/access_control_type.h"
+#include "src/type/alias_type.h"
+#include "src/type/f32_type.h"
 #include "src/type/i32_type.h"
+#include "src/type/matrix_type.h"
+#include "src/type/pointer_type.h"
 #include "src/type/u32_type.h"
+#include "src/type/vector_type.h"
 
 namespace tint {
 namespace type {
@@ -78,6 +84,107 @@ TEST_F(TypeManagerTest, WrapDoesntAffectInner) {
   EXPECT_EQ(count(outer), 1u);
 }
 
+TEST_F(TypeManagerTest, Index) {
+  Manager inner;
+  auto* i32 = inner.Get<I32>();
+  auto* u32 = inner.Get<U32>();
+  EXPECT_EQ(i32->index(), 1u);
+  EXPECT_EQ(u32->index(), 2u);
+  EXPECT_EQ(inner.Get<I32>()->index(), 1u);
+
+  // The types of a wrapping Manager follow the types of the wrapped Manager
+  Manager outer = Manager::Wrap(inner);
+  EXPECT_EQ(outer.Get<U32>()->index(), 2u);
+  EXPECT_EQ(outer.Get<F32>()->index(), 3u);
+
+  F32 unmanaged;
+  EXPECT_EQ(unmanaged.index(), 0u);
+}
+
+TEST_F(TypeManagerTest, UnwrapMatchesUnmanaged) {
+  Manager tm;
+  auto* f32 = tm.Get<F32>();
+  auto* alias = tm.Get<Alias>(Symbol(1), f32);
+  auto* access = tm.Get<AccessControl>(ast::AccessControl::kReadOnly, alias);
+  auto* ptr = tm.Get<Pointer>(access, ast::StorageClass::kFunction);
+  auto* outer = tm.Get<Alias>(Symbol(2), ptr);
+
+  EXPECT_EQ(f32->UnwrapIfNeeded(), f32);
+  EXPECT_EQ(f32->UnwrapPtrIfNeeded(), f32);
+  EXPECT_EQ(f32->UnwrapAll(), f32);
+  EXPECT_EQ(access->UnwrapIfNeeded(), f32);
+  EXPECT_EQ(ptr->UnwrapIfNeeded(), ptr);
+  EXPECT_EQ(ptr->UnwrapPtrIfNeeded(), access);
+  EXPECT_EQ(ptr->UnwrapAll(), f32);
+  EXPECT_EQ(outer->UnwrapIfNeeded(), ptr);
+  EXPECT_EQ(outer->UnwrapPtrIfNeeded(), outer);
+  EXPECT_EQ(outer->UnwrapAll(), f32);
+
+  // Types not owned by a Manager are unwrapped on demand.
+  Alias unmanaged_alias(Symbol(3), access);
+  Pointer unmanaged_ptr(&unmanaged_alias, ast::StorageClass::kFunction);
+  EXPECT_EQ(unmanaged_alias.UnwrapIfNeeded(), f32);
+  EXPECT_EQ(unmanaged_ptr.UnwrapPtrIfNeeded(), &unmanaged_alias);
+  EXPECT_EQ(unmanaged_ptr.UnwrapAll(), f32);
+}
+
+TEST_F(TypeManagerTest, ClassificationMatchesUnmanaged) {
+  Manager tm;
+  F32 f32;
+  I32 i32;
+  U32 u32;
+  Vector vec3_f32(&f32, 3);
+  Vector vec3_i32(&i32, 3);
+  Vector vec3_u32(&u32, 3);
+  Matrix mat2x3_f32(&f32, 3, 2);
+  Pointer ptr_f32(&f32, ast::StorageClass::kFunction);
+
+  Type* unmanaged[] = {&f32,      &i32,      &u32,        &vec3_f32,
+                       &vec3_i32, &vec3_u32, &mat2x3_f32, &ptr_f32};
+  Type* managed[] = {
+      tm.Get<F32>(),
+      tm.Get<I32>(),
+      tm.Get<U32>(),
+      tm.Get<Vector>(tm.Get<F32>(), 3u),
+      tm.Get<Vector>(tm.Get<I32>(), 3u),
+      tm.Get<Vector>(tm.Get<U32>(), 3u),
+      tm.Get<Matrix>(tm.Get<F32>(), 3u, 2u),
+      tm.Get<Pointer>(tm.Get<F32>(), ast::StorageClass::kFunction),
+  };
+
+  for (size_t i = 0; i < 8; i++) {
+    auto* a = unmanaged[i];
+    auto* b = managed[i];
+    EXPECT_EQ(a->is_scalar(), b->is_scalar()) << i;
+    EXPECT_EQ(a->is_float_scalar(), b->is_float_scalar()) << i;
+    EXPECT_EQ(a->is_float_matrix(), b->is_float_matrix()) << i;
+    EXPECT_EQ(a->is_float_vector(), b->is_float_vector()) << i;
+    EXPECT_EQ(a->is_float_scalar_or_vector(), b->is_float_scalar_or_vector())
+        << i;
+    EXPECT_EQ(a->is_integer_scalar(), b->is_integer_scalar()) << i;
+    EXPECT_EQ(a->is_signed_integer_vector(), b->is_signed_integer_vector())
+        << i;
+    EXPECT_EQ(a->is_unsigned_integer_vector(),
+              b->is_unsigned_integer_vector())
+        << i;
+    EXPECT_EQ(a->is_unsigned_scalar_or_vector(),
+              b->is_unsigned_scalar_or_vector())
+        << i;
+    EXPECT_EQ(a->is_signed_scalar_or_vector(), b->is_signed_scalar_or_vector())
+        << i;
+    EXPECT_EQ(a->is_integer_scalar_or_vector(),
+              b->is_integer_scalar_or_vector())
+        << i;
+  }
+
+  auto* vec4_u32 = tm.Get<Vector>(tm.Get<U32>(), 4u);
+  EXPECT_FALSE(vec4_u32->is_scalar());
+  EXPECT_TRUE(vec4_u32->is_unsigned_integer_vector());
+  EXPECT_TRUE(vec4_u32->is_unsigned_scalar_or_vector());
+  EXPECT_TRUE(vec4_u32->is_integer_scalar_or_vector());
+  EXPECT_FALSE(vec4_u32->is_signed_scalar_or_vector());
+}
+
 }  // namespace
 }  // namespace type
 }  // namespace tint
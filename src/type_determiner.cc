@@ -14,7 +14,14 @@
 
 #include "src/type_determiner.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -35,6 +42,7 @@
 #include "src/ast/if_statement.h"
 #include "src/ast/intrinsic.h"
 #include "src/ast/loop_statement.h"
+#include "src/ast/pipeline_stage.h"
 #include "src/ast/member_accessor_expression.h"
 #include "src/ast/return_statement.h"
 #include "src/ast/scalar_constructor_expression.h"
@@ -58,6 +66,7 @@
 #include "src/type/u32_type.h"
 #include "src/type/vector_type.h"
 #include "src/type/void_type.h"
+#include "src/validator/validator_impl.h"
 
 namespace tint {
 
@@ -77,6 +86,50 @@ diag::List TypeDeterminer::Run(Program* program) {
   return {};
 }
 
+/// ParallelState is the state shared by the workers of
+/// determine_functions_in_parallel().
+struct TypeDeterminer::ParallelState {
+  /// Result holds the outputs of determining a single function. The results
+  /// are merged in declaration order, once all the workers have finished.
+  struct Result {
+    bool determined = false;
+    bool success = false;
+    std::string error;
+    std::unordered_set<Symbol> callees;
+    std::vector<std::pair<ast::Function*, ast::CallExpression*>>
+        stage_restricted_calls;
+  };
+
+  explicit ParallelState(const ast::FunctionList& f)
+      : funcs(f), finished(f.size()), results(f.size()) {}
+
+  const ast::FunctionList& funcs;
+  std::unordered_map<Symbol, size_t> function_index;
+
+  /// Guards `next`, `finished` and `first_failure`
+  std::mutex mutex;
+  /// Signalled each time a function is finished
+  std::condition_variable function_finished;
+  /// The index of the next function to determine
+  size_t next = 0;
+  std::vector<bool> finished;
+  size_t first_failure = std::numeric_limits<size_t>::max();
+
+  /// Guards the creation of types on the shared ProgramBuilder
+  std::mutex types_mutex;
+
+  std::vector<Result> results;
+};
+
+template <typename T, typename... ARGS>
+T* TypeDeterminer::create_type(ARGS&&... args) {
+  if (parallel_ == nullptr) {
+    return builder_->create<T>(std::forward<ARGS>(args)...);
+  }
+  std::lock_guard<std::mutex> lock(parallel_->types_mutex);
+  return builder_->create<T>(std::forward<ARGS>(args)...);
+}
+
 void TypeDeterminer::set_error(const Source& src, const std::string& msg) {
   error_ = "";
   if (src.range.begin.line > 0) {
@@ -119,6 +172,13 @@ bool TypeDeterminer::Determine() {
     }
   }
 
+  if (validate_) {
+    validator_ = std::make_unique<ValidatorImpl>(builder_);
+    if (!validator_->BeginModule()) {
+      return validation_failed();
+    }
+  }
+
   for (auto* var : builder_->AST().GlobalVariables()) {
     variable_stack_.set_global(var->symbol(), var);
 
@@ -133,29 +193,81 @@ bool TypeDeterminer::Determine() {
     return false;
   }
 
-  // Walk over the caller to callee information and update functions with which
-  // entry points call those functions.
-  for (auto* func : builder_->AST().Functions()) {
-    if (!func->IsEntryPoint()) {
-      continue;
-    }
-    for (const auto& callee : caller_to_callee_[func->symbol()]) {
-      set_entry_points(callee, func->symbol());
-    }
+  set_entry_points();
+
+  if (!check_intrinsic_stages()) {
+    return false;
+  }
+
+  if (validator_ && !validator_->EndModule()) {
+    return validation_failed();
   }
 
   return true;
 }
 
-void TypeDeterminer::set_entry_points(const Symbol& fn_sym, Symbol ep_sym) {
-  symbol_to_function_[fn_sym]->add_ancestor_entry_point(ep_sym);
+bool TypeDeterminer::validation_failed() {
+  validation_diagnostics_ = validator_->diagnostics();
+  error_ = validator_->error();
+  return false;
+}
+
+void TypeDeterminer::set_entry_points() {
+  auto& funcs = builder_->AST().Functions();
+
+  std::vector<Symbol> entry_points;
+  std::unordered_map<Symbol, size_t> entry_point_index;
+  for (auto* func : funcs) {
+    if (func->IsEntryPoint()) {
+      entry_point_index.emplace(func->symbol(), entry_points.size());
+      entry_points.emplace_back(func->symbol());
+    }
+  }
+  if (entry_points.empty()) {
+    return;
+  }
+
+  // A function can only call functions declared before it, so walking the
+  // functions in reverse declaration order visits every caller before its
+  // callees. Each function's set of ancestor entry points is therefore
+  // complete by the time it is visited, and can be pushed down to its callees
+  // in a single pass.
+  std::unordered_map<Symbol, std::vector<bool>> ancestors;
+  for (auto it = funcs.rbegin(); it != funcs.rend(); ++it) {
+    auto* func = *it;
+    auto& bits = ancestors[func->symbol()];
+    bits.resize(entry_points.size());
+    for (size_t i = 0; i < entry_points.size(); i++) {
+      if (bits[i]) {
+        func->add_ancestor_entry_point(entry_points[i]);
+      }
+    }
 
-  for (const auto& callee : caller_to_callee_[fn_sym]) {
-    set_entry_points(callee, ep_sym);
+    auto callees = caller_to_callee_.find(func->symbol());
+    if (callees == caller_to_callee_.end()) {
+      continue;
+    }
+    auto inherited = bits;
+    auto ep = entry_point_index.find(func->symbol());
+    if (ep != entry_point_index.end()) {
+      inherited[ep->second] = true;
+    }
+    for (auto& callee : callees->second) {
+      auto& callee_bits = ancestors[callee];
+      callee_bits.resize(entry_points.size());
+      for (size_t i = 0; i < entry_points.size(); i++) {
+        if (inherited[i]) {
+          callee_bits[i] = true;
+        }
+      }
+    }
   }
 }
 
 bool TypeDeterminer::DetermineFunctions(const ast::FunctionList& funcs) {
+  if (thread_count_ > 1 && funcs.size() > 1 && !validator_) {
+    return determine_functions_in_parallel(funcs);
+  }
   for (auto* func : funcs) {
     if (!DetermineFunction(func)) {
       return false;
@@ -164,11 +276,130 @@ bool TypeDeterminer::DetermineFunctions(const ast::FunctionList& funcs) {
   return true;
 }
 
+bool TypeDeterminer::determine_functions_in_parallel(
+    const ast::FunctionList& funcs) {
+  ParallelState state(funcs);
+  for (size_t i = 0; i < funcs.size(); i++) {
+    state.function_index[funcs[i]->symbol()] = i;
+  }
+
+  // Workers take the functions in declaration order. A function can only call
+  // functions declared before it, and those have all been taken by a worker
+  // by the time it is, so a worker waiting on a callee always waits on a
+  // function that is being determined and the workers cannot deadlock.
+  auto count = std::min<size_t>(thread_count_, funcs.size());
+  std::vector<std::unique_ptr<TypeDeterminer>> workers;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < count; i++) {
+    workers.emplace_back(std::make_unique<TypeDeterminer>(builder_));
+    auto* worker = workers.back().get();
+    worker->parallel_ = &state;
+    for (auto* var : builder_->AST().GlobalVariables()) {
+      worker->variable_stack_.set_global(var->symbol(), var);
+    }
+    threads.emplace_back([worker, &state] {
+      worker->determine_functions_worker(&state);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Merge the results in declaration order, stopping at the first failure
+  // like the single threaded path does.
+  for (size_t i = 0; i < funcs.size(); i++) {
+    auto* func = funcs[i];
+    auto& result = state.results[i];
+    symbol_to_function_[func->symbol()] = func;
+    if (!result.success) {
+      error_ = result.error;
+      return false;
+    }
+    if (!result.callees.empty()) {
+      caller_to_callee_[func->symbol()] = std::move(result.callees);
+    }
+    for (auto& call : result.stage_restricted_calls) {
+      stage_restricted_calls_.emplace_back(call);
+    }
+  }
+  return true;
+}
+
+void TypeDeterminer::determine_functions_worker(ParallelState* state) {
+  for (;;) {
+    size_t index = 0;
+    bool skip = false;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->next >= state->funcs.size()) {
+        return;
+      }
+      index = state->next++;
+      // Functions after a failure are never merged.
+      skip = index > state->first_failure;
+    }
+
+    auto* func = state->funcs[index];
+    auto& result = state->results[index];
+    if (!skip) {
+      current_index_ = index;
+      result.determined = true;
+      result.success = DetermineFunction(func);
+      result.error = error_;
+      auto callees = caller_to_callee_.find(func->symbol());
+      if (callees != caller_to_callee_.end()) {
+        result.callees = std::move(callees->second);
+      }
+      result.stage_restricted_calls = std::move(stage_restricted_calls_);
+      caller_to_callee_.clear();
+      stage_restricted_calls_.clear();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->finished[index] = true;
+      if (result.determined && !result.success) {
+        state->first_failure = std::min(state->first_failure, index);
+      }
+    }
+    state->function_finished.notify_all();
+
+    if (result.determined && !result.success) {
+      // DetermineFunction() leaves the scope stack unbalanced on failure.
+      return;
+    }
+  }
+}
+
+ast::Function* TypeDeterminer::find_function(Symbol symbol) {
+  if (parallel_ == nullptr) {
+    auto it = symbol_to_function_.find(symbol);
+    return it != symbol_to_function_.end() ? it->second : nullptr;
+  }
+
+  // Only the functions declared before the current function are visible.
+  auto it = parallel_->function_index.find(symbol);
+  if (it == parallel_->function_index.end() || it->second > current_index_) {
+    return nullptr;
+  }
+  auto index = it->second;
+  if (index < current_index_) {
+    std::unique_lock<std::mutex> lock(parallel_->mutex);
+    parallel_->function_finished.wait(
+        lock, [&] { return parallel_->finished[index]; });
+  }
+  return parallel_->funcs[index];
+}
+
 bool TypeDeterminer::DetermineFunction(ast::Function* func) {
   symbol_to_function_[func->symbol()] = func;
 
   current_function_ = func;
 
+  if (validator_ && !validator_->BeginFunction(func)) {
+    return validation_failed();
+  }
+
   variable_stack_.push_scope();
   for (auto* param : func->params()) {
     variable_stack_.set(param->symbol(), param);
@@ -179,6 +410,10 @@ bool TypeDeterminer::DetermineFunction(ast::Function* func) {
   }
   variable_stack_.pop_scope();
 
+  if (validator_ && !validator_->EndFunction(func)) {
+    return validation_failed();
+  }
+
   current_function_ = nullptr;
 
   return true;
@@ -193,6 +428,14 @@ bool TypeDeterminer::DetermineStatements(const ast::BlockStatement* stmts) {
     if (!DetermineResultType(stmt)) {
       return false;
     }
+
+    // The validator checks the statements of the function body, once their
+    // types are known.
+    if (validator_ && current_function_ &&
+        stmts == current_function_->body() &&
+        !validator_->ValidateStatement(stmt)) {
+      return validation_failed();
+    }
   }
   return true;
 }
@@ -354,7 +597,7 @@ bool TypeDeterminer::DetermineArrayAccessor(
   } else if (auto* vec = parent_type->As<type::Vector>()) {
     ret = vec->type();
   } else if (auto* mat = parent_type->As<type::Matrix>()) {
-    ret = builder_->create<type::Vector>(mat->type(), mat->rows());
+    ret = create_type<type::Vector>(mat->type(), mat->rows());
   } else {
     set_error(expr->source(), "invalid parent type (" +
                                   parent_type->type_name() +
@@ -364,13 +607,13 @@ bool TypeDeterminer::DetermineArrayAccessor(
 
   // If we're extracting from a pointer, we return a pointer.
   if (auto* ptr = res->As<type::Pointer>()) {
-    ret = builder_->create<type::Pointer>(ret, ptr->storage_class());
+    ret = create_type<type::Pointer>(ret, ptr->storage_class());
   } else if (auto* arr = parent_type->As<type::Array>()) {
     if (!arr->type()->is_scalar()) {
       // If we extract a non-scalar from an array then we also get a pointer. We
       // will generate a Function storage class variable to store this
       // into.
-      ret = builder_->create<type::Pointer>(ret, ast::StorageClass::kFunction);
+      ret = create_type<type::Pointer>(ret, ast::StorageClass::kFunction);
     }
   }
   expr->set_result_type(ret);
@@ -404,20 +647,25 @@ bool TypeDeterminer::DetermineCall(ast::CallExpression* expr) {
       }
     } else {
       if (current_function_) {
-        caller_to_callee_[current_function_->symbol()].push_back(
-            ident->symbol());
-
-        auto* callee_func = builder_->AST().Functions().Find(ident->symbol());
-        if (callee_func == nullptr) {
-          set_error(expr->source(),
-                    "unable to find called function: " +
-                        builder_->Symbols().NameFor(ident->symbol()));
-          return false;
-        }
-
-        // We inherit any referenced variables from the callee.
-        for (auto* var : callee_func->referenced_module_variables()) {
-          set_referenced_from_function_if_needed(var, false);
+        auto& callees = caller_to_callee_[current_function_->symbol()];
+        bool first_call = callees.emplace(ident->symbol()).second;
+
+        auto* callee = find_function(ident->symbol());
+        if (callee == nullptr) {
+          // Only functions declared before the caller have been determined.
+          // Calls to functions declared later are reported below.
+          if (builder_->AST().Functions().Find(ident->symbol()) == nullptr) {
+            set_error(expr->source(),
+                      "unable to find called function: " +
+                          builder_->Symbols().NameFor(ident->symbol()));
+            return false;
+          }
+        } else if (first_call) {
+          // We inherit any referenced variables from the callee. The callee
+          // has already been determined, so its list is complete.
+          for (auto* var : callee->referenced_module_variables()) {
+            set_referenced_from_function_if_needed(var, false);
+          }
         }
       }
 
@@ -447,121 +695,255 @@ bool TypeDeterminer::DetermineCall(ast::CallExpression* expr) {
 
 namespace {
 
-enum class IntrinsicDataType {
+using ScalarKind = ast::intrinsic::OverloadSignature::ScalarKind;
+
+/// IntrinsicParamType is the pattern that the type of an intrinsic parameter
+/// must match.
+enum class IntrinsicParamType : uint8_t {
+  kAny,
+  kBoolScalarOrVector,
+  kBoolVector,
   kFloatOrIntScalarOrVector,
   kFloatScalarOrVector,
   kIntScalarOrVector,
   kFloatVector,
   kMatrix,
 };
-struct IntrinsicData {
+
+/// IntrinsicReturnType is the rule used to build the return type of an
+/// intrinsic from the type of its first parameter.
+enum class IntrinsicReturnType : uint8_t {
+  kSameAsFirstParam,
+  kElementOfFirstParam,
+  kBoolOfFirstParam,
+  kBool,
+  kU32,
+};
+
+/// IntrinsicSignature describes the parameters, return type and pipeline stage
+/// restrictions of a non-texture intrinsic.
+/// Parameters that have the same pattern as the first parameter must have the
+/// same type as the first parameter.
+struct IntrinsicSignature {
   ast::Intrinsic intrinsic;
   uint8_t param_count;
-  IntrinsicDataType data_type;
+  IntrinsicParamType params[3];
+  IntrinsicReturnType return_type;
   uint8_t vector_size;
+  /// The only stage the intrinsic can be used in, or kNone for any stage
+  ast::PipelineStage stage;
 };
 
-// Note, this isn't all the intrinsics. Some are handled specially before
-// we get to the generic code. See the DetermineIntrinsic code below.
-constexpr const IntrinsicData kIntrinsicData[] = {
-    {ast::Intrinsic::kAbs, 1, IntrinsicDataType::kFloatOrIntScalarOrVector, 0},
-    {ast::Intrinsic::kAcos, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kAsin, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kAtan, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kAtan2, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kCeil, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kClamp, 3, IntrinsicDataType::kFloatOrIntScalarOrVector,
-     0},
-    {ast::Intrinsic::kCos, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kCosh, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kCountOneBits, 1, IntrinsicDataType::kIntScalarOrVector,
-     0},
-    {ast::Intrinsic::kCross, 2, IntrinsicDataType::kFloatVector, 3},
-    {ast::Intrinsic::kDeterminant, 1, IntrinsicDataType::kMatrix, 0},
-    {ast::Intrinsic::kDistance, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kExp, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kExp2, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kFaceForward, 3, IntrinsicDataType::kFloatScalarOrVector,
-     0},
-    {ast::Intrinsic::kFloor, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kFma, 3, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kFract, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kFrexp, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kInverseSqrt, 1, IntrinsicDataType::kFloatScalarOrVector,
-     0},
-    {ast::Intrinsic::kLdexp, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kLength, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kLog, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kLog2, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kMax, 2, IntrinsicDataType::kFloatOrIntScalarOrVector, 0},
-    {ast::Intrinsic::kMin, 2, IntrinsicDataType::kFloatOrIntScalarOrVector, 0},
-    {ast::Intrinsic::kMix, 3, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kModf, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kNormalize, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kPow, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kReflect, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kReverseBits, 1, IntrinsicDataType::kIntScalarOrVector, 0},
-    {ast::Intrinsic::kRound, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kSign, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kSin, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kSinh, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kSmoothStep, 3, IntrinsicDataType::kFloatScalarOrVector,
-     0},
-    {ast::Intrinsic::kSqrt, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kStep, 2, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kTan, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kTanh, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
-    {ast::Intrinsic::kTrunc, 1, IntrinsicDataType::kFloatScalarOrVector, 0},
+constexpr IntrinsicParamType kAnyParam = IntrinsicParamType::kAny;
+constexpr IntrinsicParamType kBoolParam =
+    IntrinsicParamType::kBoolScalarOrVector;
+constexpr IntrinsicParamType kBoolVecParam = IntrinsicParamType::kBoolVector;
+constexpr IntrinsicParamType kFIParam =
+    IntrinsicParamType::kFloatOrIntScalarOrVector;
+constexpr IntrinsicParamType kFParam = IntrinsicParamType::kFloatScalarOrVector;
+constexpr IntrinsicParamType kIParam = IntrinsicParamType::kIntScalarOrVector;
+constexpr IntrinsicParamType kFVecParam = IntrinsicParamType::kFloatVector;
+constexpr IntrinsicParamType kMatParam = IntrinsicParamType::kMatrix;
+
+constexpr IntrinsicReturnType kSame = IntrinsicReturnType::kSameAsFirstParam;
+constexpr IntrinsicReturnType kElement =
+    IntrinsicReturnType::kElementOfFirstParam;
+constexpr IntrinsicReturnType kBoolOf = IntrinsicReturnType::kBoolOfFirstParam;
+
+constexpr ast::PipelineStage kAnyStage = ast::PipelineStage::kNone;
+constexpr ast::PipelineStage kFragment = ast::PipelineStage::kFragment;
+
+// The signatures of all the intrinsics, other than the texture intrinsics,
+// sorted by ast::Intrinsic.
+constexpr const IntrinsicSignature kIntrinsicSignatures[] = {
+    {ast::Intrinsic::kAbs, 1, {kFIParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kAcos, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kAll, 1, {kBoolVecParam}, IntrinsicReturnType::kBool, 0,
+     kAnyStage},
+    {ast::Intrinsic::kAny, 1, {kBoolVecParam}, IntrinsicReturnType::kBool, 0,
+     kAnyStage},
+    {ast::Intrinsic::kArrayLength, 1, {kAnyParam}, IntrinsicReturnType::kU32, 0,
+     kAnyStage},
+    {ast::Intrinsic::kAsin, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kAtan, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kAtan2, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kCeil, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kClamp, 3, {kFIParam, kFIParam, kFIParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kCos, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kCosh, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kCountOneBits, 1, {kIParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kCross, 2, {kFVecParam, kFVecParam}, kSame, 3, kAnyStage},
+    {ast::Intrinsic::kDeterminant, 1, {kMatParam}, kElement, 0, kAnyStage},
+    {ast::Intrinsic::kDistance, 2, {kFParam, kFParam}, kElement, 0, kAnyStage},
+    {ast::Intrinsic::kDot, 2, {kFVecParam, kFVecParam}, kElement, 0,
+     kAnyStage},
+    {ast::Intrinsic::kDpdx, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kDpdxCoarse, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kDpdxFine, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kDpdy, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kDpdyCoarse, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kDpdyFine, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kExp, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kExp2, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kFaceForward, 3, {kFParam, kFParam, kFParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kFloor, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kFma, 3, {kFParam, kFParam, kFParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kFract, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kFrexp, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kFwidth, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kFwidthCoarse, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kFwidthFine, 1, {kFParam}, kSame, 0, kFragment},
+    {ast::Intrinsic::kInverseSqrt, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kIsFinite, 1, {kFParam}, kBoolOf, 0, kAnyStage},
+    {ast::Intrinsic::kIsInf, 1, {kFParam}, kBoolOf, 0, kAnyStage},
+    {ast::Intrinsic::kIsNan, 1, {kFParam}, kBoolOf, 0, kAnyStage},
+    {ast::Intrinsic::kIsNormal, 1, {kFParam}, kBoolOf, 0, kAnyStage},
+    {ast::Intrinsic::kLdexp, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kLength, 1, {kFParam}, kElement, 0, kAnyStage},
+    {ast::Intrinsic::kLog, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kLog2, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kMax, 2, {kFIParam, kFIParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kMin, 2, {kFIParam, kFIParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kMix, 3, {kFParam, kFParam, kFParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kModf, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kNormalize, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kPow, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kReflect, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kReverseBits, 1, {kIParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kRound, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kSelect, 3, {kAnyParam, kAnyParam, kBoolParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kSign, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kSin, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kSinh, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kSmoothStep, 3, {kFParam, kFParam, kFParam}, kSame, 0,
+     kAnyStage},
+    {ast::Intrinsic::kSqrt, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kStep, 2, {kFParam, kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kTan, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kTanh, 1, {kFParam}, kSame, 0, kAnyStage},
+    {ast::Intrinsic::kTrunc, 1, {kFParam}, kSame, 0, kAnyStage},
 };
 
-constexpr const uint32_t kIntrinsicDataCount =
-    sizeof(kIntrinsicData) / sizeof(IntrinsicData);
+constexpr bool IsSorted(size_t i) {
+  return i + 1 >= sizeof(kIntrinsicSignatures) / sizeof(IntrinsicSignature) ||
+         (kIntrinsicSignatures[i].intrinsic <
+              kIntrinsicSignatures[i + 1].intrinsic &&
+          IsSorted(i + 1));
+}
+static_assert(IsSorted(0), "kIntrinsicSignatures must be sorted by intrinsic");
+
+/// @returns the signature of `intrinsic`, or nullptr if `intrinsic` is a
+/// texture intrinsic.
+const IntrinsicSignature* FindSignature(ast::Intrinsic intrinsic) {
+  auto* begin = std::begin(kIntrinsicSignatures);
+  auto* end = std::end(kIntrinsicSignatures);
+  auto* it = std::lower_bound(
+      begin, end, intrinsic, [](const IntrinsicSignature& s, ast::Intrinsic i) {
+        return s.intrinsic < i;
+      });
+  if (it == end || it->intrinsic != intrinsic) {
+    return nullptr;
+  }
+  return it;
+}
 
-}  // namespace
+/// @returns true if `ty` matches the pattern `param`
+bool Matches(IntrinsicParamType param, type::Type* ty) {
+  switch (param) {
+    case IntrinsicParamType::kAny:
+      return true;
+    case IntrinsicParamType::kBoolScalarOrVector:
+      return ty->Is<type::Bool>() ||
+             (ty->Is<type::Vector>() &&
+              ty->As<type::Vector>()->type()->Is<type::Bool>());
+    case IntrinsicParamType::kBoolVector:
+      return ty->Is<type::Vector>() &&
+             ty->As<type::Vector>()->type()->Is<type::Bool>();
+    case IntrinsicParamType::kFloatOrIntScalarOrVector:
+      return ty->is_float_scalar_or_vector() ||
+             ty->is_integer_scalar_or_vector();
+    case IntrinsicParamType::kFloatScalarOrVector:
+      return ty->is_float_scalar_or_vector();
+    case IntrinsicParamType::kIntScalarOrVector:
+      return ty->is_integer_scalar_or_vector();
+    case IntrinsicParamType::kFloatVector:
+      return ty->is_float_vector();
+    case IntrinsicParamType::kMatrix:
+      return ty->Is<type::Matrix>();
+  }
+  return false;
+}
 
-bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
-                                        ast::CallExpression* expr) {
-  if (ast::intrinsic::IsDerivative(ident->intrinsic())) {
-    if (expr->params().size() != 1) {
-      set_error(expr->source(),
-                "incorrect number of parameters for " +
-                    builder_->Symbols().NameFor(ident->symbol()));
-      return false;
-    }
+/// @returns the description of the pattern `param` used in error messages
+const char* Describe(IntrinsicParamType param) {
+  switch (param) {
+    case IntrinsicParamType::kAny:
+      break;
+    case IntrinsicParamType::kBoolScalarOrVector:
+      return "Requires bool scalar or bool vector values";
+    case IntrinsicParamType::kBoolVector:
+      return "Requires bool vector values";
+    case IntrinsicParamType::kFloatOrIntScalarOrVector:
+      return "Requires float or int, scalar or vector values";
+    case IntrinsicParamType::kFloatScalarOrVector:
+      return "Requires float scalar or float vector values";
+    case IntrinsicParamType::kIntScalarOrVector:
+      return "Requires integer scalar or integer vector values";
+    case IntrinsicParamType::kFloatVector:
+      return "Requires float vector values";
+    case IntrinsicParamType::kMatrix:
+      return "Requires matrix value";
+  }
+  return "";
+}
 
-    // The result type must be the same as the type of the parameter.
-    auto* param_type = expr->params()[0]->result_type()->UnwrapPtrIfNeeded();
-    expr->func()->set_result_type(param_type);
-    return true;
+/// @returns the scalar, vector or matrix element type of `ty`, or `ty` if it
+/// is not a vector or matrix
+type::Type* ElementOf(type::Type* ty) {
+  if (auto* vec = ty->As<type::Vector>()) {
+    return vec->type();
   }
-  if (ident->intrinsic() == ast::Intrinsic::kAny ||
-      ident->intrinsic() == ast::Intrinsic::kAll) {
-    expr->func()->set_result_type(builder_->create<type::Bool>());
-    return true;
+  if (auto* mat = ty->As<type::Matrix>()) {
+    return mat->type();
   }
-  if (ident->intrinsic() == ast::Intrinsic::kArrayLength) {
-    expr->func()->set_result_type(builder_->create<type::U32>());
-    return true;
+  return ty;
+}
+
+/// @returns the overload signature for an intrinsic called with a first
+/// parameter of type `ty`
+std::unique_ptr<ast::intrinsic::OverloadSignature> OverloadOf(type::Type* ty) {
+  uint32_t width = 1;
+  if (auto* vec = ty->As<type::Vector>()) {
+    width = vec->size();
+  } else if (auto* mat = ty->As<type::Matrix>()) {
+    width = mat->columns();
+  }
+
+  auto* el = ElementOf(ty);
+  auto kind = ScalarKind::kOther;
+  if (el->Is<type::Bool>()) {
+    kind = ScalarKind::kBool;
+  } else if (el->Is<type::F32>()) {
+    kind = ScalarKind::kFloat;
+  } else if (el->Is<type::I32>()) {
+    kind = ScalarKind::kSignedInteger;
+  } else if (el->Is<type::U32>()) {
+    kind = ScalarKind::kUnsignedInteger;
+  } else {
+    width = 1;
   }
-  if (ast::intrinsic::IsFloatClassificationIntrinsic(ident->intrinsic())) {
-    if (expr->params().size() != 1) {
-      set_error(expr->source(),
-                "incorrect number of parameters for " +
-                    builder_->Symbols().NameFor(ident->symbol()));
-      return false;
-    }
+  return std::make_unique<ast::intrinsic::OverloadSignature>(kind, width);
+}
 
-    auto* bool_type = builder_->create<type::Bool>();
+}  // namespace
 
-    auto* param_type = expr->params()[0]->result_type()->UnwrapPtrIfNeeded();
-    if (auto* vec = param_type->As<type::Vector>()) {
-      expr->func()->set_result_type(
-          builder_->create<type::Vector>(bool_type, vec->size()));
-    } else {
-      expr->func()->set_result_type(bool_type);
-    }
-    return true;
-  }
+bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
+                                        ast::CallExpression* expr) {
   if (ast::intrinsic::IsTextureIntrinsic(ident->intrinsic())) {
     ast::intrinsic::TextureSignature::Parameters param;
 
@@ -694,7 +1076,7 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
     type::Type* return_type = nullptr;
     switch (ident->intrinsic()) {
       case ast::Intrinsic::kTextureDimensions: {
-        auto* i32 = builder_->create<type::I32>();
+        auto* i32 = create_type<type::I32>();
         switch (texture->dim()) {
           default:
             set_error(expr->source(), "invalid texture dimensions");
@@ -705,12 +1087,12 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
             break;
           case type::TextureDimension::k2d:
           case type::TextureDimension::k2dArray:
-            return_type = builder_->create<type::Vector>(i32, 2);
+            return_type = create_type<type::Vector>(i32, 2);
             break;
           case type::TextureDimension::k3d:
           case type::TextureDimension::kCube:
           case type::TextureDimension::kCubeArray:
-            return_type = builder_->create<type::Vector>(i32, 3);
+            return_type = create_type<type::Vector>(i32, 3);
             break;
         }
         break;
@@ -718,14 +1100,14 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
       case ast::Intrinsic::kTextureNumLayers:
       case ast::Intrinsic::kTextureNumLevels:
       case ast::Intrinsic::kTextureNumSamples:
-        return_type = builder_->create<type::I32>();
+        return_type = create_type<type::I32>();
         break;
       case ast::Intrinsic::kTextureStore:
-        return_type = builder_->create<type::Void>();
+        return_type = create_type<type::Void>();
         break;
       default: {
         if (texture->Is<type::DepthTexture>()) {
-          return_type = builder_->create<type::F32>();
+          return_type = create_type<type::F32>();
         } else {
           type::Type* type = nullptr;
           if (auto* storage = texture->As<type::StorageTexture>()) {
@@ -740,7 +1122,7 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
                       "unknown texture type for texture sampling");
             return false;
           }
-          return_type = builder_->create<type::Vector>(type, 4);
+          return_type = create_type<type::Vector>(type, 4);
         }
       }
     }
@@ -748,116 +1130,49 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
 
     return true;
   }
-  if (ident->intrinsic() == ast::Intrinsic::kDot) {
-    expr->func()->set_result_type(builder_->create<type::F32>());
-    return true;
-  }
-  if (ident->intrinsic() == ast::Intrinsic::kSelect) {
-    if (expr->params().size() != 3) {
-      set_error(expr->source(),
-                "incorrect number of parameters for " +
-                    builder_->Symbols().NameFor(ident->symbol()) +
-                    " expected 3 got " + std::to_string(expr->params().size()));
-      return false;
-    }
-
-    // The result type must be the same as the type of the parameter.
-    auto* param_type = expr->params()[0]->result_type()->UnwrapPtrIfNeeded();
-    expr->func()->set_result_type(param_type);
-    return true;
-  }
-
-  const IntrinsicData* data = nullptr;
-  for (uint32_t i = 0; i < kIntrinsicDataCount; ++i) {
-    if (ident->intrinsic() == kIntrinsicData[i].intrinsic) {
-      data = &kIntrinsicData[i];
-      break;
-    }
-  }
-  if (data == nullptr) {
+  auto* sig = FindSignature(ident->intrinsic());
+  if (sig == nullptr) {
     error_ = "unable to find intrinsic " +
              builder_->Symbols().NameFor(ident->symbol());
     return false;
   }
 
-  if (expr->params().size() != data->param_count) {
+  if (expr->params().size() != sig->param_count) {
     set_error(expr->source(), "incorrect number of parameters for " +
                                   builder_->Symbols().NameFor(ident->symbol()) +
                                   ". Expected " +
-                                  std::to_string(data->param_count) + " got " +
+                                  std::to_string(sig->param_count) + " got " +
                                   std::to_string(expr->params().size()));
     return false;
   }
 
-  std::vector<type::Type*> result_types;
-  for (uint32_t i = 0; i < data->param_count; ++i) {
-    result_types.push_back(
-        expr->params()[i]->result_type()->UnwrapPtrIfNeeded());
-
-    switch (data->data_type) {
-      case IntrinsicDataType::kFloatOrIntScalarOrVector:
-        if (!result_types.back()->is_float_scalar_or_vector() &&
-            !result_types.back()->is_integer_scalar_or_vector()) {
-          set_error(expr->source(),
-                    "incorrect type for " +
-                        builder_->Symbols().NameFor(ident->symbol()) + ". " +
-                        "Requires float or int, scalar or vector values");
-          return false;
-        }
-        break;
-      case IntrinsicDataType::kFloatScalarOrVector:
-        if (!result_types.back()->is_float_scalar_or_vector()) {
-          set_error(expr->source(),
-                    "incorrect type for " +
-                        builder_->Symbols().NameFor(ident->symbol()) + ". " +
-                        "Requires float scalar or float vector values");
-          return false;
-        }
+  std::vector<type::Type*> param_types;
+  for (uint32_t i = 0; i < sig->param_count; ++i) {
+    auto* param_type = expr->params()[i]->result_type()->UnwrapPtrIfNeeded();
+    param_types.push_back(param_type);
 
-        break;
-      case IntrinsicDataType::kIntScalarOrVector:
-        if (!result_types.back()->is_integer_scalar_or_vector()) {
-          set_error(expr->source(),
-                    "incorrect type for " +
-                        builder_->Symbols().NameFor(ident->symbol()) + ". " +
-                        "Requires integer scalar or integer vector values");
-          return false;
-        }
-        break;
-      case IntrinsicDataType::kFloatVector:
-        if (!result_types.back()->is_float_vector()) {
-          set_error(expr->source(),
-                    "incorrect type for " +
-                        builder_->Symbols().NameFor(ident->symbol()) + ". " +
-                        "Requires float vector values");
-          return false;
-        }
-        if (data->vector_size > 0 &&
-            result_types.back()->As<type::Vector>()->size() !=
-                data->vector_size) {
-          set_error(expr->source(),
-                    "incorrect vector size for " +
-                        builder_->Symbols().NameFor(ident->symbol()) + ". " +
-                        "Requires " + std::to_string(data->vector_size) +
-                        " elements");
-          return false;
-        }
-        break;
-      case IntrinsicDataType::kMatrix:
-        if (!result_types.back()->Is<type::Matrix>()) {
-          set_error(expr->source(),
-                    "incorrect type for " +
-                        builder_->Symbols().NameFor(ident->symbol()) +
-                        ". Requires matrix value");
-          return false;
-        }
-        break;
+    if (!Matches(sig->params[i], param_type)) {
+      set_error(expr->source(),
+                "incorrect type for " +
+                    builder_->Symbols().NameFor(ident->symbol()) + ". " +
+                    Describe(sig->params[i]));
+      return false;
+    }
+    if (sig->vector_size > 0 &&
+        param_type->As<type::Vector>()->size() != sig->vector_size) {
+      set_error(expr->source(),
+                "incorrect vector size for " +
+                    builder_->Symbols().NameFor(ident->symbol()) + ". " +
+                    "Requires " + std::to_string(sig->vector_size) +
+                    " elements");
+      return false;
     }
   }
 
-  // Verify all the parameter types match
-  for (size_t i = 1; i < data->param_count; ++i) {
-    if (result_types[0] != result_types[i]) {
+  // Verify all the parameters with the same pattern as the first parameter
+  // have the same type.
+  for (uint32_t i = 1; i < sig->param_count; ++i) {
+    if (sig->params[i] == sig->params[0] && param_types[i] != param_types[0]) {
       set_error(expr->source(),
                 "mismatched parameter types for " +
                     builder_->Symbols().NameFor(ident->symbol()));
@@ -865,22 +1180,66 @@ bool TypeDeterminer::DetermineIntrinsic(ast::IdentifierExpression* ident,
     }
   }
 
-  // Handle functions which aways return the type, even if a vector is
-  // provided.
-  if (ident->intrinsic() == ast::Intrinsic::kLength ||
-      ident->intrinsic() == ast::Intrinsic::kDistance) {
-    expr->func()->set_result_type(
-        result_types[0]->is_float_scalar()
-            ? result_types[0]
-            : result_types[0]->As<type::Vector>()->type());
-    return true;
+  if (sig->stage != ast::PipelineStage::kNone && current_function_ != nullptr) {
+    stage_restricted_calls_.emplace_back(current_function_, expr);
   }
-  // The determinant returns the component type of the columns
-  if (ident->intrinsic() == ast::Intrinsic::kDeterminant) {
-    expr->func()->set_result_type(result_types[0]->As<type::Matrix>()->type());
-    return true;
+
+  ident->set_intrinsic_signature(OverloadOf(param_types[0]));
+
+  type::Type* return_type = nullptr;
+  switch (sig->return_type) {
+    case IntrinsicReturnType::kSameAsFirstParam:
+      return_type = param_types[0];
+      break;
+    case IntrinsicReturnType::kElementOfFirstParam:
+      return_type = ElementOf(param_types[0]);
+      break;
+    case IntrinsicReturnType::kBoolOfFirstParam: {
+      auto* bool_type = create_type<type::Bool>();
+      if (auto* vec = param_types[0]->As<type::Vector>()) {
+        return_type = create_type<type::Vector>(bool_type, vec->size());
+      } else {
+        return_type = bool_type;
+      }
+      break;
+    }
+    case IntrinsicReturnType::kBool:
+      return_type = create_type<type::Bool>();
+      break;
+    case IntrinsicReturnType::kU32:
+      return_type = create_type<type::U32>();
+      break;
+  }
+  expr->func()->set_result_type(return_type);
+  return true;
+}
+
+bool TypeDeterminer::check_intrinsic_stages() {
+  for (auto& call : stage_restricted_calls_) {
+    auto* func = call.first;
+    auto* ident = call.second->func()->As<ast::IdentifierExpression>();
+    auto stage = FindSignature(ident->intrinsic())->stage;
+
+    std::vector<ast::Function*> entry_points;
+    if (func->IsEntryPoint()) {
+      entry_points.emplace_back(func);
+    }
+    for (auto& ep : func->ancestor_entry_points()) {
+      entry_points.emplace_back(symbol_to_function_[ep]);
+    }
+    for (auto* ep : entry_points) {
+      if (ep->pipeline_stage() != stage) {
+        std::stringstream msg;
+        msg << builder_->Symbols().NameFor(ident->symbol())
+            << " can only be used in the " << stage
+            << " pipeline stage, but is called from the "
+            << ep->pipeline_stage() << " entry point "
+            << builder_->Symbols().NameFor(ep->symbol());
+        set_error(call.second->source(), msg.str());
+        return false;
+      }
+    }
   }
-  expr->func()->set_result_type(result_types[0]);
   return true;
 }
 
@@ -911,16 +1270,15 @@ bool TypeDeterminer::DetermineIdentifier(ast::IdentifierExpression* expr) {
       expr->set_result_type(var->type());
     } else {
       expr->set_result_type(
-          builder_->create<type::Pointer>(var->type(), var->storage_class()));
+          create_type<type::Pointer>(var->type(), var->storage_class()));
     }
 
     set_referenced_from_function_if_needed(var, true);
     return true;
   }
 
-  auto iter = symbol_to_function_.find(symbol);
-  if (iter != symbol_to_function_.end()) {
-    expr->set_result_type(iter->second->return_type());
+  if (auto* func = find_function(symbol)) {
+    expr->set_result_type(func->return_type());
     return true;
   }
 
@@ -934,154 +1292,18 @@ bool TypeDeterminer::DetermineIdentifier(ast::IdentifierExpression* expr) {
 }
 
 bool TypeDeterminer::SetIntrinsicIfNeeded(ast::IdentifierExpression* ident) {
-  auto name = builder_->Symbols().NameFor(ident->symbol());
-  if (name == "abs") {
-    ident->set_intrinsic(ast::Intrinsic::kAbs);
-  } else if (name == "acos") {
-    ident->set_intrinsic(ast::Intrinsic::kAcos);
-  } else if (name == "all") {
-    ident->set_intrinsic(ast::Intrinsic::kAll);
-  } else if (name == "any") {
-    ident->set_intrinsic(ast::Intrinsic::kAny);
-  } else if (name == "arrayLength") {
-    ident->set_intrinsic(ast::Intrinsic::kArrayLength);
-  } else if (name == "asin") {
-    ident->set_intrinsic(ast::Intrinsic::kAsin);
-  } else if (name == "atan") {
-    ident->set_intrinsic(ast::Intrinsic::kAtan);
-  } else if (name == "atan2") {
-    ident->set_intrinsic(ast::Intrinsic::kAtan2);
-  } else if (name == "ceil") {
-    ident->set_intrinsic(ast::Intrinsic::kCeil);
-  } else if (name == "clamp") {
-    ident->set_intrinsic(ast::Intrinsic::kClamp);
-  } else if (name == "cos") {
-    ident->set_intrinsic(ast::Intrinsic::kCos);
-  } else if (name == "cosh") {
-    ident->set_intrinsic(ast::Intrinsic::kCosh);
-  } else if (name == "countOneBits") {
-    ident->set_intrinsic(ast::Intrinsic::kCountOneBits);
-  } else if (name == "cross") {
-    ident->set_intrinsic(ast::Intrinsic::kCross);
-  } else if (name == "determinant") {
-    ident->set_intrinsic(ast::Intrinsic::kDeterminant);
-  } else if (name == "distance") {
-    ident->set_intrinsic(ast::Intrinsic::kDistance);
-  } else if (name == "dot") {
-    ident->set_intrinsic(ast::Intrinsic::kDot);
-  } else if (name == "dpdx") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdx);
-  } else if (name == "dpdxCoarse") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdxCoarse);
-  } else if (name == "dpdxFine") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdxFine);
-  } else if (name == "dpdy") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdy);
-  } else if (name == "dpdyCoarse") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdyCoarse);
-  } else if (name == "dpdyFine") {
-    ident->set_intrinsic(ast::Intrinsic::kDpdyFine);
-  } else if (name == "exp") {
-    ident->set_intrinsic(ast::Intrinsic::kExp);
-  } else if (name == "exp2") {
-    ident->set_intrinsic(ast::Intrinsic::kExp2);
-  } else if (name == "faceForward") {
-    ident->set_intrinsic(ast::Intrinsic::kFaceForward);
-  } else if (name == "floor") {
-    ident->set_intrinsic(ast::Intrinsic::kFloor);
-  } else if (name == "fma") {
-    ident->set_intrinsic(ast::Intrinsic::kFma);
-  } else if (name == "fract") {
-    ident->set_intrinsic(ast::Intrinsic::kFract);
-  } else if (name == "frexp") {
-    ident->set_intrinsic(ast::Intrinsic::kFrexp);
-  } else if (name == "fwidth") {
-    ident->set_intrinsic(ast::Intrinsic::kFwidth);
-  } else if (name == "fwidthCoarse") {
-    ident->set_intrinsic(ast::Intrinsic::kFwidthCoarse);
-  } else if (name == "fwidthFine") {
-    ident->set_intrinsic(ast::Intrinsic::kFwidthFine);
-  } else if (name == "inverseSqrt") {
-    ident->set_intrinsic(ast::Intrinsic::kInverseSqrt);
-  } else if (name == "isFinite") {
-    ident->set_intrinsic(ast::Intrinsic::kIsFinite);
-  } else if (name == "isInf") {
-    ident->set_intrinsic(ast::Intrinsic::kIsInf);
-  } else if (name == "isNan") {
-    ident->set_intrinsic(ast::Intrinsic::kIsNan);
-  } else if (name == "isNormal") {
-    ident->set_intrinsic(ast::Intrinsic::kIsNormal);
-  } else if (name == "ldexp") {
-    ident->set_intrinsic(ast::Intrinsic::kLdexp);
-  } else if (name == "length") {
-    ident->set_intrinsic(ast::Intrinsic::kLength);
-  } else if (name == "log") {
-    ident->set_intrinsic(ast::Intrinsic::kLog);
-  } else if (name == "log2") {
-    ident->set_intrinsic(ast::Intrinsic::kLog2);
-  } else if (name == "max") {
-    ident->set_intrinsic(ast::Intrinsic::kMax);
-  } else if (name == "min") {
-    ident->set_intrinsic(ast::Intrinsic::kMin);
-  } else if (name == "mix") {
-    ident->set_intrinsic(ast::Intrinsic::kMix);
-  } else if (name == "modf") {
-    ident->set_intrinsic(ast::Intrinsic::kModf);
-  } else if (name == "normalize") {
-    ident->set_intrinsic(ast::Intrinsic::kNormalize);
-  } else if (name == "pow") {
-    ident->set_intrinsic(ast::Intrinsic::kPow);
-  } else if (name == "reflect") {
-    ident->set_intrinsic(ast::Intrinsic::kReflect);
-  } else if (name == "reverseBits") {
-    ident->set_intrinsic(ast::Intrinsic::kReverseBits);
-  } else if (name == "round") {
-    ident->set_intrinsic(ast::Intrinsic::kRound);
-  } else if (name == "select") {
-    ident->set_intrinsic(ast::Intrinsic::kSelect);
-  } else if (name == "sign") {
-    ident->set_intrinsic(ast::Intrinsic::kSign);
-  } else if (name == "sin") {
-    ident->set_intrinsic(ast::Intrinsic::kSin);
-  } else if (name == "sinh") {
-    ident->set_intrinsic(ast::Intrinsic::kSinh);
-  } else if (name == "smoothStep") {
-    ident->set_intrinsic(ast::Intrinsic::kSmoothStep);
-  } else if (name == "sqrt") {
-    ident->set_intrinsic(ast::Intrinsic::kSqrt);
-  } else if (name == "step") {
-    ident->set_intrinsic(ast::Intrinsic::kStep);
-  } else if (name == "tan") {
-    ident->set_intrinsic(ast::Intrinsic::kTan);
-  } else if (name == "tanh") {
-    ident->set_intrinsic(ast::Intrinsic::kTanh);
-  } else if (name == "textureDimensions") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureDimensions);
-  } else if (name == "textureNumLayers") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureNumLayers);
-  } else if (name == "textureNumLevels") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureNumLevels);
-  } else if (name == "textureNumSamples") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureNumSamples);
-  } else if (name == "textureLoad") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureLoad);
-  } else if (name == "textureStore") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureStore);
-  } else if (name == "textureSample") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureSample);
-  } else if (name == "textureSampleBias") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureSampleBias);
-  } else if (name == "textureSampleCompare") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureSampleCompare);
-  } else if (name == "textureSampleGrad") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureSampleGrad);
-  } else if (name == "textureSampleLevel") {
-    ident->set_intrinsic(ast::Intrinsic::kTextureSampleLevel);
-  } else if (name == "trunc") {
-    ident->set_intrinsic(ast::Intrinsic::kTrunc);
-  } else {
+  auto symbol = ident->symbol();
+  auto it = symbol_to_intrinsic_.find(symbol);
+  if (it == symbol_to_intrinsic_.end()) {
+    it = symbol_to_intrinsic_
+             .emplace(symbol,
+                      ast::ParseIntrinsic(builder_->Symbols().NameFor(symbol)))
+             .first;
+  }
+  if (it->second == ast::Intrinsic::kNone) {
     return false;
   }
+  ident->set_intrinsic(it->second);
   return true;
 }
 
@@ -1115,7 +1337,7 @@ bool TypeDeterminer::DetermineMemberAccessor(
 
     // If we're extracting from a pointer, we return a pointer.
     if (auto* ptr = res->As<type::Pointer>()) {
-      ret = builder_->create<type::Pointer>(ret, ptr->storage_class());
+      ret = create_type<type::Pointer>(ret, ptr->storage_class());
     }
   } else if (auto* vec = data_type->As<type::Vector>()) {
     expr->member()->SetIsSwizzle();
@@ -1126,13 +1348,13 @@ bool TypeDeterminer::DetermineMemberAccessor(
       ret = vec->type();
       // If we're extracting from a pointer, we return a pointer.
       if (auto* ptr = res->As<type::Pointer>()) {
-        ret = builder_->create<type::Pointer>(ret, ptr->storage_class());
+        ret = create_type<type::Pointer>(ret, ptr->storage_class());
       }
     } else {
       // The vector will have a number of components equal to the length of the
       // swizzle. This assumes the validator will check that the swizzle
       // is correct.
-      ret = builder_->create<type::Vector>(vec->type(),
+      ret = create_type<type::Vector>(vec->type(),
                                            static_cast<uint32_t>(size));
     }
   } else {
@@ -1164,11 +1386,11 @@ bool TypeDeterminer::DetermineBinary(ast::BinaryExpression* expr) {
   if (expr->IsLogicalAnd() || expr->IsLogicalOr() || expr->IsEqual() ||
       expr->IsNotEqual() || expr->IsLessThan() || expr->IsGreaterThan() ||
       expr->IsLessThanEqual() || expr->IsGreaterThanEqual()) {
-    auto* bool_type = builder_->create<type::Bool>();
+    auto* bool_type = create_type<type::Bool>();
     auto* param_type = expr->lhs()->result_type()->UnwrapPtrIfNeeded();
     if (auto* vec = param_type->As<type::Vector>()) {
       expr->set_result_type(
-          builder_->create<type::Vector>(bool_type, vec->size()));
+          create_type<type::Vector>(bool_type, vec->size()));
     } else {
       expr->set_result_type(bool_type);
     }
@@ -1185,14 +1407,14 @@ bool TypeDeterminer::DetermineBinary(ast::BinaryExpression* expr) {
     auto* lhs_vec = lhs_type->As<type::Vector>();
     auto* rhs_vec = rhs_type->As<type::Vector>();
     if (lhs_mat && rhs_mat) {
-      expr->set_result_type(builder_->create<type::Matrix>(
+      expr->set_result_type(create_type<type::Matrix>(
           lhs_mat->type(), lhs_mat->rows(), rhs_mat->columns()));
     } else if (lhs_mat && rhs_vec) {
       expr->set_result_type(
-          builder_->create<type::Vector>(lhs_mat->type(), lhs_mat->rows()));
+          create_type<type::Vector>(lhs_mat->type(), lhs_mat->rows()));
     } else if (lhs_vec && rhs_mat) {
       expr->set_result_type(
-          builder_->create<type::Vector>(rhs_mat->type(), rhs_mat->columns()));
+          create_type<type::Vector>(rhs_mat->type(), rhs_mat->columns()));
     } else if (lhs_mat) {
       // matrix * scalar
       expr->set_result_type(lhs_type);
@@ -1243,7 +1465,7 @@ bool TypeDeterminer::DetermineStorageTextureSubtype(type::StorageTexture* tex) {
     case type::ImageFormat::kRg32Uint:
     case type::ImageFormat::kRgba16Uint:
     case type::ImageFormat::kRgba32Uint: {
-      tex->set_type(builder_->create<type::U32>());
+      tex->set_type(create_type<type::U32>());
       return true;
     }
 
@@ -1256,7 +1478,7 @@ bool TypeDeterminer::DetermineStorageTextureSubtype(type::StorageTexture* tex) {
     case type::ImageFormat::kRg32Sint:
     case type::ImageFormat::kRgba16Sint:
     case type::ImageFormat::kRgba32Sint: {
-      tex->set_type(builder_->create<type::I32>());
+      tex->set_type(create_type<type::I32>());
       return true;
     }
 
@@ -1277,7 +1499,7 @@ bool TypeDeterminer::DetermineStorageTextureSubtype(type::StorageTexture* tex) {
     case type::ImageFormat::kRg32Float:
     case type::ImageFormat::kRgba16Float:
     case type::ImageFormat::kRgba32Float: {
-      tex->set_type(builder_->create<type::F32>());
+      tex->set_type(create_type<type::F32>());
       return true;
     }
 
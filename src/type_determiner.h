@@ -15,10 +15,14 @@
 #ifndef SRC_TYPE_DETERMINER_H_
 #define SRC_TYPE_DETERMINER_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "src/ast/intrinsic.h"
 #include "src/ast/module.h"
 #include "src/diagnostic/diagnostic.h"
 #include "src/scope_stack.h"
@@ -40,6 +44,8 @@ class Variable;
 
 }  // namespace ast
 
+class ValidatorImpl;
+
 /// Determines types for all items in the given tint program
 class TypeDeterminer {
  public:
@@ -61,6 +67,30 @@ class TypeDeterminer {
   /// @returns error messages from the type determiner
   const std::string& error() { return error_; }
 
+  /// Sets the number of threads used to determine the function bodies.
+  /// Once the global variables have been determined, each function body only
+  /// depends on the functions it calls, so functions that do not call each
+  /// other are determined concurrently. The result does not depend on the
+  /// number of threads.
+  /// @param count the number of threads. 0 or 1 determines all the functions
+  /// on the calling thread.
+  void set_thread_count(uint32_t count) { thread_count_ = count; }
+
+  /// Enables validation of the program as part of Determine(). The
+  /// validator's checks are run on each declaration and statement as soon as
+  /// it has been determined, instead of walking the program a second time
+  /// with a separate Validator. The diagnostics are identical to those of the
+  /// Validator. Functions are always determined on the calling thread when
+  /// validation is enabled.
+  /// @param validate true to validate the program
+  void set_validate(bool validate) { validate_ = validate; }
+
+  /// @returns the diagnostics of the validation, if the program failed
+  /// validation. See set_validate().
+  const diag::List& validation_diagnostics() const {
+    return validation_diagnostics_;
+  }
+
   /// @returns true if the type determiner was successful
   bool Determine();
   /// Determines type information for functions
@@ -124,7 +154,16 @@ class TypeDeterminer {
  private:
   void set_error(const Source& src, const std::string& msg);
   void set_referenced_from_function_if_needed(ast::Variable* var, bool local);
-  void set_entry_points(const Symbol& fn_sym, Symbol ep_sym);
+  void set_entry_points();
+  bool check_intrinsic_stages();
+  bool validation_failed();
+
+  struct ParallelState;
+  bool determine_functions_in_parallel(const ast::FunctionList& funcs);
+  void determine_functions_worker(ParallelState* state);
+  ast::Function* find_function(Symbol symbol);
+  template <typename T, typename... ARGS>
+  T* create_type(ARGS&&... args);
 
   bool DetermineArrayAccessor(ast::ArrayAccessorExpression* expr);
   bool DetermineBinary(ast::BinaryExpression* expr);
@@ -141,10 +180,31 @@ class TypeDeterminer {
   std::string error_;
   ScopeStack<ast::Variable*> variable_stack_;
   std::unordered_map<Symbol, ast::Function*> symbol_to_function_;
+  // Cache of the intrinsic named by each symbol seen by
+  // SetIntrinsicIfNeeded(). Holds ast::Intrinsic::kNone for other names.
+  std::unordered_map<Symbol, ast::Intrinsic> symbol_to_intrinsic_;
   ast::Function* current_function_ = nullptr;
 
   // Map from caller functions to callee functions.
-  std::unordered_map<Symbol, std::vector<Symbol>> caller_to_callee_;
+  std::unordered_map<Symbol, std::unordered_set<Symbol>> caller_to_callee_;
+
+  // Calls to intrinsics that can only be used in a single pipeline stage, and
+  // the functions they are called from. Checked once the entry points that
+  // call each function are known.
+  std::vector<std::pair<ast::Function*, ast::CallExpression*>>
+      stage_restricted_calls_;
+
+  bool validate_ = false;
+  // The validator run inline with the determination, if `validate_` is set
+  std::unique_ptr<ValidatorImpl> validator_;
+  diag::List validation_diagnostics_;
+
+  uint32_t thread_count_ = 1;
+  // The state shared by the workers determining functions in parallel, or
+  // nullptr if this is not a worker.
+  ParallelState* parallel_ = nullptr;
+  // The index of `current_function_` in the module, set for workers.
+  size_t current_index_ = 0;
 };
 
 }  // namespace tint
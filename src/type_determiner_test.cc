@@ -1199,7 +1199,8 @@ TEST_P(IntrinsicDerivativeTest, MissingParam) {
 
   auto* expr = Call(name);
   EXPECT_FALSE(td()->DetermineResultType(expr));
-  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name);
+  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name +
+                               ". Expected 1 got 0");
 }
 
 TEST_P(IntrinsicDerivativeTest, ToomManyParams) {
@@ -1214,7 +1215,8 @@ TEST_P(IntrinsicDerivativeTest, ToomManyParams) {
 
   auto* expr = Call(name, "ident1", "ident2");
   EXPECT_FALSE(td()->DetermineResultType(expr));
-  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name);
+  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name +
+                               ". Expected 1 got 2");
 }
 INSTANTIATE_TEST_SUITE_P(TypeDeterminerTest,
                          IntrinsicDerivativeTest,
@@ -1298,7 +1300,8 @@ TEST_P(Intrinsic_FloatMethod, MissingParam) {
   // Register the variable
   EXPECT_TRUE(td()->Determine());
   EXPECT_FALSE(td()->DetermineResultType(expr));
-  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name);
+  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name +
+                               ". Expected 1 got 0");
 }
 
 TEST_P(Intrinsic_FloatMethod, TooManyParams) {
@@ -1313,7 +1316,8 @@ TEST_P(Intrinsic_FloatMethod, TooManyParams) {
   // Register the variable
   EXPECT_TRUE(td()->Determine());
   EXPECT_FALSE(td()->DetermineResultType(expr));
-  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name);
+  EXPECT_EQ(td()->error(), "incorrect number of parameters for " + name +
+                               ". Expected 1 got 2");
 }
 INSTANTIATE_TEST_SUITE_P(
     TypeDeterminerTest,
@@ -1541,7 +1545,7 @@ TEST_F(TypeDeterminerTest, Intrinsic_Select_TooFewParams) {
   EXPECT_TRUE(td()->Determine());
   EXPECT_FALSE(td()->DetermineResultType(expr));
   EXPECT_EQ(td()->error(),
-            "incorrect number of parameters for select expected 3 got 1");
+            "incorrect number of parameters for select. Expected 3 got 1");
 }
 
 TEST_F(TypeDeterminerTest, Intrinsic_Select_TooManyParams) {
@@ -1555,7 +1559,119 @@ TEST_F(TypeDeterminerTest, Intrinsic_Select_TooManyParams) {
   EXPECT_TRUE(td()->Determine());
   EXPECT_FALSE(td()->DetermineResultType(expr));
   EXPECT_EQ(td()->error(),
-            "incorrect number of parameters for select expected 3 got 4");
+            "incorrect number of parameters for select. Expected 3 got 4");
+}
+
+TEST_F(TypeDeterminerTest, Intrinsic_Select_MismatchedTypes) {
+  auto* var = Var("v", ast::StorageClass::kNone, ty.vec3<f32>());
+  auto* other = Var("o", ast::StorageClass::kNone, ty.vec3<i32>());
+  auto* bool_var = Var("b", ast::StorageClass::kNone, ty.vec3<bool>());
+  AST().AddGlobalVariable(var);
+  AST().AddGlobalVariable(other);
+  AST().AddGlobalVariable(bool_var);
+
+  auto* expr = Call("select", "v", "o", "b");
+
+  // Register the variable
+  EXPECT_TRUE(td()->Determine());
+  EXPECT_FALSE(td()->DetermineResultType(expr));
+  EXPECT_EQ(td()->error(), "mismatched parameter types for select");
+}
+
+TEST_F(TypeDeterminerTest, Intrinsic_Any_Scalar) {
+  auto* var = Var("b", ast::StorageClass::kNone, ty.bool_());
+  AST().AddGlobalVariable(var);
+
+  auto* expr = Call("any", "b");
+
+  // Register the variable
+  EXPECT_TRUE(td()->Determine());
+  EXPECT_FALSE(td()->DetermineResultType(expr));
+  EXPECT_EQ(td()->error(),
+            "incorrect type for any. Requires bool vector values");
+}
+
+TEST_F(TypeDeterminerTest, Intrinsic_OverloadSignature) {
+  auto* expr = Call("max", vec3<u32>(1u, 2u, 3u), vec3<u32>(4u, 5u, 6u));
+
+  EXPECT_TRUE(td()->DetermineResultType(expr)) << td()->error();
+
+  auto* ident = expr->func()->As<ast::IdentifierExpression>();
+  auto* sig = static_cast<const ast::intrinsic::OverloadSignature*>(
+      ident->intrinsic_signature());
+  ASSERT_NE(sig, nullptr);
+  EXPECT_EQ(sig->kind,
+            ast::intrinsic::OverloadSignature::ScalarKind::kUnsignedInteger);
+  EXPECT_EQ(sig->width, 3u);
+}
+
+TEST_F(TypeDeterminerTest, Intrinsic_Derivative_FragmentStage) {
+  // fn helper() { v = dpdx(v); }
+  // [[stage(fragment)]] fn main() { helper(); }
+  AST().AddGlobalVariable(Var("v", ast::StorageClass::kPrivate, ty.f32()));
+
+  ast::VariableList params;
+  auto* helper = Func("helper", params, ty.void_(),
+                      ast::StatementList{
+                          create<ast::AssignmentStatement>(
+                              Expr("v"), Call("dpdx", "v")),
+                      },
+                      ast::FunctionDecorationList{});
+  auto* main = Func("main", params, ty.void_(),
+                    ast::StatementList{
+                        create<ast::CallStatement>(Call("helper")),
+                    },
+                    ast::FunctionDecorationList{
+                        create<ast::StageDecoration>(
+                            ast::PipelineStage::kFragment),
+                    });
+  AST().Functions().Add(helper);
+  AST().Functions().Add(main);
+
+  EXPECT_TRUE(td()->Determine()) << td()->error();
+}
+
+TEST_F(TypeDeterminerTest, Intrinsic_Derivative_NonFragmentStage) {
+  // fn helper() { v = dpdx(v); }
+  // [[stage(fragment)]] fn frag() { helper(); }
+  // [[stage(compute)]] fn comp() { helper(); }
+  AST().AddGlobalVariable(Var("v", ast::StorageClass::kPrivate, ty.f32()));
+
+  ast::VariableList params;
+  auto* helper = Func("helper", params, ty.void_(),
+                      ast::StatementList{
+                          create<ast::AssignmentStatement>(
+                              Expr("v"),
+                              create<ast::CallExpression>(
+                                  Source{Source::Location{3, 7}},
+                                  Expr("dpdx"),
+                                  ast::ExpressionList{Expr("v")})),
+                      },
+                      ast::FunctionDecorationList{});
+  auto* frag = Func("frag", params, ty.void_(),
+                    ast::StatementList{
+                        create<ast::CallStatement>(Call("helper")),
+                    },
+                    ast::FunctionDecorationList{
+                        create<ast::StageDecoration>(
+                            ast::PipelineStage::kFragment),
+                    });
+  auto* comp = Func("comp", params, ty.void_(),
+                    ast::StatementList{
+                        create<ast::CallStatement>(Call("helper")),
+                    },
+                    ast::FunctionDecorationList{
+                        create<ast::StageDecoration>(
+                            ast::PipelineStage::kCompute),
+                    });
+  AST().Functions().Add(helper);
+  AST().Functions().Add(frag);
+  AST().Functions().Add(comp);
+
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(),
+            "3:7: dpdx can only be used in the fragment pipeline stage, but is "
+            "called from the compute entry point comp");
 }
 
 using UnaryOpExpressionTest = TypeDeterminerTestWithParam<ast::UnaryOp>;
@@ -2791,6 +2907,185 @@ TEST_F(TypeDeterminerTest, Function_EntryPoints_StageDecoration) {
   EXPECT_TRUE(ep_2->ancestor_entry_points().empty());
 }
 
+TEST_F(TypeDeterminerTest, Function_EntryPoints_DiamondCallGraph) {
+  // fn f_0() { v_0 = 1.0; }
+  // fn f_1() { v_1 = f_0(); v_1 = f_0(); }
+  // ...
+  // fn f_N() { v_N = f_N-1(); v_N = f_N-1(); }
+  // fn ep_1() { f_N(); }
+  // fn ep_2() { f_N-1(); }
+  //
+  // Each function calls its predecessor twice, so there are 2^N call paths
+  // from f_N to f_0.
+  constexpr int kDepth = 64;
+
+  ast::VariableList params;
+  std::vector<ast::Function*> funcs;
+  for (int i = 0; i < kDepth; i++) {
+    auto var = "v_" + std::to_string(i);
+    AST().AddGlobalVariable(Var(var, ast::StorageClass::kPrivate, ty.f32()));
+
+    ast::StatementList body;
+    if (i == 0) {
+      body.emplace_back(create<ast::AssignmentStatement>(Expr(var), Expr(1.f)));
+    } else {
+      auto callee = "f_" + std::to_string(i - 1);
+      for (int call = 0; call < 2; call++) {
+        body.emplace_back(
+            create<ast::AssignmentStatement>(Expr(var), Call(callee)));
+      }
+    }
+    auto* func = Func("f_" + std::to_string(i), params, ty.f32(), body,
+                      ast::FunctionDecorationList{});
+    AST().Functions().Add(func);
+    funcs.emplace_back(func);
+  }
+
+  auto* ep_1 = Func(
+      "ep_1", params, ty.void_(),
+      ast::StatementList{
+          create<ast::CallStatement>(Call("f_" + std::to_string(kDepth - 1))),
+      },
+      ast::FunctionDecorationList{
+          create<ast::StageDecoration>(ast::PipelineStage::kVertex),
+      });
+  auto* ep_2 = Func(
+      "ep_2", params, ty.void_(),
+      ast::StatementList{
+          create<ast::CallStatement>(Call("f_" + std::to_string(kDepth - 2))),
+      },
+      ast::FunctionDecorationList{
+          create<ast::StageDecoration>(ast::PipelineStage::kVertex),
+      });
+  AST().Functions().Add(ep_1);
+  AST().Functions().Add(ep_2);
+
+  ASSERT_TRUE(td()->Determine()) << td()->error();
+
+  for (int i = 0; i < kDepth; i++) {
+    auto& eps = funcs[i]->ancestor_entry_points();
+    if (i == kDepth - 1) {
+      ASSERT_EQ(eps.size(), 1u);
+      EXPECT_EQ(eps[0], Symbols().Get("ep_1"));
+    } else {
+      ASSERT_EQ(eps.size(), 2u);
+      EXPECT_EQ(eps[0], Symbols().Get("ep_1"));
+      EXPECT_EQ(eps[1], Symbols().Get("ep_2"));
+    }
+
+    // f_i references v_i itself, and v_0 ... v_i-1 through its callees.
+    auto& vars = funcs[i]->referenced_module_variables();
+    ASSERT_EQ(vars.size(), static_cast<size_t>(i + 1));
+    EXPECT_EQ(vars[0]->symbol(), Symbols().Get("v_" + std::to_string(i)));
+    auto& local_vars = funcs[i]->local_referenced_module_variables();
+    ASSERT_EQ(local_vars.size(), 1u);
+    EXPECT_EQ(local_vars[0]->symbol(),
+              Symbols().Get("v_" + std::to_string(i)));
+  }
+  EXPECT_EQ(ep_1->referenced_module_variables().size(),
+            static_cast<size_t>(kDepth));
+  EXPECT_EQ(ep_2->referenced_module_variables().size(),
+            static_cast<size_t>(kDepth - 1));
+}
+
+TEST_F(TypeDeterminerTest, Function_Parallel) {
+  // fn f_i() -> f32 { v_(i%4) = f_i-1(); return v_(i%4); }
+  // with the calls to f_i-1 omitted when i is a multiple of 8, giving 8
+  // independent call chains of 8 functions.
+  // [[stage(fragment)]] fn main() { f_63(); }
+  constexpr int kFuncs = 64;
+  constexpr int kChain = 8;
+  constexpr int kVars = 4;
+
+  for (int i = 0; i < kVars; i++) {
+    AST().AddGlobalVariable(
+        Var("v_" + std::to_string(i), ast::StorageClass::kPrivate, ty.f32()));
+  }
+
+  ast::VariableList params;
+  std::vector<ast::Function*> funcs;
+  std::vector<ast::CallExpression*> calls;
+  for (int i = 0; i < kFuncs; i++) {
+    auto var = "v_" + std::to_string(i % kVars);
+    ast::Expression* value = Expr(1.f);
+    if (i % kChain != 0) {
+      auto* call = Call("f_" + std::to_string(i - 1));
+      calls.emplace_back(call);
+      value = call;
+    }
+    auto* func = Func("f_" + std::to_string(i), params, ty.f32(),
+                      ast::StatementList{
+                          create<ast::AssignmentStatement>(Expr(var), value),
+                          create<ast::ReturnStatement>(Expr(var)),
+                      },
+                      ast::FunctionDecorationList{});
+    AST().Functions().Add(func);
+    funcs.emplace_back(func);
+  }
+  auto* main = Func(
+      "main", params, ty.void_(),
+      ast::StatementList{
+          create<ast::CallStatement>(Call("f_" + std::to_string(kFuncs - 1))),
+      },
+      ast::FunctionDecorationList{
+          create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+      });
+  AST().Functions().Add(main);
+
+  td()->set_thread_count(8);
+  ASSERT_TRUE(td()->Determine()) << td()->error();
+
+  for (auto* call : calls) {
+    ASSERT_NE(call->result_type(), nullptr);
+    EXPECT_TRUE(call->result_type()->Is<type::F32>());
+  }
+  for (int i = 0; i < kFuncs; i++) {
+    // f_i references the variables of the functions from the start of its
+    // chain up to itself.
+    auto chain_length = static_cast<size_t>(i % kChain + 1);
+    EXPECT_EQ(funcs[i]->referenced_module_variables().size(),
+              std::min<size_t>(chain_length, kVars));
+
+    auto& eps = funcs[i]->ancestor_entry_points();
+    if (i >= kFuncs - kChain) {
+      ASSERT_EQ(eps.size(), 1u);
+      EXPECT_EQ(eps[0], Symbols().Get("main"));
+    } else {
+      EXPECT_TRUE(eps.empty());
+    }
+  }
+  EXPECT_EQ(main->referenced_module_variables().size(),
+            static_cast<size_t>(kVars));
+}
+
+TEST_F(TypeDeterminerTest, Function_Parallel_ReportsFirstError) {
+  // fn f_i() { v = 1.0; } for all i, except:
+  // fn f_20() { v = a; }
+  // fn f_40() { v = b; }
+  AST().AddGlobalVariable(Var("v", ast::StorageClass::kPrivate, ty.f32()));
+
+  ast::VariableList params;
+  for (int i = 0; i < 64; i++) {
+    ast::Expression* value = Expr(1.f);
+    if (i == 20) {
+      value = Expr(Source{Source::Location{20, 1}}, "a");
+    } else if (i == 40) {
+      value = Expr(Source{Source::Location{40, 1}}, "b");
+    }
+    AST().Functions().Add(
+        Func("f_" + std::to_string(i), params, ty.void_(),
+             ast::StatementList{
+                 create<ast::AssignmentStatement>(Expr("v"), value),
+             },
+             ast::FunctionDecorationList{}));
+  }
+
+  td()->set_thread_count(8);
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(),
+            "20:1: v-0006: identifier must be declared before use: a");
+}
+
 using TypeDeterminerTextureIntrinsicTest =
     TypeDeterminerTestWithParam<ast::intrinsic::test::TextureOverloadCase>;
 
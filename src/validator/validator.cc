@@ -24,6 +24,7 @@ Validator::~Validator() = default;
 
 bool Validator::Validate(const Program* program) {
   ValidatorImpl impl(program);
+  impl.set_thread_count(thread_count_);
   bool ret = impl.Validate();
   diags_ = impl.diagnostics();
   return ret;
@@ -39,6 +39,12 @@ class Validator {
   /// @returns true if the validation was successful
   bool Validate(const Program* program);
 
+  /// Sets the number of threads used to validate the function bodies. The
+  /// diagnostics do not depend on the number of threads.
+  /// @param count the number of threads. 0 or 1 validates all the functions
+  /// on the calling thread.
+  void set_thread_count(uint32_t count) { thread_count_ = count; }
+
   /// @returns error messages from the validator
   std::string error() {
     diag::Formatter formatter{{false, false, false, false}};
@@ -51,6 +57,7 @@ class Validator {
 
  private:
   diag::List diags_;
+  uint32_t thread_count_ = 1;
 };
 
 }  // namespace tint
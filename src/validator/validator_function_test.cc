@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+
 #include "gtest/gtest.h"
 #include "spirv/unified1/GLSL.std.450.h"
 #include "src/ast/call_statement.h"
@@ -365,5 +367,92 @@ TEST_F(ValidateFunctionTest, OnePipelineStageFunctionMustBePresent_Fail) {
             "be present");
 }
 
+TEST_F(ValidateFunctionTest, Parallel_Pass) {
+  // fn f0() -> void { return; }
+  // fn f1() -> void { f0(); return; }
+  // ...
+  // [[stage(vertex)]]
+  // fn main() -> void { f15(); return; }
+  for (int i = 0; i <= 16; i++) {
+    ast::StatementList body;
+    if (i > 0) {
+      body.emplace_back(create<ast::CallStatement>(create<ast::CallExpression>(
+          Expr("f" + std::to_string(i - 1)), ast::ExpressionList{})));
+    }
+    body.emplace_back(create<ast::ReturnStatement>());
+    ast::FunctionDecorationList decos;
+    if (i == 16) {
+      decos.emplace_back(
+          create<ast::StageDecoration>(ast::PipelineStage::kVertex));
+    }
+    AST().Functions().Add(Func(i == 16 ? "main" : "f" + std::to_string(i),
+                               ast::VariableList{}, ty.void_(), body, decos));
+  }
+
+  EXPECT_TRUE(td()->Determine()) << td()->error();
+
+  ValidatorImpl& v = Build();
+  v.set_thread_count(4);
+
+  EXPECT_TRUE(v.Validate()) << v.error();
+}
+
+TEST_F(ValidateFunctionTest, Parallel_ReportsFirstError) {
+  // fn f0() -> void { return; }
+  // ...
+  // fn f3() -> void { return 2; }
+  // ...
+  // fn f2() -> void { return; }
+  // ...
+  // fn f14() -> void { return 2; }
+  // fn f15() -> void { return; }
+  for (uint32_t i = 0; i < 16; i++) {
+    auto* ret =
+        i == 3 || i == 14
+            ? create<ast::ReturnStatement>(Source{Source::Location{i, 1}},
+                                           Expr(2))
+            : create<ast::ReturnStatement>();
+    auto name = i == 10 ? std::string("f2") : "f" + std::to_string(i);
+    AST().Functions().Add(Func(Source{Source::Location{i, 2}}, name,
+                               ast::VariableList{}, ty.void_(),
+                               ast::StatementList{ret},
+                               ast::FunctionDecorationList{}));
+  }
+
+  EXPECT_TRUE(td()->Determine()) << td()->error();
+
+  ValidatorImpl& v = Build();
+  v.set_thread_count(4);
+
+  EXPECT_FALSE(v.Validate());
+  EXPECT_EQ(v.error(),
+            "3:1 v-000y: return statement type must match its function "
+            "return type, returned '__i32', expected '__void'");
+}
+
+TEST_F(ValidateFunctionTest, Parallel_FunctionNamesMustBeUnique_Fail) {
+  // fn f0() -> void { return; }
+  // ...
+  // fn f2() -> void { return; }
+  // ...
+  for (uint32_t i = 0; i < 16; i++) {
+    auto name = i == 10 ? std::string("f2") : "f" + std::to_string(i);
+    AST().Functions().Add(Func(Source{Source::Location{i, 2}}, name,
+                               ast::VariableList{}, ty.void_(),
+                               ast::StatementList{
+                                   create<ast::ReturnStatement>(),
+                               },
+                               ast::FunctionDecorationList{}));
+  }
+
+  EXPECT_TRUE(td()->Determine()) << td()->error();
+
+  ValidatorImpl& v = Build();
+  v.set_thread_count(4);
+
+  EXPECT_FALSE(v.Validate());
+  EXPECT_EQ(v.error(), "10:2 v-0016: function names must be unique 'f2'");
+}
+
 }  // namespace
 }  // namespace tint
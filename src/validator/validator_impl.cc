@@ -14,7 +14,10 @@
 
 #include "src/validator/validator_impl.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 
@@ -30,6 +33,7 @@
 #include "src/ast/switch_statement.h"
 #include "src/ast/uint_literal.h"
 #include "src/ast/variable_decl_statement.h"
+#include "src/program_builder.h"
 #include "src/type/alias_type.h"
 #include "src/type/array_type.h"
 #include "src/type/i32_type.h"
@@ -42,7 +46,26 @@
 
 namespace tint {
 
-ValidatorImpl::ValidatorImpl(const Program* program) : program_(program) {}
+ValidatorImpl::ValidatorImpl(const Program* program)
+    : program_(program),
+      module_(&program->AST()),
+      symbols_(&program->Symbols()) {}
+
+ValidatorImpl::ValidatorImpl(ProgramBuilder* builder)
+    : module_(&builder->AST()), symbols_(&builder->Symbols()) {}
+
+ValidatorImpl::ValidatorImpl(const ValidatorImpl& parent,
+                             const ast::FunctionList& funcs,
+                             size_t begin)
+    : program_(parent.program_),
+      module_(parent.module_),
+      symbols_(parent.symbols_),
+      variable_stack_(parent.variable_stack_),
+      function_stack_(parent.function_stack_) {
+  for (size_t i = 0; i < begin; i++) {
+    function_stack_.set(funcs[i]->symbol(), funcs[i]);
+  }
+}
 
 ValidatorImpl::~ValidatorImpl() = default;
 
@@ -62,21 +85,28 @@ void ValidatorImpl::add_error(const Source& src, const std::string& msg) {
 }
 
 bool ValidatorImpl::Validate() {
-  function_stack_.push_scope();
-  if (!ValidateGlobalVariables(program_->AST().GlobalVariables())) {
+  if (!BeginModule()) {
     return false;
   }
-  if (!ValidateConstructedTypes(program_->AST().ConstructedTypes())) {
+  if (!ValidateFunctions(module_->Functions())) {
     return false;
   }
-  if (!ValidateFunctions(program_->AST().Functions())) {
+  return EndModule();
+}
+
+bool ValidatorImpl::BeginModule() {
+  function_stack_.push_scope();
+  if (!ValidateGlobalVariables(module_->GlobalVariables())) {
     return false;
   }
-  if (!ValidateEntryPoint(program_->AST().Functions())) {
+  return ValidateConstructedTypes(module_->ConstructedTypes());
+}
+
+bool ValidatorImpl::EndModule() {
+  if (!ValidateEntryPoint(module_->Functions())) {
     return false;
   }
   function_stack_.pop_scope();
-
   return true;
 }
 
@@ -97,7 +127,7 @@ bool ValidatorImpl::ValidateConstructedTypes(
               add_error(member->source(), "v-0031",
                         "a struct containing a runtime-sized array "
                         "must be in the 'storage' storage class: '" +
-                            program_->Symbols().NameFor(st->symbol()) + "'");
+                            symbols_->NameFor(st->symbol()) + "'");
               return false;
             }
           }
@@ -114,7 +144,7 @@ bool ValidatorImpl::ValidateGlobalVariables(
     if (variable_stack_.has(var->symbol())) {
       add_error(var->source(), "v-0011",
                 "redeclared global identifier '" +
-                    program_->Symbols().NameFor(var->symbol()) + "'");
+                    symbols_->NameFor(var->symbol()) + "'");
       return false;
     }
     if (!var->is_const() && var->storage_class() == ast::StorageClass::kNone) {
@@ -134,25 +164,94 @@ bool ValidatorImpl::ValidateGlobalVariables(
 }
 
 bool ValidatorImpl::ValidateFunctions(const ast::FunctionList& funcs) {
-  for (auto* func : funcs) {
-    if (function_stack_.has(func->symbol())) {
-      add_error(func->source(), "v-0016",
-                "function names must be unique '" +
-                    program_->Symbols().NameFor(func->symbol()) + "'");
+  if (thread_count_ > 1 && funcs.size() > 1) {
+    return validate_functions_in_parallel(funcs);
+  }
+  return validate_function_range(funcs, 0, funcs.size());
+}
+
+bool ValidatorImpl::validate_function_range(const ast::FunctionList& funcs,
+                                            size_t begin,
+                                            size_t end) {
+  for (size_t i = begin; i < end; i++) {
+    auto* func = funcs[i];
+    if (!BeginFunction(func)) {
       return false;
     }
-
-    function_stack_.set(func->symbol(), func);
-    current_function_ = func;
-    if (!ValidateFunction(func)) {
+    if (!ValidateStatements(func->body())) {
+      return false;
+    }
+    if (!EndFunction(func)) {
       return false;
     }
-    current_function_ = nullptr;
   }
 
   return true;
 }
 
+bool ValidatorImpl::validate_functions_in_parallel(
+    const ast::FunctionList& funcs) {
+  // A function only depends on the module-scope declarations and on the
+  // names of the functions declared before it. The functions are split into
+  // contiguous ranges, and each range is validated by a worker that starts
+  // from the state the serial validator has at the start of the range. The
+  // diagnostics are merged in declaration order up to the first range that
+  // failed, so the output matches the serial validator's.
+  struct Range {
+    size_t begin = 0;
+    size_t end = 0;
+    bool success = false;
+    diag::List diags;
+  };
+
+  size_t thread_count = std::min<size_t>(thread_count_, funcs.size());
+  size_t range_count = std::min<size_t>(funcs.size(), thread_count * 4);
+  std::vector<Range> ranges(range_count);
+  for (size_t i = 0; i < range_count; i++) {
+    ranges[i].begin = funcs.size() * i / range_count;
+    ranges[i].end = funcs.size() * (i + 1) / range_count;
+  }
+
+  std::atomic<size_t> next_range{0};
+  std::atomic<size_t> first_failure{range_count};
+  auto worker = [&] {
+    for (size_t i = next_range++; i < range_count; i = next_range++) {
+      // The diagnostics of ranges after a failure are never reported.
+      if (i > first_failure) {
+        continue;
+      }
+      auto& range = ranges[i];
+      ValidatorImpl impl(*this, funcs, range.begin);
+      range.success =
+          impl.validate_function_range(funcs, range.begin, range.end);
+      range.diags = std::move(impl.diags_);
+      if (!range.success) {
+        auto failure = first_failure.load();
+        while (i < failure &&
+               !first_failure.compare_exchange_weak(failure, i)) {
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& range : ranges) {
+    diags_.add(range.diags);
+    if (!range.success) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ValidatorImpl::ValidateEntryPoint(const ast::FunctionList& funcs) {
   auto shader_is_present = false;
   for (auto* func : funcs) {
@@ -161,14 +260,14 @@ bool ValidatorImpl::ValidateEntryPoint(const ast::FunctionList& funcs) {
       if (!func->params().empty()) {
         add_error(func->source(), "v-0023",
                   "Entry point function must accept no parameters: '" +
-                      program_->Symbols().NameFor(func->symbol()) + "'");
+                      symbols_->NameFor(func->symbol()) + "'");
         return false;
       }
 
       if (!func->return_type()->Is<type::Void>()) {
         add_error(func->source(), "v-0024",
                   "Entry point function must return void: '" +
-                      program_->Symbols().NameFor(func->symbol()) + "'");
+                      symbols_->NameFor(func->symbol()) + "'");
         return false;
       }
       auto stage_deco_count = 0;
@@ -193,21 +292,31 @@ bool ValidatorImpl::ValidateEntryPoint(const ast::FunctionList& funcs) {
   return true;
 }
 
-bool ValidatorImpl::ValidateFunction(const ast::Function* func) {
-  variable_stack_.push_scope();
+bool ValidatorImpl::BeginFunction(const ast::Function* func) {
+  if (function_stack_.has(func->symbol())) {
+    add_error(func->source(), "v-0016",
+              "function names must be unique '" +
+                  symbols_->NameFor(func->symbol()) + "'");
+    return false;
+  }
 
+  function_stack_.set(func->symbol(), func);
+  current_function_ = func;
+
+  variable_stack_.push_scope();
   for (auto* param : func->params()) {
     variable_stack_.set(param->symbol(), param);
     if (!ValidateParameter(param)) {
       return false;
     }
   }
-  if (!ValidateStatements(func->body())) {
-    return false;
-  }
+  return true;
+}
+
+bool ValidatorImpl::EndFunction(const ast::Function* func) {
   variable_stack_.pop_scope();
 
-  if (!current_function_->return_type()->Is<type::Void>()) {
+  if (!func->return_type()->Is<type::Void>()) {
     if (!func->get_last_statement() ||
         !func->get_last_statement()->Is<ast::ReturnStatement>()) {
       add_error(func->source(), "v-0002",
@@ -215,6 +324,7 @@ bool ValidatorImpl::ValidateFunction(const ast::Function* func) {
       return false;
     }
   }
+  current_function_ = nullptr;
   return true;
 }
 
@@ -274,7 +384,7 @@ bool ValidatorImpl::ValidateDeclStatement(
     }
     add_error(
         decl->source(), error_code,
-        "redeclared identifier '" + program_->Symbols().NameFor(symbol) + "'");
+        "redeclared identifier '" + symbols_->NameFor(symbol) + "'");
     return false;
   }
   // TODO(dneto): Check type compatibility of the initializer.
@@ -414,13 +524,13 @@ bool ValidatorImpl::ValidateCallExpr(const ast::CallExpression* expr) {
       if (!function_stack_.has(symbol)) {
         add_error(expr->source(), "v-0005",
                   "function must be declared before use: '" +
-                      program_->Symbols().NameFor(symbol) + "'");
+                      symbols_->NameFor(symbol) + "'");
         return false;
       }
       if (symbol == current_function_->symbol()) {
         add_error(expr->source(), "v-0004",
                   "recursion is not allowed: '" +
-                      program_->Symbols().NameFor(symbol) + "'");
+                      symbols_->NameFor(symbol) + "'");
         return false;
       }
     }
@@ -446,14 +556,14 @@ bool ValidatorImpl::ValidateBadAssignmentToIdentifier(
     if (var->is_const()) {
       add_error(assign->source(), "v-0021",
                 "cannot re-assign a constant: '" +
-                    program_->Symbols().NameFor(ident->symbol()) + "'");
+                    symbols_->NameFor(ident->symbol()) + "'");
       return false;
     }
   } else {
     // The identifier is not defined. This should already have been caught
     // when validating the subexpression.
     add_error(ident->source(), "v-0006",
-              "'" + program_->Symbols().NameFor(ident->symbol()) +
+              "'" + symbols_->NameFor(ident->symbol()) +
                   "' is not declared");
     return false;
   }
@@ -525,7 +635,7 @@ bool ValidatorImpl::ValidateIdentifier(const ast::IdentifierExpression* ident) {
   ast::Variable* var;
   if (!variable_stack_.get(ident->symbol(), &var)) {
     add_error(ident->source(), "v-0006",
-              "'" + program_->Symbols().NameFor(ident->symbol()) +
+              "'" + symbols_->NameFor(ident->symbol()) +
                   "' is not declared");
     return false;
   }
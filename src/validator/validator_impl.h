@@ -37,19 +37,32 @@
 
 namespace tint {
 
+class ProgramBuilder;
+
 /// Determines if the program is complete and valid
 class ValidatorImpl {
  public:
   /// Constructor
   /// @param program the program to validate
   explicit ValidatorImpl(const Program* program);
+  /// Constructor for validating a program as it is being resolved. See
+  /// TypeDeterminer::set_validate().
+  /// @param builder the program builder
+  explicit ValidatorImpl(ProgramBuilder* builder);
   ~ValidatorImpl();
 
   /// Runs the validator
   /// @returns true if the validation was successful
   bool Validate();
 
-  /// @returns the program being validated
+  /// Sets the number of threads used to validate the function bodies. The
+  /// diagnostics do not depend on the number of threads.
+  /// @param count the number of threads. 0 or 1 validates all the functions
+  /// on the calling thread.
+  void set_thread_count(uint32_t count) { thread_count_ = count; }
+
+  /// @returns the program being validated, or nullptr if the validator was
+  /// constructed with a ProgramBuilder
   const Program* program() { return program_; }
 
   /// @returns the diagnostic messages
@@ -76,6 +89,25 @@ class ValidatorImpl {
   /// @param msg the error message
   void add_error(const Source& src, const std::string& msg);
 
+  /// Validates the module-scope declarations. Must be called before any
+  /// functions are validated.
+  /// @returns true if the validation was successful
+  bool BeginModule();
+  /// Validates the entry points, once all the functions have been validated
+  /// @returns true if the validation was successful
+  bool EndModule();
+  /// Validates the declaration of a function and its parameters, and opens
+  /// its scope. The function's statements are then validated with
+  /// ValidateStatement(), followed by a call to EndFunction().
+  /// @param func the function
+  /// @returns true if the validation was successful
+  bool BeginFunction(const ast::Function* func);
+  /// Closes the scope of a function opened by BeginFunction(), and validates
+  /// that non-void functions end with a return statement
+  /// @param func the function
+  /// @returns true if the validation was successful
+  bool EndFunction(const ast::Function* func);
+
   /// Validate global variables
   /// @param global_vars list of global variables to check
   /// @returns true if the validation was successful
@@ -84,10 +116,6 @@ class ValidatorImpl {
   /// @param funcs the functions to check
   /// @returns true if the validation was successful
   bool ValidateFunctions(const ast::FunctionList& funcs);
-  /// Validates a function
-  /// @param func the function to check
-  /// @returns true if the validation was successful
-  bool ValidateFunction(const ast::Function* func);
   /// Validates a function parameter
   /// @param param the function parameter to check
   /// @returns true if the validation was successful
@@ -163,11 +191,25 @@ class ValidatorImpl {
   }
 
  private:
-  const Program* program_;
+  /// Constructs a worker of validate_functions_in_parallel(), which
+  /// validates the functions of `funcs` starting at `begin`
+  ValidatorImpl(const ValidatorImpl& parent,
+                const ast::FunctionList& funcs,
+                size_t begin);
+
+  bool validate_function_range(const ast::FunctionList& funcs,
+                               size_t begin,
+                               size_t end);
+  bool validate_functions_in_parallel(const ast::FunctionList& funcs);
+
+  const Program* program_ = nullptr;
+  const ast::Module* module_;
+  const SymbolTable* symbols_;
   diag::List diags_;
   ScopeStack<ast::Variable*> variable_stack_;
-  ScopeStack<ast::Function*> function_stack_;
-  ast::Function* current_function_ = nullptr;
+  ScopeStack<const ast::Function*> function_stack_;
+  const ast::Function* current_function_ = nullptr;
+  uint32_t thread_count_ = 1;
 };
 
 }  // namespace tint
@@ -902,5 +902,106 @@ TEST_F(ValidatorTest, IsStorable_Struct_SomeMembersNonStorable) {
   EXPECT_FALSE(v.IsStorable(s_ty));
 }
 
+TEST_F(ValidatorTest, InlineValidation_Pass) {
+  // [[stage(vertex)]]
+  // fn my_func() -> void {
+  //  var a :i32 = 2;
+  //  a = 3;
+  // }
+  auto* func = Func(
+      "my_func", ast::VariableList{}, ty.void_(),
+      ast::StatementList{
+          create<ast::VariableDeclStatement>(
+              Var("a", ast::StorageClass::kNone, ty.i32(), Expr(2),
+                  ast::VariableDecorationList{})),
+          create<ast::AssignmentStatement>(Expr("a"), Expr(3)),
+      },
+      ast::FunctionDecorationList{
+          create<ast::StageDecoration>(ast::PipelineStage::kVertex),
+      });
+  AST().Functions().Add(func);
+
+  td()->set_validate(true);
+  EXPECT_TRUE(td()->Determine()) << td()->error();
+  EXPECT_FALSE(td()->validation_diagnostics().contains_errors());
+}
+
+TEST_F(ValidatorTest, InlineValidation_GlobalVariableNoStorageClass_Fail) {
+  // var global_var: f32;
+  AST().AddGlobalVariable(Var(Source{Source::Location{12, 34}}, "global_var",
+                              ast::StorageClass::kNone, ty.f32(), nullptr,
+                              ast::VariableDecorationList{}));
+
+  td()->set_validate(true);
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(),
+            "12:34 v-0022: global variables must have a storage class");
+}
+
+TEST_F(ValidatorTest, InlineValidation_RedeclaredIndentifier_Fail) {
+  // fn my_func() -> void {
+  //  var a :i32 = 2;
+  //  var a :f32 = 2.0;
+  // }
+  auto* var = Var("a", ast::StorageClass::kNone, ty.i32(), Expr(2),
+                  ast::VariableDecorationList{});
+
+  auto* var_a_float = Var("a", ast::StorageClass::kNone, ty.f32(), Expr(0.1f),
+                          ast::VariableDecorationList{});
+
+  auto* func = Func("my_func", ast::VariableList{}, ty.void_(),
+                    ast::StatementList{
+                        create<ast::VariableDeclStatement>(var),
+                        create<ast::VariableDeclStatement>(
+                            Source{Source::Location{12, 34}}, var_a_float),
+                    },
+                    ast::FunctionDecorationList{});
+  AST().Functions().Add(func);
+
+  td()->set_validate(true);
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(), "12:34 v-0014: redeclared identifier 'a'");
+
+  auto& diags = td()->validation_diagnostics();
+  ASSERT_EQ(diags.count(), 1u);
+  EXPECT_EQ(diags.begin()->code, std::string("v-0014"));
+  EXPECT_EQ(diags.begin()->source.range.begin.line, 12u);
+}
+
+TEST_F(ValidatorTest, InlineValidation_AssignToConstant_Fail) {
+  // fn my_func() -> void {
+  //  const a :i32 = 2;
+  //  a = 2
+  // }
+  auto* func = Func(
+      "my_func", ast::VariableList{}, ty.void_(),
+      ast::StatementList{
+          create<ast::VariableDeclStatement>(
+              Const("a", ast::StorageClass::kNone, ty.i32(), Expr(2),
+                    ast::VariableDecorationList{})),
+          create<ast::AssignmentStatement>(Source{Source::Location{12, 34}},
+                                           Expr("a"), Expr(2)),
+      },
+      ast::FunctionDecorationList{});
+  AST().Functions().Add(func);
+
+  td()->set_validate(true);
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(), "12:34 v-0021: cannot re-assign a constant: 'a'");
+}
+
+TEST_F(ValidatorTest, InlineValidation_NoEntryPoint_Fail) {
+  // fn my_func() -> void {}
+  AST().Functions().Add(Func("my_func", ast::VariableList{}, ty.void_(),
+                             ast::StatementList{},
+                             ast::FunctionDecorationList{}));
+
+  td()->set_validate(true);
+  EXPECT_FALSE(td()->Determine());
+  EXPECT_EQ(td()->error(),
+            "v-0003: At least one of vertex, fragment or compute shader must "
+            "be present");
+}
+
 }  // namespace
 }  // namespace tint
@@ -96,6 +96,15 @@ uint32_t adjust_for_alignment(uint32_t count, uint32_t alignment) {
   return count + alignment - spill;
 }
 
+/// @returns true if the overload selected for the intrinsic called by `ident`
+/// has float parameters
+bool is_float_overload(ast::IdentifierExpression* ident) {
+  auto* sig = static_cast<const ast::intrinsic::OverloadSignature*>(
+      ident->intrinsic_signature());
+  return sig != nullptr &&
+         sig->kind == ast::intrinsic::OverloadSignature::ScalarKind::kFloat;
+}
+
 }  // namespace
 
 GeneratorImpl::GeneratorImpl(const Program* program)
@@ -852,26 +861,23 @@ std::string GeneratorImpl::generate_builtin_name(
       out += program_->Symbols().NameFor(ident->symbol());
       break;
     case ast::Intrinsic::kAbs:
-      if (ident->result_type()->Is<type::F32>()) {
+      if (is_float_overload(ident)) {
         out += "fabs";
-      } else if (ident->result_type()->Is<type::U32>() ||
-                 ident->result_type()->Is<type::I32>()) {
+      } else {
         out += "abs";
       }
       break;
     case ast::Intrinsic::kMax:
-      if (ident->result_type()->Is<type::F32>()) {
+      if (is_float_overload(ident)) {
         out += "fmax";
-      } else if (ident->result_type()->Is<type::U32>() ||
-                 ident->result_type()->Is<type::I32>()) {
+      } else {
         out += "max";
       }
       break;
     case ast::Intrinsic::kMin:
-      if (ident->result_type()->Is<type::F32>()) {
+      if (is_float_overload(ident)) {
         out += "fmin";
-      } else if (ident->result_type()->Is<type::U32>() ||
-                 ident->result_type()->Is<type::I32>()) {
+      } else {
         out += "min";
       }
       break;
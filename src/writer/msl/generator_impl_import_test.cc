@@ -97,6 +97,26 @@ TEST_F(MslGeneratorImplTest, MslImportData_SingleParamTest_IntScalar) {
   EXPECT_EQ(gen.result(), R"(metal::abs(1))");
 }
 
+TEST_F(MslGeneratorImplTest, MslImportData_SingleParamTest_FloatVector) {
+  auto* expr = Call("abs", vec3<f32>(1.f, 2.f, 3.f));
+  ASSERT_TRUE(td.DetermineResultType(expr)) << td.error();
+
+  GeneratorImpl& gen = Build();
+
+  ASSERT_TRUE(gen.EmitCall(expr)) << gen.error();
+  EXPECT_EQ(gen.result(), R"(metal::fabs(float3(1.0f, 2.0f, 3.0f)))");
+}
+
+TEST_F(MslGeneratorImplTest, MslImportData_DualParamTest_UintVector) {
+  auto* expr = Call("max", vec2<u32>(1u, 2u), vec2<u32>(3u, 4u));
+  ASSERT_TRUE(td.DetermineResultType(expr)) << td.error();
+
+  GeneratorImpl& gen = Build();
+
+  ASSERT_TRUE(gen.EmitCall(expr)) << gen.error();
+  EXPECT_EQ(gen.result(), R"(metal::max(uint2(1u, 2u), uint2(3u, 4u)))");
+}
+
 using MslImportData_DualParamTest = TestParamHelper<MslImportData>;
 TEST_P(MslImportData_DualParamTest, FloatScalar) {
   auto param = GetParam();
@@ -14,7 +14,8 @@
 
 #include "src/writer/spirv/binary_writer.h"
 
-#include <cstring>
+#include "src/writer/spirv/compact_ids.h"
+#include "src/writer/spirv/dedup_functions.h"
 
 namespace tint {
 namespace writer {
@@ -30,46 +31,43 @@ BinaryWriter::BinaryWriter() = default;
 BinaryWriter::~BinaryWriter() = default;
 
 void BinaryWriter::WriteBuilder(Builder* builder) {
-  out_.reserve(builder->total_size());
-  builder->iterate(
-      [this](const Instruction& inst) { this->process_instruction(inst); });
+  out_.reserve(out_.size() + builder->total_size());
+  VectorOutputSink sink(&out_);
+  builder->Encode(&sink);
+}
+
+bool BinaryWriter::WriteEntryPoint(Builder* builder,
+                                   ast::Function* entry_point) {
+  VectorOutputSink sink(&out_);
+  return builder->EncodeEntryPoint(entry_point, &sink);
 }
 
 void BinaryWriter::WriteInstruction(const Instruction& inst) {
-  process_instruction(inst);
+  EncodeInstruction(inst.opcode(), inst.operands(), &out_);
 }
 
-void BinaryWriter::WriteHeader(uint32_t bound) {
-  out_.push_back(spv::MagicNumber);
-  out_.push_back(0x00010300);  // Version 1.3
-  out_.push_back(kGeneratorId);
-  out_.push_back(bound);
-  out_.push_back(0);
+bool BinaryWriter::Compact() {
+  return CompactIds(&out_);
 }
 
-void BinaryWriter::process_instruction(const Instruction& inst) {
-  out_.push_back(inst.word_length() << 16 |
-                 static_cast<uint32_t>(inst.opcode()));
-  for (const auto& op : inst.operands()) {
-    process_op(op);
-  }
+bool BinaryWriter::DedupFunctions() {
+  return spirv::DedupFunctions(&out_);
+}
+
+void BinaryWriter::WriteHeader(uint32_t bound) {
+  VectorOutputSink sink(&out_);
+  WriteHeader(bound, &sink);
 }
 
-void BinaryWriter::process_op(const Operand& op) {
-  if (op.IsFloat()) {
-    // Allocate space for the float
-    out_.push_back(0);
-    auto f = op.to_f();
-    uint8_t* ptr = reinterpret_cast<uint8_t*>(out_.data() + (out_.size() - 1));
-    memcpy(ptr, &f, 4);
-  } else if (op.IsInt()) {
-    out_.push_back(op.to_i());
-  } else {
-    auto idx = out_.size();
-    const auto& str = op.to_s();
-    out_.resize(out_.size() + op.length(), 0);
-    memcpy(out_.data() + idx, str.c_str(), str.size() + 1);
-  }
+void BinaryWriter::WriteHeader(uint32_t bound, OutputSink* sink) {
+  const uint32_t header[] = {
+      spv::MagicNumber,
+      0x00010300,  // Version 1.3
+      kGeneratorId,
+      bound,
+      0,
+  };
+  sink->Write(header, sizeof(header) / sizeof(header[0]));
 }
 
 }  // namespace spirv
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "src/writer/spirv/builder.h"
+#include "src/writer/spirv/output_sink.h"
 
 namespace tint {
 namespace writer {
@@ -34,23 +35,43 @@ class BinaryWriter {
   /// @param bound the bound to output
   void WriteHeader(uint32_t bound);
 
+  /// Writes the SPIR-V header to the given sink.
+  /// @param bound the bound to output
+  /// @param sink the sink to write to
+  static void WriteHeader(uint32_t bound, OutputSink* sink);
+
   /// Writes the given builder data into a binary. Note, this does not emit
   /// the SPIR-V header. You **must** call WriteHeader() before WriteBuilder()
   /// if you want the SPIR-V to be emitted.
   /// @param builder the builder to assemble from
   void WriteBuilder(Builder* builder);
 
+  /// Writes a module holding only the given entry point of the builder. See
+  /// Builder::EncodeEntryPoint(). As with WriteBuilder(), the SPIR-V header
+  /// is not emitted.
+  /// @param builder the builder to assemble from
+  /// @param entry_point the entry point function
+  /// @returns false if `entry_point` is not an entry point of the builder
+  bool WriteEntryPoint(Builder* builder, ast::Function* entry_point);
+
   /// Writes the given instruction into the binary.
   /// @param inst the instruction to assemble
   void WriteInstruction(const Instruction& inst);
 
+  /// Renumbers the IDs of the assembled SPIR-V to a dense range and shrinks
+  /// the bound in the header to match. See CompactIds().
+  /// @returns true if the IDs were renumbered
+  bool Compact();
+
+  /// Removes the duplicate functions of the assembled SPIR-V. See
+  /// DedupFunctions().
+  /// @returns true if the module was understood
+  bool DedupFunctions();
+
   /// @returns the assembled SPIR-V
   const std::vector<uint32_t>& result() const { return out_; }
 
  private:
-  void process_instruction(const Instruction& inst);
-  void process_op(const Operand& op);
-
   std::vector<uint32_t> out_;
 };
 
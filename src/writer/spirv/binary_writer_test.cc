@@ -18,7 +18,11 @@
 
 #include "gtest/gtest.h"
 #include "spirv/unified1/spirv.hpp11"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/stage_decoration.h"
 #include "src/writer/spirv/builder.h"
+#include "src/writer/spirv/generator.h"
+#include "src/writer/spirv/output_sink.h"
 #include "src/writer/spirv/test_helper.h"
 
 namespace tint {
@@ -131,6 +135,58 @@ TEST_F(BinaryWriterTest, TestInstructionWriter) {
   EXPECT_EQ(res[3], 4u);
 }
 
+TEST_F(BinaryWriterTest, HeaderToSink) {
+  std::vector<uint32_t> words;
+  VectorOutputSink sink(&words);
+  BinaryWriter::WriteHeader(5, &sink);
+
+  BinaryWriter bw;
+  bw.WriteHeader(5);
+  EXPECT_EQ(words, bw.result());
+}
+
+TEST_F(BinaryWriterTest, GenerateToSink_MatchesResult) {
+  // Records every span written to it, so the test can check that the module
+  // arrives in more than one piece.
+  class SpanSink : public OutputSink {
+   public:
+    void Write(const uint32_t* w, size_t count) override {
+      words.insert(words.end(), w, w + count);
+      spans++;
+    }
+    std::vector<uint32_t> words;
+    size_t spans = 0;
+  };
+
+  auto* g = Var("g", ast::StorageClass::kPrivate, ty.f32(), Expr(1.5f),
+                ast::VariableDecorationList{});
+  AST().AddGlobalVariable(g);
+
+  auto* func =
+      Func("main", ast::VariableList{}, ty.void_(),
+           ast::StatementList{
+               create<ast::AssignmentStatement>(Expr("g"), Expr(2.5f)),
+           },
+           ast::FunctionDecorationList{
+               create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+           });
+  AST().Functions().Add(func);
+
+  ASSERT_TRUE(td.Determine()) << td.error();
+  Build();
+
+  Generator expected(built_program());
+  ASSERT_TRUE(expected.Generate()) << expected.error();
+
+  SpanSink sink;
+  Generator streamed(built_program());
+  ASSERT_TRUE(streamed.Generate(&sink)) << streamed.error();
+
+  EXPECT_EQ(sink.words, expected.result());
+  EXPECT_GT(sink.spans, 1u);
+  EXPECT_TRUE(streamed.result().empty());
+}
+
 }  // namespace
 }  // namespace spirv
 }  // namespace writer
@@ -14,6 +14,7 @@
 #include "src/writer/spirv/builder.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -93,6 +94,17 @@ uint32_t size_of(const InstructionList& instructions) {
   return size;
 }
 
+void encode(const InstructionList& instructions, OutputSink* sink) {
+  if (instructions.empty()) {
+    return;
+  }
+  std::vector<uint32_t> words;
+  for (const auto& inst : instructions) {
+    EncodeInstruction(inst.opcode(), inst.operands(), &words);
+  }
+  sink->Write(words.data(), words.size());
+}
+
 uint32_t pipeline_stage_to_execution_model(ast::PipelineStage stage) {
   SpvExecutionModel model = SpvExecutionModelVertex;
 
@@ -162,10 +174,12 @@ type::Matrix* GetNestedMatrixType(type::Type* type) {
   return type->As<type::Matrix>();
 }
 
-uint32_t intrinsic_to_glsl_method(type::Type* type, ast::Intrinsic intrinsic) {
+using ScalarKind = ast::intrinsic::OverloadSignature::ScalarKind;
+
+uint32_t intrinsic_to_glsl_method(ScalarKind kind, ast::Intrinsic intrinsic) {
   switch (intrinsic) {
     case ast::Intrinsic::kAbs:
-      if (type->is_float_scalar_or_vector()) {
+      if (kind == ScalarKind::kFloat) {
         return GLSLstd450FAbs;
       } else {
         return GLSLstd450SAbs;
@@ -181,9 +195,9 @@ uint32_t intrinsic_to_glsl_method(type::Type* type, ast::Intrinsic intrinsic) {
     case ast::Intrinsic::kCeil:
       return GLSLstd450Ceil;
     case ast::Intrinsic::kClamp:
-      if (type->is_float_scalar_or_vector()) {
+      if (kind == ScalarKind::kFloat) {
         return GLSLstd450NClamp;
-      } else if (type->is_unsigned_scalar_or_vector()) {
+      } else if (kind == ScalarKind::kUnsignedInteger) {
         return GLSLstd450UClamp;
       } else {
         return GLSLstd450SClamp;
@@ -223,17 +237,17 @@ uint32_t intrinsic_to_glsl_method(type::Type* type, ast::Intrinsic intrinsic) {
     case ast::Intrinsic::kLog2:
       return GLSLstd450Log2;
     case ast::Intrinsic::kMax:
-      if (type->is_float_scalar_or_vector()) {
+      if (kind == ScalarKind::kFloat) {
         return GLSLstd450NMax;
-      } else if (type->is_unsigned_scalar_or_vector()) {
+      } else if (kind == ScalarKind::kUnsignedInteger) {
         return GLSLstd450UMax;
       } else {
         return GLSLstd450SMax;
       }
     case ast::Intrinsic::kMin:
-      if (type->is_float_scalar_or_vector()) {
+      if (kind == ScalarKind::kFloat) {
         return GLSLstd450NMin;
-      } else if (type->is_unsigned_scalar_or_vector()) {
+      } else if (kind == ScalarKind::kUnsignedInteger) {
         return GLSLstd450UMin;
       } else {
         return GLSLstd450SMin;
@@ -282,6 +296,21 @@ type::Type* ElementTypeOf(type::Type* ty) {
   return ty;
 }
 
+/// @returns `vec[index]`, or a zero value if `index` is out of range
+template <typename T>
+T GetDense(const std::vector<T>& vec, size_t index) {
+  return index < vec.size() ? vec[index] : T{};
+}
+
+/// Sets `vec[index]` to `value`, growing `vec` with zero values as needed
+template <typename T>
+void SetDense(std::vector<T>* vec, size_t index, T value) {
+  if (index >= vec->size()) {
+    vec->resize(index + 1);
+  }
+  (*vec)[index] = value;
+}
+
 }  // namespace
 
 Builder::AccessorInfo::AccessorInfo() : source_id(0), source_type(nullptr) {}
@@ -290,11 +319,18 @@ Builder::AccessorInfo::~AccessorInfo() {}
 
 Builder::Builder(const Program* program)
     : program_(program),
-      type_mgr_(type::Manager::Wrap(program->Types())),
-      scope_stack_({}) {}
+      type_mgr_(type::Manager::Wrap(program->Types())) {}
 
 Builder::~Builder() = default;
 
+size_t Builder::ScalarConstantKey::Hasher::operator()(
+    const ScalarConstantKey& key) const {
+  uint64_t hash = (static_cast<uint64_t>(key.type_id) << 32) | key.value;
+  hash ^= (static_cast<uint64_t>(key.kind) << 1 | (key.is_spec ? 1 : 0))
+          << 59;
+  return std::hash<uint64_t>()(hash);
+}
+
 bool Builder::Build() {
   push_capability(SpvCapabilityShader);
 
@@ -325,15 +361,12 @@ uint32_t Builder::total_size() const {
   // The 5 covers the magic, version, generator, id bound and reserved.
   uint32_t size = 5;
 
-  size += size_of(capabilities_);
-  size += size_of(extensions_);
-  size += size_of(ext_imports_);
-  size += size_of(memory_model_);
-  size += size_of(entry_points_);
-  size += size_of(execution_modes_);
-  size += size_of(debug_);
-  size += size_of(annotations_);
-  size += size_of(types_);
+  for (const Section* section :
+       {&capabilities_, &extensions_, &ext_imports_, &memory_model_,
+        &entry_points_, &execution_modes_, &debug_, &annotations_, &types_}) {
+    size += size_of(section->instructions) +
+            static_cast<uint32_t>(section->words.size());
+  }
   for (const auto& func : functions_) {
     size += func.word_length();
   }
@@ -342,31 +375,31 @@ uint32_t Builder::total_size() const {
 }
 
 void Builder::iterate(std::function<void(const Instruction&)> cb) const {
-  for (const auto& inst : capabilities_) {
+  for (const auto& inst : capabilities_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : extensions_) {
+  for (const auto& inst : extensions_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : ext_imports_) {
+  for (const auto& inst : ext_imports_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : memory_model_) {
+  for (const auto& inst : memory_model_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : entry_points_) {
+  for (const auto& inst : entry_points_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : execution_modes_) {
+  for (const auto& inst : execution_modes_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : debug_) {
+  for (const auto& inst : debug_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : annotations_) {
+  for (const auto& inst : annotations_.instructions) {
     cb(inst);
   }
-  for (const auto& inst : types_) {
+  for (const auto& inst : types_.instructions) {
     cb(inst);
   }
   for (const auto& func : functions_) {
@@ -374,11 +407,116 @@ void Builder::iterate(std::function<void(const Instruction&)> cb) const {
   }
 }
 
+void Builder::Encode(OutputSink* sink) const {
+  for (const Section* section :
+       {&capabilities_, &extensions_, &ext_imports_, &memory_model_,
+        &entry_points_, &execution_modes_, &debug_, &annotations_, &types_}) {
+    encode(section->instructions, sink);
+    if (!section->words.empty()) {
+      sink->Write(section->words.data(), section->words.size());
+    }
+  }
+  for (const auto& func : functions_) {
+    func.Encode(sink);
+  }
+}
+
+bool Builder::EncodeEntryPoint(ast::Function* entry_point,
+                               OutputSink* sink) const {
+  auto entry_point_id =
+      GetDense(func_symbol_to_id_, entry_point->symbol().value());
+  if (!entry_point->IsEntryPoint() || entry_point_id == 0) {
+    return false;
+  }
+
+  std::unordered_set<uint32_t> unreachable;
+  for (auto* func : program_->AST().Functions()) {
+    if (func == entry_point ||
+        func->HasAncestorEntryPoint(entry_point->symbol())) {
+      continue;
+    }
+    auto id = GetDense(func_symbol_to_id_, func->symbol().value());
+    if (id != 0) {
+      unreachable.insert(id);
+    }
+  }
+
+  // Writes the instructions of `section` for which `keep` returns true. Only
+  // the sections that refer to functions are filtered, and they are small, so
+  // they are collected before being written.
+  std::vector<uint32_t> words;
+  auto filter = [&](const Section& section,
+                    std::function<bool(const uint32_t*)> keep) {
+    std::vector<uint32_t> all;
+    for (const auto& inst : section.instructions) {
+      EncodeInstruction(inst.opcode(), inst.operands(), &all);
+    }
+    all.insert(all.end(), section.words.begin(), section.words.end());
+
+    words.clear();
+    for (size_t i = 0; i < all.size();) {
+      auto count = all[i] >> 16;
+      if (keep(&all[i])) {
+        words.insert(words.end(), all.begin() + i, all.begin() + i + count);
+      }
+      i += count;
+    }
+    if (!words.empty()) {
+      sink->Write(words.data(), words.size());
+    }
+  };
+  // Word 1 of the debug instructions and annotations is the target ID
+  auto keep_target = [&](const uint32_t* inst) {
+    auto id = inst[1];
+    return id >= local_id_to_function_.size() ||
+           unreachable.count(local_id_to_function_[id]) == 0;
+  };
+
+  for (const Section* section :
+       {&capabilities_, &extensions_, &ext_imports_, &memory_model_}) {
+    encode(section->instructions, sink);
+    if (!section->words.empty()) {
+      sink->Write(section->words.data(), section->words.size());
+    }
+  }
+  // OpEntryPoint <model> <function> ...
+  filter(entry_points_, [&](const uint32_t* inst) {
+    return inst[2] == entry_point_id;
+  });
+  // OpExecutionMode <function> ...
+  filter(execution_modes_, [&](const uint32_t* inst) {
+    return inst[1] == entry_point_id;
+  });
+  filter(debug_, keep_target);
+  filter(annotations_, keep_target);
+
+  encode(types_.instructions, sink);
+  if (!types_.words.empty()) {
+    sink->Write(types_.words.data(), types_.words.size());
+  }
+
+  for (const auto& func : functions_) {
+    const auto& decl = func.declaration().operands();
+    if (decl.size() > 1 && unreachable.count(decl[1].to_i()) != 0) {
+      continue;
+    }
+    func.Encode(sink);
+  }
+  return true;
+}
+
+void Builder::push(Section* section, spv::Op op, OperandList operands) {
+  if (encode_words_) {
+    EncodeInstruction(op, operands, &section->words);
+  } else {
+    section->instructions.push_back(Instruction{op, std::move(operands)});
+  }
+}
+
 void Builder::push_capability(uint32_t cap) {
   if (capability_set_.count(cap) == 0) {
     capability_set_.insert(cap);
-    capabilities_.push_back(
-        Instruction{spv::Op::OpCapability, {Operand::Int(cap)}});
+    push(&capabilities_, spv::Op::OpCapability, {Operand::Int(cap)});
   }
 }
 
@@ -387,12 +525,13 @@ bool Builder::GenerateLabel(uint32_t id) {
     return false;
   }
   current_label_id_ = id;
+  block_count_++;
+  reset_block_state();
   return true;
 }
 
 uint32_t Builder::GenerateU32Literal(uint32_t val) {
-  type::U32 u32;
-  ast::SintLiteral lit(Source{}, &u32, val);
+  ast::SintLiteral lit(Source{}, type_mgr_.Get<type::U32>(), val);
   return GenerateLiteralIfNeeded(nullptr, &lit);
 }
 
@@ -545,6 +684,8 @@ bool Builder::GenerateFunction(ast::Function* func) {
 
   auto func_op = result_op();
   auto func_id = func_op.to_i();
+  current_function_id_ = func_id;
+  set_id_owner(func_id, func_id);
 
   push_debug(spv::Op::OpName,
              {Operand::Int(func_id),
@@ -572,6 +713,7 @@ bool Builder::GenerateFunction(ast::Function* func) {
       return false;
     }
 
+    set_id_owner(param_id, func_id);
     push_debug(spv::Op::OpName,
                {Operand::Int(param_id),
                 Operand::String(program_->Symbols().NameFor(param->symbol()))});
@@ -599,8 +741,9 @@ bool Builder::GenerateFunction(ast::Function* func) {
   }
 
   scope_stack_.pop_scope();
+  current_function_id_ = 0;
 
-  func_symbol_to_id_[func->symbol()] = func_id;
+  SetDense(&func_symbol_to_id_, func->symbol().value(), func_id);
 
   return true;
 }
@@ -650,19 +793,21 @@ bool Builder::GenerateFunctionVariable(ast::Variable* var) {
       return false;
     }
     scope_stack_.set(var->symbol(), init_id);
-    spirv_id_to_variable_[init_id] = var;
     return true;
   }
 
   auto result = result_op();
   auto var_id = result.to_i();
   auto sc = ast::StorageClass::kFunction;
-  type::Pointer pt(var->type(), sc);
-  auto type_id = GenerateTypeIfNeeded(&pt);
+  auto type_id =
+      GenerateTypeIfNeeded(type_mgr_.Get<type::Pointer>(var->type(), sc));
   if (type_id == 0) {
     return false;
   }
 
+  if (current_function_id_ != 0) {
+    set_id_owner(var_id, current_function_id_);
+  }
   push_debug(spv::Op::OpName,
              {Operand::Int(var_id),
               Operand::String(program_->Symbols().NameFor(var->symbol()))});
@@ -685,12 +830,20 @@ bool Builder::GenerateFunctionVariable(ast::Variable* var) {
   }
 
   scope_stack_.set(var->symbol(), var_id);
-  spirv_id_to_variable_[var_id] = var;
 
   return true;
 }
 
 bool Builder::GenerateStore(uint32_t to, uint32_t from) {
+  if (optimize_memory_accesses_) {
+    auto root = GetDense(access_chain_root_, to);
+    if (root != 0) {
+      // Only part of the root variable is written, so its value is unknown.
+      SetDense(&block_var_values_, root, 0u);
+    } else if (GetDense(function_vars_, to)) {
+      set_block_var_value(to, from);
+    }
+  }
   return push_function_inst(spv::Op::OpStore,
                             {Operand::Int(to), Operand::Int(from)});
 }
@@ -698,13 +851,25 @@ bool Builder::GenerateStore(uint32_t to, uint32_t from) {
 bool Builder::GenerateGlobalVariable(ast::Variable* var) {
   uint32_t init_id = 0;
   if (var->has_constructor()) {
-    if (!var->constructor()->Is<ast::ConstructorExpression>()) {
-      error_ = "scalar constructor expected";
-      return false;
+    if (auto* ctor = var->constructor()->As<ast::ConstructorExpression>()) {
+      init_id = GenerateConstructorExpression(var, ctor, true);
+    } else {
+      // An expression of constants, which is folded to its value. This is
+      // rare, so the evaluator is only created when needed.
+      std::unique_ptr<ast::ConstantValue> value;
+      if (!var->HasConstantIdDecoration()) {
+        if (!constant_evaluator_) {
+          constant_evaluator_ = std::make_unique<ConstantEvaluator>(
+              &program_->AST(), &program_->Symbols());
+        }
+        value = constant_evaluator_->Evaluate(var->constructor());
+      }
+      if (value == nullptr) {
+        error_ = "scalar constructor expected";
+        return false;
+      }
+      init_id = GenerateConstantValue(value->type(), value->elements().data());
     }
-
-    init_id = GenerateConstructorExpression(
-        var, var->constructor()->As<ast::ConstructorExpression>(), true);
     if (init_id == 0) {
       return false;
     }
@@ -720,7 +885,6 @@ bool Builder::GenerateGlobalVariable(ast::Variable* var) {
                 Operand::String(program_->Symbols().NameFor(var->symbol()))});
 
     scope_stack_.set_global(var->symbol(), init_id);
-    spirv_id_to_variable_[init_id] = var;
     return true;
   }
 
@@ -731,8 +895,8 @@ bool Builder::GenerateGlobalVariable(ast::Variable* var) {
                 ? ast::StorageClass::kPrivate
                 : var->storage_class();
 
-  type::Pointer pt(var->type(), sc);
-  auto type_id = GenerateTypeIfNeeded(&pt);
+  auto type_id =
+      GenerateTypeIfNeeded(type_mgr_.Get<type::Pointer>(var->type(), sc));
   if (type_id == 0) {
     return false;
   }
@@ -835,7 +999,6 @@ bool Builder::GenerateGlobalVariable(ast::Variable* var) {
   }
 
   scope_stack_.set_global(var->symbol(), var_id);
-  spirv_id_to_variable_[var_id] = var;
   return true;
 }
 
@@ -966,16 +1129,9 @@ bool Builder::GenerateMemberAccessor(ast::MemberAccessorExpression* expr,
     if (result_type_id == 0) {
       return 0;
     }
-    auto extract = result_op();
-    auto extract_id = extract.to_i();
-
-    OperandList ops = {Operand::Int(result_type_id), extract,
-                       Operand::Int(info->source_id)};
-    for (auto id : info->access_chain_indices) {
-      ops.push_back(Operand::Int(id));
-    }
-
-    if (!push_function_inst(spv::Op::OpAccessChain, ops)) {
+    auto extract_id = GenerateAccessChain(result_type_id, info->source_id,
+                                          info->access_chain_indices);
+    if (extract_id == 0) {
       return false;
     }
 
@@ -1053,8 +1209,8 @@ uint32_t Builder::GenerateAccessorExpression(ast::Expression* expr) {
     if (!ary_res_type->Is<type::Pointer>() &&
         (ary_res_type->Is<type::Array>() &&
          !ary_res_type->As<type::Array>()->type()->is_scalar())) {
-      type::Pointer ptr(ary_res_type, ast::StorageClass::kFunction);
-      auto result_type_id = GenerateTypeIfNeeded(&ptr);
+      auto result_type_id = GenerateTypeIfNeeded(type_mgr_.Get<type::Pointer>(
+          ary_res_type, ast::StorageClass::kFunction));
       if (result_type_id == 0) {
         return 0;
       }
@@ -1070,8 +1226,7 @@ uint32_t Builder::GenerateAccessorExpression(ast::Expression* expr) {
            Operand::Int(ConvertStorageClass(ast::StorageClass::kFunction)),
            Operand::Int(init)});
 
-      if (!push_function_inst(spv::Op::OpStore,
-                              {ary_result, Operand::Int(info.source_id)})) {
+      if (!GenerateStore(ary_result.to_i(), info.source_id)) {
         return false;
       }
 
@@ -1102,17 +1257,10 @@ uint32_t Builder::GenerateAccessorExpression(ast::Expression* expr) {
       return 0;
     }
 
-    auto result = result_op();
-    auto result_id = result.to_i();
-
-    OperandList ops = {Operand::Int(result_type_id), result,
-                       Operand::Int(info.source_id)};
-    for (auto id : info.access_chain_indices) {
-      ops.push_back(Operand::Int(id));
-    }
-
-    if (!push_function_inst(spv::Op::OpAccessChain, ops)) {
-      return false;
+    auto result_id = GenerateAccessChain(result_type_id, info.source_id,
+                                         info.access_chain_indices);
+    if (result_id == 0) {
+      return 0;
     }
     info.source_id = result_id;
   }
@@ -1137,6 +1285,14 @@ uint32_t Builder::GenerateLoadIfNeeded(type::Type* type, uint32_t id) {
     return id;
   }
 
+  bool forward = optimize_memory_accesses_ && GetDense(function_vars_, id);
+  if (forward) {
+    auto val = GetDense(block_var_values_, id);
+    if (val != 0) {
+      return val;
+    }
+  }
+
   auto type_id = GenerateTypeIfNeeded(type->UnwrapPtrIfNeeded());
   auto result = result_op();
   auto result_id = result.to_i();
@@ -1144,6 +1300,46 @@ uint32_t Builder::GenerateLoadIfNeeded(type::Type* type, uint32_t id) {
                           {Operand::Int(type_id), result, Operand::Int(id)})) {
     return false;
   }
+  if (forward) {
+    set_block_var_value(id, result_id);
+  }
+  return result_id;
+}
+
+uint32_t Builder::GenerateAccessChain(uint32_t result_type_id,
+                                      uint32_t base_id,
+                                      const std::vector<uint32_t>& indices) {
+  CompositeKey key;
+  if (optimize_memory_accesses_) {
+    key.reserve(indices.size() + 2);
+    key.push_back(result_type_id);
+    key.push_back(base_id);
+    key.insert(key.end(), indices.begin(), indices.end());
+    // The operands are all IDs, and any earlier instruction in the same basic
+    // block dominates this one, so an identical chain yields the same pointer.
+    auto it = block_access_chains_.find(key);
+    if (it != block_access_chains_.end()) {
+      return it->second;
+    }
+  }
+
+  auto result = result_op();
+  auto result_id = result.to_i();
+
+  OperandList ops = {Operand::Int(result_type_id), result,
+                     Operand::Int(base_id)};
+  for (auto id : indices) {
+    ops.push_back(Operand::Int(id));
+  }
+  if (!push_function_inst(spv::Op::OpAccessChain, std::move(ops))) {
+    return 0;
+  }
+
+  if (optimize_memory_accesses_) {
+    auto root = GetDense(access_chain_root_, base_id);
+    SetDense(&access_chain_root_, result_id, root != 0 ? root : base_id);
+    block_access_chains_.emplace(std::move(key), result_id);
+  }
   return result_id;
 }
 
@@ -1186,7 +1382,7 @@ uint32_t Builder::GenerateUnaryOpExpression(ast::UnaryOpExpression* expr) {
 }
 
 void Builder::GenerateGLSLstd450Import() {
-  if (import_name_to_id_.find(kGLSLstd450) != import_name_to_id_.end()) {
+  if (glsl_std450_import_id_ != 0) {
     return;
   }
 
@@ -1196,7 +1392,7 @@ void Builder::GenerateGLSLstd450Import() {
   push_ext_import(spv::Op::OpExtInstImport,
                   {result, Operand::String(kGLSLstd450)});
 
-  import_name_to_id_[kGLSLstd450] = id;
+  glsl_std450_import_id_ = id;
 }
 
 uint32_t Builder::GenerateConstructorExpression(
@@ -1280,9 +1476,6 @@ uint32_t Builder::GenerateTypeConstructorExpression(
     return GenerateLiteralIfNeeded(nullptr, &nl);
   }
 
-  std::ostringstream out;
-  out << "__const";
-
   auto* result_type = init->type()->UnwrapAll();
   bool constructor_is_const = is_constructor_const(init, is_global_init);
   if (has_error()) {
@@ -1338,8 +1531,6 @@ uint32_t Builder::GenerateTypeConstructorExpression(
     // value type is a correctly sized vector so we can just use it directly.
     if (result_type == value_type || result_type->Is<type::Matrix>() ||
         result_type->Is<type::Array>() || result_type->Is<type::Struct>()) {
-      out << "_" << id;
-
       ops.push_back(Operand::Int(id));
       continue;
     }
@@ -1348,7 +1539,6 @@ uint32_t Builder::GenerateTypeConstructorExpression(
     // of the value.
     if (value_type->is_scalar() && result_type->is_scalar()) {
       id = GenerateCastOrCopyOrPassthrough(result_type, values[0]);
-      out << "_" << id;
       ops.push_back(Operand::Int(id));
       continue;
     }
@@ -1399,7 +1589,6 @@ uint32_t Builder::GenerateTypeConstructorExpression(
           result_is_spec_composite = true;
         }
 
-        out << "_" << extract_id;
         ops.push_back(Operand::Int(extract_id));
       }
     } else {
@@ -1408,9 +1597,13 @@ uint32_t Builder::GenerateTypeConstructorExpression(
     }
   }
 
-  auto str = out.str();
-  auto val = const_to_id_.find(str);
-  if (val != const_to_id_.end()) {
+  CompositeKey key{type_id};
+  key.reserve(ops.size() + 1);
+  for (const auto& op : ops) {
+    key.push_back(op.to_i());
+  }
+  auto val = composite_to_id_.find(key);
+  if (val != composite_to_id_.end()) {
     return val->second;
   }
 
@@ -1418,7 +1611,7 @@ uint32_t Builder::GenerateTypeConstructorExpression(
   ops.insert(ops.begin(), result);
   ops.insert(ops.begin(), Operand::Int(type_id));
 
-  const_to_id_[str] = result.to_i();
+  composite_to_id_[std::move(key)] = result.to_i();
 
   if (result_is_spec_composite) {
     push_type(spv::Op::OpSpecConstantComposite, ops);
@@ -1502,15 +1695,27 @@ uint32_t Builder::GenerateLiteralIfNeeded(ast::Variable* var,
     return 0;
   }
 
-  auto name = lit->name();
-  bool is_spec_constant = false;
-  if (var && var->HasConstantIdDecoration()) {
-    name = "__spec" + name;
-    is_spec_constant = true;
+  ScalarConstantKey key;
+  key.type_id = type_id;
+  key.is_spec = var && var->HasConstantIdDecoration();
+  if (auto* l = lit->As<ast::BoolLiteral>()) {
+    key.kind = ScalarConstantKey::Kind::kBool;
+    key.value = l->IsTrue() ? 1u : 0u;
+  } else if (auto* sl = lit->As<ast::SintLiteral>()) {
+    key.kind = ScalarConstantKey::Kind::kSint;
+    key.value = static_cast<uint32_t>(sl->value());
+  } else if (auto* ul = lit->As<ast::UintLiteral>()) {
+    key.kind = ScalarConstantKey::Kind::kUint;
+    key.value = ul->value();
+  } else if (auto* fl = lit->As<ast::FloatLiteral>()) {
+    key.kind = ScalarConstantKey::Kind::kFloat;
+    auto f = fl->value();
+    memcpy(&key.value, &f, sizeof(key.value));
   }
+  bool is_spec_constant = key.is_spec;
 
-  auto val = const_to_id_.find(name);
-  if (val != const_to_id_.end()) {
+  auto val = scalar_constant_to_id_.find(key);
+  if (val != scalar_constant_to_id_.end()) {
     return val->second;
   }
 
@@ -1549,10 +1754,87 @@ uint32_t Builder::GenerateLiteralIfNeeded(ast::Variable* var,
     return 0;
   }
 
-  const_to_id_[name] = result_id;
+  scalar_constant_to_id_[key] = result_id;
   return result_id;
 }
 
+uint32_t Builder::GenerateConstantValue(
+    type::Type* type,
+    const ast::ConstantValue::Scalar* elements) {
+  if (auto* mat = type->As<type::Matrix>()) {
+    // Matrix values are stored column-major
+    auto* column = type_mgr_.Get<type::Vector>(mat->type(), mat->rows());
+    return GenerateConstantComposite(
+        type, mat->columns(), [&](uint32_t i) {
+          return GenerateConstantValue(column, elements + i * mat->rows());
+        });
+  }
+  if (auto* vec = type->As<type::Vector>()) {
+    return GenerateConstantComposite(type, vec->size(), [&](uint32_t i) {
+      return GenerateConstantValue(vec->type(), elements + i);
+    });
+  }
+
+  auto& el = elements[0];
+  if (type->Is<type::Bool>()) {
+    ast::BoolLiteral lit(Source{}, type, el.b);
+    return GenerateLiteralIfNeeded(nullptr, &lit);
+  }
+  if (type->Is<type::I32>()) {
+    ast::SintLiteral lit(Source{}, type, el.i32);
+    return GenerateLiteralIfNeeded(nullptr, &lit);
+  }
+  if (type->Is<type::U32>()) {
+    ast::UintLiteral lit(Source{}, type, el.u32);
+    return GenerateLiteralIfNeeded(nullptr, &lit);
+  }
+  if (type->Is<type::F32>()) {
+    ast::FloatLiteral lit(Source{}, type, el.f32);
+    return GenerateLiteralIfNeeded(nullptr, &lit);
+  }
+
+  error_ = "unknown constant value type";
+  return 0;
+}
+
+template <typename F>
+uint32_t Builder::GenerateConstantComposite(type::Type* type,
+                                            uint32_t count,
+                                            F&& generate_element) {
+  auto type_id = GenerateTypeIfNeeded(type);
+  if (type_id == 0) {
+    return 0;
+  }
+
+  CompositeKey key{type_id};
+  key.reserve(count + 1);
+  for (uint32_t i = 0; i < count; i++) {
+    auto id = generate_element(i);
+    if (id == 0) {
+      return 0;
+    }
+    key.push_back(id);
+  }
+
+  auto val = composite_to_id_.find(key);
+  if (val != composite_to_id_.end()) {
+    return val->second;
+  }
+
+  auto result = result_op();
+  OperandList ops;
+  ops.reserve(key.size() + 1);
+  ops.push_back(Operand::Int(type_id));
+  ops.push_back(result);
+  for (uint32_t i = 1; i < key.size(); i++) {
+    ops.push_back(Operand::Int(key[i]));
+  }
+  push_type(spv::Op::OpConstantComposite, std::move(ops));
+
+  composite_to_id_[std::move(key)] = result.to_i();
+  return result.to_i();
+}
+
 uint32_t Builder::GenerateShortCircuitBinaryExpression(
     ast::BinaryExpression* expr) {
   auto lhs_id = GenerateExpression(expr->lhs());
@@ -1818,7 +2100,7 @@ uint32_t Builder::GenerateCallExpression(ast::CallExpression* expr) {
 
   OperandList ops = {Operand::Int(type_id), result};
 
-  auto func_id = func_symbol_to_id_[ident->symbol()];
+  auto func_id = GetDense(func_symbol_to_id_, ident->symbol().value());
   if (func_id == 0) {
     error_ = "unable to find called function: " +
              program_->Symbols().NameFor(ident->symbol());
@@ -1944,14 +2226,19 @@ uint32_t Builder::GenerateIntrinsic(ast::IdentifierExpression* ident,
   } else {
     GenerateGLSLstd450Import();
 
-    auto set_iter = import_name_to_id_.find(kGLSLstd450);
-    if (set_iter == import_name_to_id_.end()) {
+    auto set_id = glsl_std450_import_id_;
+    if (set_id == 0) {
       error_ = std::string("unknown import ") + kGLSLstd450;
       return 0;
     }
-    auto set_id = set_iter->second;
-    auto inst_id =
-        intrinsic_to_glsl_method(ident->result_type(), ident->intrinsic());
+    auto* sig = static_cast<const ast::intrinsic::OverloadSignature*>(
+        ident->intrinsic_signature());
+    if (sig == nullptr) {
+      error_ = "missing overload signature for " +
+               program_->Symbols().NameFor(ident->symbol());
+      return 0;
+    }
+    auto inst_id = intrinsic_to_glsl_method(sig->kind, ident->intrinsic());
     if (inst_id == 0) {
       error_ = "unknown method " + program_->Symbols().NameFor(ident->symbol());
       return 0;
@@ -2349,8 +2636,7 @@ bool Builder::GenerateTextureIntrinsic(ast::IdentifierExpression* ident,
       assert(pidx.depth_ref != kNotUsed);
       spirv_params.emplace_back(gen_param(pidx.depth_ref));
 
-      type::F32 f32;
-      ast::FloatLiteral float_0(Source{}, &f32, 0.0);
+      ast::FloatLiteral float_0(Source{}, type_mgr_.Get<type::F32>(), 0.0);
       image_operands.emplace_back(ImageOperand{
           SpvImageOperandsLodMask,
           Operand::Int(GenerateLiteralIfNeeded(nullptr, &float_0))});
@@ -2394,21 +2680,22 @@ bool Builder::GenerateTextureIntrinsic(ast::IdentifierExpression* ident,
 uint32_t Builder::GenerateSampledImage(type::Type* texture_type,
                                        Operand texture_operand,
                                        Operand sampler_operand) {
-  uint32_t sampled_image_type_id = 0;
-  auto val = texture_type_name_to_sampled_image_type_id_.find(
-      texture_type->type_name());
-  if (val != texture_type_name_to_sampled_image_type_id_.end()) {
-    // The sampled image type is already created.
-    sampled_image_type_id = val->second;
-  } else {
+  auto texture_type_id = GenerateTypeIfNeeded(texture_type);
+  if (texture_type_id == 0) {
+    return 0;
+  }
+  auto& cache = image_type_id_to_sampled_image_type_id_;
+  if (texture_type_id >= cache.size()) {
+    cache.resize(texture_type_id + 1, 0);
+  }
+  uint32_t sampled_image_type_id = cache[texture_type_id];
+  if (sampled_image_type_id == 0) {
     // We need to create the sampled image type and cache the result.
     auto sampled_image_type = result_op();
     sampled_image_type_id = sampled_image_type.to_i();
-    auto texture_type_id = GenerateTypeIfNeeded(texture_type);
     push_type(spv::Op::OpTypeSampledImage,
               {sampled_image_type, Operand::Int(texture_type_id)});
-    texture_type_name_to_sampled_image_type_id_[texture_type->type_name()] =
-        sampled_image_type_id;
+    cache[texture_type_id] = sampled_image_type_id;
   }
 
   auto sampled_image = result_op();
@@ -2467,6 +2754,34 @@ bool Builder::GenerateConditionalBlock(
   }
   cond_id = GenerateLoadIfNeeded(cond->result_type(), cond_id);
 
+  auto* else_stmt =
+      cur_else_idx < else_stmts.size() ? else_stmts[cur_else_idx] : nullptr;
+  bool has_false_block = else_stmt != nullptr;
+  bool has_true_block = true;
+  if (merge_control_flow_) {
+    // Empty blocks are replaced by a branch to the merge block.
+    has_false_block = else_stmt != nullptr && (else_stmt->HasCondition() ||
+                                               !else_stmt->body()->empty());
+    has_true_block = !true_body->empty();
+    if (!has_true_block && !has_false_block) {
+      // Nothing is branched over, the condition is only needed for its side
+      // effects.
+      return true;
+    }
+    if (!has_false_block) {
+      // A break or continue does not need a selection construct of its own.
+      if (auto exit_id = LoopExitTarget(true_body)) {
+        auto next_block_id = next_id();
+        if (!push_function_inst(spv::Op::OpBranchConditional,
+                                {Operand::Int(cond_id), Operand::Int(exit_id),
+                                 Operand::Int(next_block_id)})) {
+          return false;
+        }
+        return GenerateLabel(next_block_id);
+      }
+    }
+  }
+
   auto merge_block = result_op();
   auto merge_block_id = merge_block.to_i();
 
@@ -2476,13 +2791,11 @@ bool Builder::GenerateConditionalBlock(
     return false;
   }
 
-  auto true_block = result_op();
-  auto true_block_id = true_block.to_i();
+  auto true_block_id = has_true_block ? next_id() : merge_block_id;
 
   // if there are no more else statements we branch on false to the merge
   // block otherwise we branch to the false block
-  auto false_block_id =
-      cur_else_idx < else_stmts.size() ? next_id() : merge_block_id;
+  auto false_block_id = has_false_block ? next_id() : merge_block_id;
 
   if (!push_function_inst(spv::Op::OpBranchConditional,
                           {Operand::Int(cond_id), Operand::Int(true_block_id),
@@ -2491,18 +2804,20 @@ bool Builder::GenerateConditionalBlock(
   }
 
   // Output true block
-  if (!GenerateLabel(true_block_id)) {
-    return false;
-  }
-  if (!GenerateBlockStatement(true_body)) {
-    return false;
-  }
-  // We only branch if the last element of the body didn't already branch.
-  if (!LastIsTerminator(true_body)) {
-    if (!push_function_inst(spv::Op::OpBranch,
-                            {Operand::Int(merge_block_id)})) {
+  if (true_block_id != merge_block_id) {
+    if (!GenerateLabel(true_block_id)) {
+      return false;
+    }
+    if (!GenerateBlockStatement(true_body)) {
       return false;
     }
+    // We only branch if the last element of the body didn't already branch.
+    if (!LastIsTerminator(true_body)) {
+      if (!push_function_inst(spv::Op::OpBranch,
+                              {Operand::Int(merge_block_id)})) {
+        return false;
+      }
+    }
   }
 
   // Start the false block if needed
@@ -2511,7 +2826,6 @@ bool Builder::GenerateConditionalBlock(
       return false;
     }
 
-    auto* else_stmt = else_stmts[cur_else_idx];
     // Handle the else case by just outputting the statements.
     if (!else_stmt->HasCondition()) {
       if (!GenerateBlockStatement(else_stmt->body())) {
@@ -2523,7 +2837,10 @@ bool Builder::GenerateConditionalBlock(
         return false;
       }
     }
-    if (!LastIsTerminator(else_stmt->body())) {
+    // A nested else if always ends in its own merge block, which needs a
+    // branch when control flow is merged.
+    bool nested = merge_control_flow_ && else_stmt->HasCondition();
+    if (nested || !LastIsTerminator(else_stmt->body())) {
       if (!push_function_inst(spv::Op::OpBranch,
                               {Operand::Int(merge_block_id)})) {
         return false;
@@ -2689,6 +3006,9 @@ bool Builder::GenerateLoopStatement(ast::LoopStatement* stmt) {
 
   continue_stack_.push_back(continue_block_id);
   merge_stack_.push_back(merge_block_id);
+  if (merge_control_flow_) {
+    loop_merge_stack_.push_back(merge_block_id);
+  }
 
   if (!push_function_inst(spv::Op::OpBranch, {Operand::Int(body_block_id)})) {
     return false;
@@ -2711,6 +3031,11 @@ bool Builder::GenerateLoopStatement(ast::LoopStatement* stmt) {
   if (!GenerateLabel(continue_block_id)) {
     return false;
   }
+  // The continuing block may only leave the loop through its back-edge, so
+  // breaks are not merged into conditional branches.
+  if (merge_control_flow_) {
+    loop_merge_stack_.back() = 0;
+  }
   if (!GenerateBlockStatement(stmt->continuing())) {
     return false;
   }
@@ -2720,6 +3045,9 @@ bool Builder::GenerateLoopStatement(ast::LoopStatement* stmt) {
 
   merge_stack_.pop_back();
   continue_stack_.pop_back();
+  if (merge_control_flow_) {
+    loop_merge_stack_.pop_back();
+  }
 
   return GenerateLabel(merge_block_id);
 }
@@ -2777,6 +3105,23 @@ uint32_t Builder::GenerateTypeIfNeeded(type::Type* type) {
     return 0;
   }
 
+  // Types that were not created by a Manager have no index, and are always
+  // looked up by name. The type is checked as types of different Managers may
+  // share an index.
+  auto index = type->index();
+  auto entry = GetDense(type_index_to_id_, index);
+  if (index != 0 && entry.first == type) {
+    return entry.second;
+  }
+
+  auto id = GenerateTypeIfNotNamed(type);
+  if (id != 0 && index != 0) {
+    SetDense(&type_index_to_id_, index, TypeId{type, id});
+  }
+  return id;
+}
+
+uint32_t Builder::GenerateTypeIfNotNamed(type::Type* type) {
   // The alias is a wrapper around the subtype, so emit the subtype
   if (auto* alias = type->As<type::Alias>()) {
     return GenerateTypeIfNeeded(alias->type());
@@ -2787,7 +3132,8 @@ uint32_t Builder::GenerateTypeIfNeeded(type::Type* type) {
     }
   }
 
-  auto val = type_name_to_id_.find(type->type_name());
+  auto name = type->type_name();
+  auto val = type_name_to_id_.find(name);
   if (val != type_name_to_id_.end()) {
     return val->second;
   }
@@ -2848,7 +3194,7 @@ uint32_t Builder::GenerateTypeIfNeeded(type::Type* type) {
     return 0;
   }
 
-  type_name_to_id_[type->type_name()] = id;
+  type_name_to_id_[name] = id;
   return id;
 }
 
@@ -2908,8 +3254,7 @@ bool Builder::GenerateTextureType(type::Texture* texture,
 
   uint32_t type_id = 0u;
   if (texture->Is<type::DepthTexture>()) {
-    type::F32 f32;
-    type_id = GenerateTypeIfNeeded(&f32);
+    type_id = GenerateTypeIfNeeded(type_mgr_.Get<type::F32>());
   } else if (auto* s = texture->As<type::SampledTexture>()) {
     type_id = GenerateTypeIfNeeded(s->type());
   } else if (auto* ms = texture->As<type::MultisampledTexture>()) {
@@ -2963,8 +3308,8 @@ bool Builder::GenerateArrayType(type::Array* ary, const Operand& result) {
 }
 
 bool Builder::GenerateMatrixType(type::Matrix* mat, const Operand& result) {
-  type::Vector col_type(mat->type(), mat->rows());
-  auto col_type_id = GenerateTypeIfNeeded(&col_type);
+  auto col_type_id = GenerateTypeIfNeeded(
+      type_mgr_.Get<type::Vector>(mat->type(), mat->rows()));
   if (has_error()) {
     return false;
   }
@@ -3247,7 +3592,7 @@ SpvImageFormat Builder::convert_image_format_to_spv(
   return SpvImageFormatUnknown;
 }
 
-bool Builder::push_function_inst(spv::Op op, const OperandList& operands) {
+bool Builder::push_function_inst(spv::Op op, OperandList operands) {
   if (functions_.empty()) {
     std::ostringstream ss;
     ss << "Internal error: trying to add SPIR-V instruction " << int(op)
@@ -3255,10 +3600,60 @@ bool Builder::push_function_inst(spv::Op op, const OperandList& operands) {
     error_ = ss.str();
     return false;
   }
-  functions_.back().push_inst(op, operands);
+  if (op == spv::Op::OpFunctionCall) {
+    // The callee may write to any variable passed to it by pointer.
+    clear_block_var_values();
+  }
+  functions_.back().push_inst(op, std::move(operands));
   return true;
 }
 
+void Builder::push_function_var(OperandList operands) {
+  assert(!functions_.empty());
+  if (optimize_memory_accesses_) {
+    SetDense(&function_vars_, operands[1].to_i(), true);
+  }
+  functions_.back().push_var(std::move(operands));
+}
+
+void Builder::reset_block_state() {
+  block_access_chains_.clear();
+  clear_block_var_values();
+}
+
+void Builder::set_block_var_value(uint32_t var_id, uint32_t value_id) {
+  SetDense(&block_var_values_, var_id, value_id);
+  block_var_value_ids_.push_back(var_id);
+}
+
+void Builder::clear_block_var_values() {
+  // Only the entries that were set are cleared, as most function variables
+  // have no known value in any given basic block.
+  for (auto id : block_var_value_ids_) {
+    block_var_values_[id] = 0;
+  }
+  block_var_value_ids_.clear();
+}
+
+uint32_t Builder::LoopExitTarget(const ast::BlockStatement* body) const {
+  if (body->size() != 1 || loop_merge_stack_.empty() ||
+      loop_merge_stack_.back() == 0 ||
+      loop_merge_stack_.back() != merge_stack_.back()) {
+    return 0;
+  }
+  if (body->last()->Is<ast::BreakStatement>()) {
+    return merge_stack_.back();
+  }
+  if (body->last()->Is<ast::ContinueStatement>()) {
+    return continue_stack_.back();
+  }
+  return 0;
+}
+
+void Builder::set_id_owner(uint32_t id, uint32_t function_id) {
+  SetDense(&local_id_to_function_, id, function_id);
+}
+
 }  // namespace spirv
 }  // namespace writer
 }  // namespace tint
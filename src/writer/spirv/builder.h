@@ -16,9 +16,11 @@
 #define SRC_WRITER_SPIRV_BUILDER_H_
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "spirv/unified1/spirv.h"
@@ -43,8 +45,8 @@
 #include "src/ast/type_constructor_expression.h"
 #include "src/ast/unary_op_expression.h"
 #include "src/ast/variable_decl_statement.h"
+#include "src/constant_evaluator.h"
 #include "src/program.h"
-#include "src/scope_stack.h"
 #include "src/type/access_control_type.h"
 #include "src/type/array_type.h"
 #include "src/type/matrix_type.h"
@@ -55,6 +57,9 @@
 #include "src/type/vector_type.h"
 #include "src/writer/spirv/function.h"
 #include "src/writer/spirv/instruction.h"
+#include "src/writer/spirv/operand_layout.h"
+#include "src/writer/spirv/output_sink.h"
+#include "src/writer/spirv/symbol_id_stack.h"
 
 namespace tint {
 namespace writer {
@@ -111,85 +116,153 @@ class Builder {
 
   /// Iterates over all the instructions in the correct order and calls the
   /// given callback
+  /// @note only the recorded instructions are visited, so this must not be
+  /// used if set_encode_words() has been enabled.
   /// @param cb the callback to execute
   void iterate(std::function<void(const Instruction&)> cb) const;
 
+  /// Streams the binary encoding of all the instructions, in section order,
+  /// to `sink`. Directly encoded section words are written without being
+  /// copied. The SPIR-V header is not emitted.
+  /// @param sink the sink to write to
+  void Encode(OutputSink* sink) const;
+
+  /// Streams the binary encoding of a module holding the single entry point
+  /// `entry_point` to `sink`. The module shares the capabilities, types,
+  /// constants and global variables of the whole program, and holds only the
+  /// functions reachable from the entry point. Must be called after Build().
+  /// The SPIR-V header is not emitted.
+  /// @param entry_point the entry point function
+  /// @param sink the sink to write to
+  /// @returns false if `entry_point` is not a generated entry point
+  bool EncodeEntryPoint(ast::Function* entry_point, OutputSink* sink) const;
+
+  /// Enables direct encoding. When enabled, instructions are encoded into
+  /// per-section word buffers as they are generated instead of being recorded
+  /// as Instructions, and the instruction accessors (types(), functions(),
+  /// etc) return empty lists. Must be called before Build().
+  /// @param enable true to encode words directly
+  void set_encode_words(bool enable) { encode_words_ = enable; }
+
+  /// Enables the memory access optimizations. When enabled, an OpAccessChain
+  /// identical to one already generated in the current basic block is reused,
+  /// and the value last stored to, or loaded from, a function variable is
+  /// used in place of a later load of that variable in the same basic block.
+  /// Must be called before Build().
+  /// @param enable true to optimize memory accesses
+  void set_optimize_memory_accesses(bool enable) {
+    optimize_memory_accesses_ = enable;
+  }
+
+  /// Omits the debug instructions (OpName and OpMemberName) from the module.
+  /// Must be called before Build().
+  /// @param enable true to strip the debug instructions
+  void set_strip_debug(bool enable) { strip_debug_ = enable; }
+
+  /// Enables merged control flow emission, for fewer basic blocks. When
+  /// enabled, an if statement without statements generates only its
+  /// condition, an empty true or else block is replaced by a branch to the
+  /// merge block, and an if statement holding only a break or continue of
+  /// the innermost loop is generated as a conditional branch to the loop's
+  /// merge block or continue target. Must be called before Build().
+  /// @param enable true to merge control flow
+  void set_merge_control_flow(bool enable) { merge_control_flow_ = enable; }
+
+  /// @returns the number of basic blocks generated
+  uint32_t block_count() const { return block_count_; }
+
   /// Adds an instruction to the list of capabilities, if the capability
   /// hasn't already been added.
   /// @param cap the capability to set
   void push_capability(uint32_t cap);
   /// @returns the capabilities
-  const InstructionList& capabilities() const { return capabilities_; }
+  const InstructionList& capabilities() const {
+    return capabilities_.instructions;
+  }
   /// Adds an instruction to the extensions
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_extension(spv::Op op, const OperandList& operands) {
-    extensions_.push_back(Instruction{op, operands});
+  void push_extension(spv::Op op, OperandList operands) {
+    push(&extensions_, op, std::move(operands));
   }
   /// @returns the extensions
-  const InstructionList& extensions() const { return extensions_; }
+  const InstructionList& extensions() const { return extensions_.instructions; }
   /// Adds an instruction to the ext import
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_ext_import(spv::Op op, const OperandList& operands) {
-    ext_imports_.push_back(Instruction{op, operands});
+  void push_ext_import(spv::Op op, OperandList operands) {
+    push(&ext_imports_, op, std::move(operands));
   }
   /// @returns the ext imports
-  const InstructionList& ext_imports() const { return ext_imports_; }
+  const InstructionList& ext_imports() const {
+    return ext_imports_.instructions;
+  }
   /// Adds an instruction to the memory model
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_memory_model(spv::Op op, const OperandList& operands) {
-    memory_model_.push_back(Instruction{op, operands});
+  void push_memory_model(spv::Op op, OperandList operands) {
+    push(&memory_model_, op, std::move(operands));
   }
   /// @returns the memory model
-  const InstructionList& memory_model() const { return memory_model_; }
+  const InstructionList& memory_model() const {
+    return memory_model_.instructions;
+  }
   /// Adds an instruction to the entry points
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_entry_point(spv::Op op, const OperandList& operands) {
-    entry_points_.push_back(Instruction{op, operands});
+  void push_entry_point(spv::Op op, OperandList operands) {
+    push(&entry_points_, op, std::move(operands));
   }
   /// @returns the entry points
-  const InstructionList& entry_points() const { return entry_points_; }
+  const InstructionList& entry_points() const {
+    return entry_points_.instructions;
+  }
   /// Adds an instruction to the execution modes
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_execution_mode(spv::Op op, const OperandList& operands) {
-    execution_modes_.push_back(Instruction{op, operands});
+  void push_execution_mode(spv::Op op, OperandList operands) {
+    push(&execution_modes_, op, std::move(operands));
   }
   /// @returns the execution modes
-  const InstructionList& execution_modes() const { return execution_modes_; }
+  const InstructionList& execution_modes() const {
+    return execution_modes_.instructions;
+  }
   /// Adds an instruction to the debug
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_debug(spv::Op op, const OperandList& operands) {
-    debug_.push_back(Instruction{op, operands});
+  void push_debug(spv::Op op, OperandList operands) {
+    if (strip_debug_) {
+      return;
+    }
+    push(&debug_, op, std::move(operands));
   }
   /// @returns the debug instructions
-  const InstructionList& debug() const { return debug_; }
+  const InstructionList& debug() const { return debug_.instructions; }
   /// Adds an instruction to the types
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_type(spv::Op op, const OperandList& operands) {
-    types_.push_back(Instruction{op, operands});
+  void push_type(spv::Op op, OperandList operands) {
+    push(&types_, op, std::move(operands));
   }
   /// @returns the type instructions
-  const InstructionList& types() const { return types_; }
+  const InstructionList& types() const { return types_.instructions; }
   /// Adds an instruction to the annotations
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_annot(spv::Op op, const OperandList& operands) {
-    annotations_.push_back(Instruction{op, operands});
+  void push_annot(spv::Op op, OperandList operands) {
+    push(&annotations_, op, std::move(operands));
   }
   /// @returns the annotations
-  const InstructionList& annots() const { return annotations_; }
+  const InstructionList& annots() const { return annotations_.instructions; }
 
   /// Adds a function to the builder
   /// @param func the function to add
   void push_function(const Function& func) {
     functions_.push_back(func);
+    functions_.back().set_encode_words(encode_words_);
     current_label_id_ = func.label_id();
+    block_count_++;
+    reset_block_state();
   }
   /// @returns the functions
   const std::vector<Function>& functions() const { return functions_; }
@@ -198,13 +271,10 @@ class Builder {
   /// @param op the operation
   /// @param operands the operands
   /// @returns true if we succeeded
-  bool push_function_inst(spv::Op op, const OperandList& operands);
+  bool push_function_inst(spv::Op op, OperandList operands);
   /// Pushes a variable to the current function
   /// @param operands the variable operands
-  void push_function_var(const OperandList& operands) {
-    assert(!functions_.empty());
-    functions_.back().push_var(operands);
-  }
+  void push_function_var(OperandList operands);
 
   /// Converts a storage class to a SPIR-V storage class.
   /// @param klass the storage class to convert
@@ -335,6 +405,23 @@ class Builder {
   /// @param lit the literal to generate
   /// @returns the ID on success or 0 on failure
   uint32_t GenerateLiteralIfNeeded(ast::Variable* var, ast::Literal* lit);
+  /// Generates the constant for a value computed by the ConstantEvaluator
+  /// @param type the scalar, vector or matrix type of the value
+  /// @param elements the scalar elements of the value
+  /// @returns the ID on success or 0 on failure
+  uint32_t GenerateConstantValue(type::Type* type,
+                                 const ast::ConstantValue::Scalar* elements);
+  /// Generates an OpConstantComposite, or returns the ID of an identical
+  /// composite that was already generated
+  /// @param type the composite type
+  /// @param count the number of constituents
+  /// @param generate_element called with the index of each constituent,
+  /// returning the constituent's ID or 0 on failure
+  /// @returns the ID on success or 0 on failure
+  template <typename F>
+  uint32_t GenerateConstantComposite(type::Type* type,
+                                     uint32_t count,
+                                     F&& generate_element);
   /// Generates a binary expression
   /// @param expr the expression to generate
   /// @returns the expression ID on success or 0 otherwise
@@ -416,6 +503,15 @@ class Builder {
   /// @param id the variable id to load
   /// @returns the ID of the loaded value or `id` if type is not a pointer
   uint32_t GenerateLoadIfNeeded(type::Type* type, uint32_t id);
+  /// Generates an OpAccessChain, or reuses an identical access chain from the
+  /// current basic block if memory access optimizations are enabled.
+  /// @param result_type_id the ID of the pointer type of the result
+  /// @param base_id the ID of the base pointer
+  /// @param indices the IDs of the indices
+  /// @returns the ID of the access chain or 0 on error
+  uint32_t GenerateAccessChain(uint32_t result_type_id,
+                               uint32_t base_id,
+                               const std::vector<uint32_t>& indices);
   /// Generates an OpStore. Emits an error and returns false if we're
   /// currently outside a function.
   /// @param to the ID to store too
@@ -423,9 +519,16 @@ class Builder {
   /// @returns true on success
   bool GenerateStore(uint32_t to, uint32_t from);
   /// Generates a type if not already created
+  /// @note the generated IDs are cached by the type pointer, so `type` must
+  /// outlive the builder.
   /// @param type the type to create
   /// @returns the ID to use for the given type. Returns 0 on unknown type.
   uint32_t GenerateTypeIfNeeded(type::Type* type);
+  /// Generates a type if no type of the same name has been created. Used by
+  /// GenerateTypeIfNeeded() for type pointers that have not been seen before.
+  /// @param type the type to create
+  /// @returns the ID to use for the given type. Returns 0 on unknown type.
+  uint32_t GenerateTypeIfNotNamed(type::Type* type);
   /// Generates a texture type declaration
   /// @param texture the texture to generate
   /// @param result the result operand
@@ -484,36 +587,147 @@ class Builder {
   bool is_constructor_const(ast::Expression* expr, bool is_global_init);
 
  private:
+  /// The key of a scalar constant in `scalar_constant_to_id_`
+  struct ScalarConstantKey {
+    /// The kind of the literal the constant was generated from
+    enum class Kind : uint8_t { kBool, kSint, kUint, kFloat, kNull };
+
+    /// The literal kind
+    Kind kind = Kind::kNull;
+    /// True if the constant is a specialization constant
+    bool is_spec = false;
+    /// The ID of the constant type
+    uint32_t type_id = 0;
+    /// The bits of the constant value
+    uint32_t value = 0;
+
+    /// Equality operator
+    /// @param other the key to compare against
+    /// @returns true if the keys are equal
+    bool operator==(const ScalarConstantKey& other) const {
+      return kind == other.kind && is_spec == other.is_spec &&
+             type_id == other.type_id && value == other.value;
+    }
+
+    /// Hashes the key
+    struct Hasher {
+      /// @param key the key to hash
+      /// @returns the hash of `key`
+      size_t operator()(const ScalarConstantKey& key) const;
+    };
+  };
+
+  /// The key of a composite in `composite_to_id_`: the ID of the composite
+  /// type followed by the IDs of the constituents. Also used as the key of an
+  /// access chain in `block_access_chains_`: the ID of the result type, the
+  /// base pointer ID, then the IDs of the indices.
+  using CompositeKey = std::vector<uint32_t>;
+
+  /// A section of the module. Holds either the recorded instructions, or
+  /// their binary encoding when encoding words directly.
+  struct Section {
+    /// The recorded instructions
+    InstructionList instructions;
+    /// The encoded instruction words
+    std::vector<uint32_t> words;
+  };
+
+  /// Adds an instruction to a section
+  /// @param section the section to add to
+  /// @param op the op to set
+  /// @param operands the operands for the instruction
+  void push(Section* section, spv::Op op, OperandList operands);
+
   /// @returns an Operand with a new result ID in it. Increments the next_id_
   /// automatically.
   Operand result_op();
 
+  /// Forgets the access chains and variable values known for the current
+  /// basic block. Called whenever a new basic block is started.
+  void reset_block_state();
+  /// Records `value_id` as the value of the function variable `var_id` in the
+  /// current basic block
+  /// @param var_id the function variable ID
+  /// @param value_id the value ID
+  void set_block_var_value(uint32_t var_id, uint32_t value_id);
+  /// Forgets the values of the function variables in the current basic block
+  void clear_block_var_values();
+
+  /// Records the function that declares `id`
+  /// @param id the named function, parameter or function variable ID
+  /// @param function_id the ID of the declaring function
+  void set_id_owner(uint32_t id, uint32_t function_id);
+
+  /// @param body the true block of an if statement without else
+  /// @returns the ID of the block to branch to directly in place of `body`,
+  /// if control flow is merged and `body` holds only a break or continue of
+  /// the innermost loop, otherwise 0.
+  uint32_t LoopExitTarget(const ast::BlockStatement* body) const;
+
   const Program* program_;
   type::Manager type_mgr_;
   std::string error_;
   uint32_t next_id_ = 1;
   uint32_t current_label_id_ = 0;
-  InstructionList capabilities_;
-  InstructionList extensions_;
-  InstructionList ext_imports_;
-  InstructionList memory_model_;
-  InstructionList entry_points_;
-  InstructionList execution_modes_;
-  InstructionList debug_;
-  InstructionList types_;
-  InstructionList annotations_;
+  bool encode_words_ = false;
+  bool optimize_memory_accesses_ = false;
+  bool strip_debug_ = false;
+  bool merge_control_flow_ = false;
+  uint32_t block_count_ = 0;
+  Section capabilities_;
+  Section extensions_;
+  Section ext_imports_;
+  Section memory_model_;
+  Section entry_points_;
+  Section execution_modes_;
+  Section debug_;
+  Section types_;
+  Section annotations_;
   std::vector<Function> functions_;
+  // Folds global constant initializers that are not constructors. Created on
+  // first use.
+  std::unique_ptr<ConstantEvaluator> constant_evaluator_;
 
-  std::unordered_map<std::string, uint32_t> import_name_to_id_;
-  std::unordered_map<Symbol, uint32_t> func_symbol_to_id_;
+  // The ID of the GLSL.std.450 extended instruction set import, 0 if the
+  // import has not been generated.
+  uint32_t glsl_std450_import_id_ = 0;
+  // The ID of each generated function, indexed by Symbol::value()
+  std::vector<uint32_t> func_symbol_to_id_;
+  // The function that declares each named function, parameter and function
+  // variable, indexed by ID and 0 for module scope IDs. Used to drop the
+  // names of unreachable functions from per-entry-point modules.
+  std::vector<uint32_t> local_id_to_function_;
+  uint32_t current_function_id_ = 0;
+  using TypeId = std::pair<const type::Type*, uint32_t>;
+  // The type and ID of each generated type, indexed by type::Type::index()
+  std::vector<TypeId> type_index_to_id_;
+  // Types not owned by the program (such as those made by tests) may be
+  // distinct objects of the same type, so types are deduplicated by name the
+  // first time a type pointer is seen.
   std::unordered_map<std::string, uint32_t> type_name_to_id_;
-  std::unordered_map<std::string, uint32_t> const_to_id_;
-  std::unordered_map<std::string, uint32_t>
-      texture_type_name_to_sampled_image_type_id_;
-  ScopeStack<uint32_t> scope_stack_;
-  std::unordered_map<uint32_t, ast::Variable*> spirv_id_to_variable_;
+  std::unordered_map<ScalarConstantKey, uint32_t, ScalarConstantKey::Hasher>
+      scalar_constant_to_id_;
+  std::unordered_map<CompositeKey, uint32_t, WordsHasher> composite_to_id_;
+  // The OpTypeSampledImage ID of each image type, indexed by image type ID
+  std::vector<uint32_t> image_type_id_to_sampled_image_type_id_;
+  SymbolIdStack scope_stack_;
+  // The following are only populated if memory access optimizations are
+  // enabled, and are indexed by ID. Whether the ID is a function storage
+  // class OpVariable:
+  std::vector<bool> function_vars_;
+  // The pointer at the root of each access chain, 0 for other IDs:
+  std::vector<uint32_t> access_chain_root_;
+  // The access chains generated in the current basic block:
+  std::unordered_map<CompositeKey, uint32_t, WordsHasher> block_access_chains_;
+  // The value of each function variable in the current basic block, 0 if
+  // unknown, and the variables whose value was set in the block:
+  std::vector<uint32_t> block_var_values_;
+  std::vector<uint32_t> block_var_value_ids_;
   std::vector<uint32_t> merge_stack_;
   std::vector<uint32_t> continue_stack_;
+  // The merge block of each loop, or 0 while the loop's continuing block is
+  // generated. Only populated if control flow is merged.
+  std::vector<uint32_t> loop_merge_stack_;
   std::unordered_set<uint32_t> capability_set_;
 };
 
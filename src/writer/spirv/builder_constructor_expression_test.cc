@@ -295,6 +295,29 @@ TEST_F(SpvBuilderConstructorTest, Type_Vec2_With_F32_F32) {
 )");
 }
 
+TEST_F(SpvBuilderConstructorTest, Type_Dedup_IdenticalComposites) {
+  auto* c1 = vec3<f32>(1.0f, 2.0f, 3.0f);
+  auto* c2 = vec3<f32>(1.0f, 2.0f, 3.0f);
+
+  ASSERT_TRUE(td.DetermineResultType(c1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(c2)) << td.error();
+
+  spirv::Builder& b = Build();
+
+  b.push_function(Function{});
+  EXPECT_EQ(b.GenerateExpression(c1), 6u);
+  EXPECT_EQ(b.GenerateExpression(c2), 6u);
+  ASSERT_FALSE(b.has_error()) << b.error();
+
+  EXPECT_EQ(DumpInstructions(b.types()), R"(%2 = OpTypeFloat 32
+%1 = OpTypeVector %2 3
+%3 = OpConstant %2 1
+%4 = OpConstant %2 2
+%5 = OpConstant %2 3
+%6 = OpConstantComposite %1 %3 %4 %5
+)");
+}
+
 TEST_F(SpvBuilderConstructorTest, Type_Vec2_With_Vec2) {
   auto* value = vec2<f32>(2.0f, 2.0f);
   auto* cast = vec2<f32>(value);
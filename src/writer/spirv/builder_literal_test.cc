@@ -167,6 +167,25 @@ TEST_F(BuilderTest, Literal_F32_Dedup) {
 )");
 }
 
+TEST_F(BuilderTest, Literal_Dedup_DistinctTypes) {
+  auto* i = create<ast::SintLiteral>(ty.i32(), 1);
+  auto* u = create<ast::UintLiteral>(ty.u32(), 1);
+  auto* i_again = create<ast::SintLiteral>(ty.i32(), 1);
+
+  spirv::Builder& b = Build();
+
+  EXPECT_EQ(b.GenerateLiteralIfNeeded(nullptr, i), 2u);
+  EXPECT_EQ(b.GenerateLiteralIfNeeded(nullptr, u), 4u);
+  EXPECT_EQ(b.GenerateLiteralIfNeeded(nullptr, i_again), 2u);
+  ASSERT_FALSE(b.has_error()) << b.error();
+
+  EXPECT_EQ(DumpInstructions(b.types()), R"(%1 = OpTypeInt 32 1
+%2 = OpConstant %1 1
+%3 = OpTypeInt 32 0
+%4 = OpConstant %3 1
+)");
+}
+
 }  // namespace spirv
 }  // namespace writer
 }  // namespace tint
@@ -0,0 +1,337 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "spirv-tools/libspirv.hpp"
+#include "src/ast/array_accessor_expression.h"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/block_statement.h"
+#include "src/ast/break_statement.h"
+#include "src/ast/loop_statement.h"
+#include "src/ast/member_accessor_expression.h"
+#include "src/ast/stage_decoration.h"
+#include "src/ast/variable_decl_statement.h"
+#include "src/type_determiner.h"
+#include "src/writer/spirv/binary_writer.h"
+#include "src/writer/spirv/builder.h"
+#include "src/writer/spirv/spv_dump.h"
+#include "src/writer/spirv/test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+using BuilderTest = TestHelper;
+
+TEST_F(BuilderTest, MemoryAccess_AccessChainReusedInBlock) {
+  // var ary : vec3<f32>;
+  // ary[1];
+  // ary[1];
+
+  auto* var = Var("ary", ast::StorageClass::kFunction, ty.vec3<f32>());
+  auto* expr1 = IndexAccessor("ary", 1);
+  auto* expr2 = IndexAccessor("ary", 1);
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(expr1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(expr2)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+
+  EXPECT_EQ(b.GenerateAccessorExpression(expr1), 9u);
+  EXPECT_EQ(b.GenerateAccessorExpression(expr2), 9u);
+
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(%9 = OpAccessChain %8 %1 %7
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_AccessChainNotReusedWhenDisabled) {
+  auto* var = Var("ary", ast::StorageClass::kFunction, ty.vec3<f32>());
+  auto* expr1 = IndexAccessor("ary", 1);
+  auto* expr2 = IndexAccessor("ary", 1);
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(expr1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(expr2)) << td.error();
+
+  spirv::Builder& b = Build();
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+
+  EXPECT_EQ(b.GenerateAccessorExpression(expr1), 9u);
+  EXPECT_EQ(b.GenerateAccessorExpression(expr2), 10u);
+
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(%9 = OpAccessChain %8 %1 %7
+%10 = OpAccessChain %8 %1 %7
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_AccessChainNotReusedAcrossBlocks) {
+  auto* var = Var("ary", ast::StorageClass::kFunction, ty.vec3<f32>());
+  auto* expr1 = IndexAccessor("ary", 1);
+  auto* expr2 = IndexAccessor("ary", 1);
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(expr1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(expr2)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+
+  EXPECT_EQ(b.GenerateAccessorExpression(expr1), 9u);
+  ASSERT_TRUE(b.GenerateLabel(b.next_id())) << b.error();
+  EXPECT_EQ(b.GenerateAccessorExpression(expr2), 11u);
+
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(%9 = OpAccessChain %8 %1 %7
+%10 = OpLabel
+%11 = OpAccessChain %8 %1 %7
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_StoreForwardedToLoad) {
+  // var v : f32;
+  // v = 1.0;
+  // v;
+
+  auto* var = Var("v", ast::StorageClass::kFunction, ty.f32());
+  auto* assign = create<ast::AssignmentStatement>(Expr("v"), Expr(1.f));
+  auto* load = Expr("v");
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(assign)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(load)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+  ASSERT_TRUE(b.GenerateAssignStatement(assign)) << b.error();
+
+  auto id = b.GenerateExpression(load);
+  EXPECT_EQ(id, 1u);
+  EXPECT_EQ(b.GenerateLoadIfNeeded(load->result_type(), id), 5u);
+
+  EXPECT_EQ(DumpInstructions(b.types()), R"(%3 = OpTypeFloat 32
+%2 = OpTypePointer Function %3
+%4 = OpConstantNull %3
+%5 = OpConstant %3 1
+)");
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpStore %1 %5
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_RepeatedLoadReused) {
+  auto* var = Var("v", ast::StorageClass::kFunction, ty.f32());
+  auto* load1 = Expr("v");
+  auto* load2 = Expr("v");
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(load1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(load2)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+
+  EXPECT_EQ(b.GenerateLoadIfNeeded(load1->result_type(),
+                                   b.GenerateExpression(load1)),
+            5u);
+  EXPECT_EQ(b.GenerateLoadIfNeeded(load2->result_type(),
+                                   b.GenerateExpression(load2)),
+            5u);
+
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(%5 = OpLoad %3 %1
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_PartialStoreInvalidatesVariable) {
+  // var ary : vec3<f32>;
+  // ary;
+  // ary[1] = 1.0;
+  // ary;
+
+  auto* var = Var("ary", ast::StorageClass::kFunction, ty.vec3<f32>());
+  auto* load1 = Expr("ary");
+  auto* assign = create<ast::AssignmentStatement>(IndexAccessor("ary", 1),
+                                                  Expr(1.f));
+  auto* load2 = Expr("ary");
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(load1)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(assign)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(load2)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+
+  auto first = b.GenerateLoadIfNeeded(load1->result_type(),
+                                      b.GenerateExpression(load1));
+  ASSERT_NE(first, 0u);
+  ASSERT_TRUE(b.GenerateAssignStatement(assign)) << b.error();
+  auto second = b.GenerateLoadIfNeeded(load2->result_type(),
+                                       b.GenerateExpression(load2));
+  ASSERT_NE(second, 0u);
+
+  EXPECT_NE(first, second);
+  ASSERT_FALSE(b.functions()[0].instructions().empty());
+  EXPECT_EQ(b.functions()[0].instructions().back().opcode(), spv::Op::OpLoad);
+}
+
+TEST_F(BuilderTest, MemoryAccess_StoreNotForwardedAcrossBlocks) {
+  auto* var = Var("v", ast::StorageClass::kFunction, ty.f32());
+  auto* assign = create<ast::AssignmentStatement>(Expr("v"), Expr(1.f));
+  auto* load = Expr("v");
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(assign)) << td.error();
+  ASSERT_TRUE(td.DetermineResultType(load)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_optimize_memory_accesses(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateFunctionVariable(var)) << b.error();
+  ASSERT_TRUE(b.GenerateAssignStatement(assign)) << b.error();
+  ASSERT_TRUE(b.GenerateLabel(b.next_id())) << b.error();
+
+  EXPECT_EQ(b.GenerateLoadIfNeeded(load->result_type(),
+                                   b.GenerateExpression(load)),
+            7u);
+
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpStore %1 %5
+%6 = OpLabel
+%7 = OpLoad %3 %1
+)");
+}
+
+TEST_F(BuilderTest, MemoryAccess_ValidateSPIRV) {
+  // var<private> g : vec3<f32>;
+  // [[stage(fragment)]]
+  // fn main() -> void {
+  //   var v : vec3<f32> = vec3<f32>(1.0, 2.0, 3.0);
+  //   v.x = v.y + v.y;
+  //   g = v;
+  //   loop {
+  //     g.x = g.y + v.z;
+  //     g.y = g.y + v.z;
+  //     break;
+  //   }
+  //   g = v;
+  // }
+
+  AST().AddGlobalVariable(
+      Var("g", ast::StorageClass::kPrivate, ty.vec3<f32>()));
+
+  auto* v = Var("v", ast::StorageClass::kFunction, ty.vec3<f32>(),
+                vec3<f32>(1.f, 2.f, 3.f), ast::VariableDecorationList{});
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::AssignmentStatement>(
+              MemberAccessor("g", "x"),
+              Add(MemberAccessor("g", "y"), MemberAccessor("v", "z"))),
+          create<ast::AssignmentStatement>(
+              MemberAccessor("g", "y"),
+              Add(MemberAccessor("g", "y"), MemberAccessor("v", "z"))),
+          create<ast::BreakStatement>(),
+      }),
+      create<ast::BlockStatement>(ast::StatementList{}));
+  auto* func = Func(
+      "main", ast::VariableList{}, ty.void_(),
+      ast::StatementList{
+          create<ast::VariableDeclStatement>(v),
+          create<ast::AssignmentStatement>(
+              MemberAccessor("v", "x"),
+              Add(MemberAccessor("v", "y"), MemberAccessor("v", "y"))),
+          create<ast::AssignmentStatement>(Expr("g"), Expr("v")),
+          loop,
+          create<ast::AssignmentStatement>(Expr("g"), Expr("v")),
+      },
+      ast::FunctionDecorationList{
+          create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+      });
+  AST().Functions().Add(func);
+
+  ASSERT_TRUE(td.Determine()) << td.error();
+
+  spirv::Builder& unoptimized = Build();
+  ASSERT_TRUE(unoptimized.Build()) << unoptimized.error();
+
+  spirv::Builder b(built_program());
+  b.set_optimize_memory_accesses(true);
+  ASSERT_TRUE(b.Build()) << b.error();
+
+  EXPECT_LT(b.total_size(), unoptimized.total_size());
+
+  BinaryWriter writer;
+  writer.WriteHeader(b.id_bound());
+  writer.WriteBuilder(&b);
+  auto binary = writer.result();
+
+  std::string spv_errors;
+  auto msg_consumer = [&spv_errors](spv_message_level_t level, const char*,
+                                    const spv_position_t& position,
+                                    const char* message) {
+    switch (level) {
+      case SPV_MSG_FATAL:
+      case SPV_MSG_INTERNAL_ERROR:
+      case SPV_MSG_ERROR:
+        spv_errors += "error: line " + std::to_string(position.index) + ": " +
+                      message + "\n";
+        break;
+      case SPV_MSG_WARNING:
+        spv_errors += "warning: line " + std::to_string(position.index) + ": " +
+                      message + "\n";
+        break;
+      case SPV_MSG_INFO:
+        spv_errors += "info: line " + std::to_string(position.index) + ": " +
+                      message + "\n";
+        break;
+      case SPV_MSG_DEBUG:
+        break;
+    }
+  };
+
+  spvtools::SpirvTools tools(SPV_ENV_VULKAN_1_2);
+  tools.SetMessageConsumer(msg_consumer);
+  ASSERT_TRUE(tools.Validate(binary)) << spv_errors
+                                      << DumpBuilder(b);
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
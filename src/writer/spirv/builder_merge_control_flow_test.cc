@@ -0,0 +1,303 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/block_statement.h"
+#include "src/ast/break_statement.h"
+#include "src/ast/continue_statement.h"
+#include "src/ast/else_statement.h"
+#include "src/ast/if_statement.h"
+#include "src/ast/loop_statement.h"
+#include "src/type_determiner.h"
+#include "src/writer/spirv/builder.h"
+#include "src/writer/spirv/spv_dump.h"
+#include "src/writer/spirv/test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+using BuilderTest = TestHelper;
+
+TEST_F(BuilderTest, MergeControlFlow_EmptyIf) {
+  // if (true) {
+  // } else {
+  // }
+  auto* expr = create<ast::IfStatement>(
+      Expr(true), create<ast::BlockStatement>(ast::StatementList{}),
+      ast::ElseStatementList{
+          create<ast::ElseStatement>(
+              nullptr, create<ast::BlockStatement>(ast::StatementList{})),
+      });
+
+  ASSERT_TRUE(td.DetermineResultType(expr)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+
+  EXPECT_TRUE(b.GenerateIfStatement(expr)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()), "");
+  EXPECT_EQ(b.block_count(), 1u);
+}
+
+TEST_F(BuilderTest, MergeControlFlow_EmptyTrueBlock) {
+  // if (true) {
+  // } else {
+  //   v = 2;
+  // }
+  auto* var = Var("v", ast::StorageClass::kPrivate, ty.i32());
+  auto* expr = create<ast::IfStatement>(
+      Expr(true), create<ast::BlockStatement>(ast::StatementList{}),
+      ast::ElseStatementList{
+          create<ast::ElseStatement>(
+              nullptr,
+              create<ast::BlockStatement>(ast::StatementList{
+                  create<ast::AssignmentStatement>(Expr("v"), Expr(2)),
+              })),
+      });
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(expr)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateGlobalVariable(var)) << b.error();
+
+  EXPECT_TRUE(b.GenerateIfStatement(expr)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpSelectionMerge %7 None
+OpBranchConditional %6 %7 %8
+%8 = OpLabel
+OpStore %1 %9
+OpBranch %7
+%7 = OpLabel
+)");
+  EXPECT_EQ(b.block_count(), 3u);
+}
+
+TEST_F(BuilderTest, MergeControlFlow_EmptyElseBlock) {
+  // if (true) {
+  //   v = 2;
+  // } else {
+  // }
+  auto* var = Var("v", ast::StorageClass::kPrivate, ty.i32());
+  auto* expr = create<ast::IfStatement>(
+      Expr(true),
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::AssignmentStatement>(Expr("v"), Expr(2)),
+      }),
+      ast::ElseStatementList{
+          create<ast::ElseStatement>(
+              nullptr, create<ast::BlockStatement>(ast::StatementList{})),
+      });
+
+  td.RegisterVariableForTesting(var);
+  ASSERT_TRUE(td.DetermineResultType(expr)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+  ASSERT_TRUE(b.GenerateGlobalVariable(var)) << b.error();
+
+  EXPECT_TRUE(b.GenerateIfStatement(expr)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpSelectionMerge %7 None
+OpBranchConditional %6 %8 %7
+%8 = OpLabel
+OpStore %1 %9
+OpBranch %7
+%7 = OpLabel
+)");
+}
+
+TEST_F(BuilderTest, MergeControlFlow_ConditionalBreak) {
+  // loop {
+  //   if (true) {
+  //     break;
+  //   }
+  // }
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::IfStatement>(
+              Expr(true),
+              create<ast::BlockStatement>(ast::StatementList{
+                  create<ast::BreakStatement>(),
+              }),
+              ast::ElseStatementList{}),
+      }),
+      create<ast::BlockStatement>(ast::StatementList{}));
+
+  ASSERT_TRUE(td.DetermineResultType(loop)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+
+  EXPECT_TRUE(b.GenerateLoopStatement(loop)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpBranch %1
+%1 = OpLabel
+OpLoopMerge %2 %3 None
+OpBranch %4
+%4 = OpLabel
+OpBranchConditional %6 %2 %7
+%7 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpBranch %1
+%2 = OpLabel
+)");
+  EXPECT_EQ(b.block_count(), 6u);
+}
+
+TEST_F(BuilderTest, MergeControlFlow_ConditionalContinue) {
+  // loop {
+  //   if (true) {
+  //     continue;
+  //   }
+  // }
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::IfStatement>(
+              Expr(true),
+              create<ast::BlockStatement>(ast::StatementList{
+                  create<ast::ContinueStatement>(),
+              }),
+              ast::ElseStatementList{}),
+      }),
+      create<ast::BlockStatement>(ast::StatementList{}));
+
+  ASSERT_TRUE(td.DetermineResultType(loop)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+
+  EXPECT_TRUE(b.GenerateLoopStatement(loop)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpBranch %1
+%1 = OpLabel
+OpLoopMerge %2 %3 None
+OpBranch %4
+%4 = OpLabel
+OpBranchConditional %6 %3 %7
+%7 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpBranch %1
+%2 = OpLabel
+)");
+}
+
+TEST_F(BuilderTest, MergeControlFlow_BreakInContinuingNotMerged) {
+  // loop {
+  //   continuing {
+  //     if (true) {
+  //       break;
+  //     }
+  //   }
+  // }
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{}),
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::IfStatement>(
+              Expr(true),
+              create<ast::BlockStatement>(ast::StatementList{
+                  create<ast::BreakStatement>(),
+              }),
+              ast::ElseStatementList{}),
+      }));
+
+  ASSERT_TRUE(td.DetermineResultType(loop)) << td.error();
+
+  spirv::Builder& b = Build();
+  b.set_merge_control_flow(true);
+
+  b.push_function(Function{});
+
+  EXPECT_TRUE(b.GenerateLoopStatement(loop)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpBranch %1
+%1 = OpLabel
+OpLoopMerge %2 %3 None
+OpBranch %4
+%4 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpSelectionMerge %7 None
+OpBranchConditional %6 %8 %7
+%8 = OpLabel
+OpBranch %2
+%7 = OpLabel
+OpBranch %1
+%2 = OpLabel
+)");
+}
+
+TEST_F(BuilderTest, MergeControlFlow_Disabled) {
+  // loop {
+  //   if (true) {
+  //     break;
+  //   }
+  // }
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::IfStatement>(
+              Expr(true),
+              create<ast::BlockStatement>(ast::StatementList{
+                  create<ast::BreakStatement>(),
+              }),
+              ast::ElseStatementList{}),
+      }),
+      create<ast::BlockStatement>(ast::StatementList{}));
+
+  ASSERT_TRUE(td.DetermineResultType(loop)) << td.error();
+
+  spirv::Builder& b = Build();
+
+  b.push_function(Function{});
+
+  EXPECT_TRUE(b.GenerateLoopStatement(loop)) << b.error();
+  EXPECT_EQ(DumpInstructions(b.functions()[0].instructions()),
+            R"(OpBranch %1
+%1 = OpLabel
+OpLoopMerge %2 %3 None
+OpBranch %4
+%4 = OpLabel
+OpSelectionMerge %7 None
+OpBranchConditional %6 %8 %7
+%8 = OpLabel
+OpBranch %2
+%7 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpBranch %1
+%2 = OpLabel
+)");
+  EXPECT_EQ(b.block_count(), 7u);
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
@@ -19,6 +19,10 @@
 #include "gtest/gtest.h"
 #include "spirv/unified1/spirv.h"
 #include "spirv/unified1/spirv.hpp11"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/return_statement.h"
+#include "src/ast/stage_decoration.h"
+#include "src/ast/variable_decl_statement.h"
 #include "src/program.h"
 #include "src/writer/spirv/spv_dump.h"
 #include "src/writer/spirv/test_helper.h"
@@ -59,6 +63,45 @@ TEST_F(BuilderTest, Capabilities_Dedup) {
   EXPECT_EQ(DumpInstructions(b.capabilities()), "OpCapability Shader\n");
 }
 
+TEST_F(BuilderTest, EncodeWords_MatchesRecordedInstructions) {
+  auto* g = Var("g", ast::StorageClass::kPrivate, ty.f32(), Expr(1.5f),
+                ast::VariableDecorationList{});
+  AST().AddGlobalVariable(g);
+
+  auto* v = Var("v", ast::StorageClass::kFunction, ty.vec3<f32>(),
+                vec3<f32>(1.f, 2.f, 3.f), ast::VariableDecorationList{});
+  auto* func =
+      Func("main", ast::VariableList{}, ty.void_(),
+           ast::StatementList{
+               create<ast::VariableDeclStatement>(v),
+               create<ast::AssignmentStatement>(Expr("g"), Expr(2.5f)),
+           },
+           ast::FunctionDecorationList{
+               create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+           });
+  AST().Functions().Add(func);
+
+  ASSERT_TRUE(td.Determine()) << td.error();
+
+  spirv::Builder& recorded = Build();
+  ASSERT_TRUE(recorded.Build()) << recorded.error();
+
+  spirv::Builder encoded(built_program());
+  encoded.set_encode_words(true);
+  ASSERT_TRUE(encoded.Build()) << encoded.error();
+
+  // Nothing is recorded when encoding words directly.
+  EXPECT_TRUE(encoded.types().empty());
+  EXPECT_TRUE(encoded.debug().empty());
+  ASSERT_EQ(encoded.functions().size(), 1u);
+  EXPECT_TRUE(encoded.functions()[0].instructions().empty());
+  EXPECT_TRUE(encoded.functions()[0].variables().empty());
+
+  EXPECT_EQ(encoded.id_bound(), recorded.id_bound());
+  EXPECT_EQ(encoded.total_size(), recorded.total_size());
+  EXPECT_EQ(DumpBuilder(encoded), DumpBuilder(recorded));
+}
+
 }  // namespace
 }  // namespace spirv
 }  // namespace writer
@@ -1092,6 +1092,26 @@ TEST_F(BuilderTest_Type, ComparisonSampler) {
   EXPECT_EQ(DumpInstructions(b.types()), "%1 = OpTypeSampler\n");
 }
 
+TEST_F(BuilderTest_Type, Dedup_DistinctTypeObjects) {
+  type::F32 f32_a;
+  type::F32 f32_b;
+  type::Vector vec_a(&f32_a, 3);
+  type::Vector vec_b(&f32_b, 3);
+  auto* vec_program = ty.vec3<f32>();
+
+  spirv::Builder& b = Build();
+
+  EXPECT_EQ(b.GenerateTypeIfNeeded(&vec_a), 1u);
+  EXPECT_EQ(b.GenerateTypeIfNeeded(&vec_b), 1u);
+  EXPECT_EQ(b.GenerateTypeIfNeeded(&f32_b), 2u);
+  EXPECT_EQ(b.GenerateTypeIfNeeded(vec_program), 1u);
+  ASSERT_FALSE(b.has_error()) << b.error();
+
+  EXPECT_EQ(DumpInstructions(b.types()), R"(%2 = OpTypeFloat 32
+%1 = OpTypeVector %2 3
+)");
+}
+
 TEST_F(BuilderTest_Type, Dedup_Sampler_And_ComparisonSampler) {
   type::Sampler comp_sampler(type::SamplerKind::kComparisonSampler);
   type::Sampler sampler(type::SamplerKind::kSampler);
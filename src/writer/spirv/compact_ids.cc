@@ -0,0 +1,69 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/compact_ids.h"
+
+#include "src/writer/spirv/operand_layout.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+bool CompactIds(std::vector<uint32_t>* module) {
+  if (module->size() < kHeaderWords) {
+    return false;
+  }
+  const uint32_t bound = (*module)[kBoundIndex];
+
+  // Assign the new IDs in the order the old IDs are first seen. The module is
+  // only rewritten once every instruction is known to be understood.
+  std::vector<uint32_t> remap(bound, 0);
+  uint32_t next_id = 1;
+  bool ok = true;
+  auto assign = [&](uint32_t* id) {
+    if (*id == 0 || *id >= bound) {
+      ok = false;
+    } else if (remap[*id] == 0) {
+      remap[*id] = next_id++;
+    }
+  };
+
+  uint32_t* words = module->data();
+  const size_t size = module->size();
+  for (size_t i = kHeaderWords; i < size;) {
+    const uint32_t count = words[i] >> 16;
+    if (count == 0 || i + count > size) {
+      return false;
+    }
+    auto op = static_cast<spv::Op>(words[i] & 0xffff);
+    if (!ForEachId(op, &words[i + 1], &words[i + count], assign) || !ok) {
+      return false;
+    }
+    i += count;
+  }
+
+  for (size_t i = kHeaderWords; i < size;) {
+    const uint32_t count = words[i] >> 16;
+    auto op = static_cast<spv::Op>(words[i] & 0xffff);
+    ForEachId(op, &words[i + 1], &words[i + count],
+              [&](uint32_t* id) { *id = remap[*id]; });
+    i += count;
+  }
+  words[kBoundIndex] = next_id;
+  return true;
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
@@ -0,0 +1,143 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/compact_ids.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spirv/unified1/spirv.hpp11"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/stage_decoration.h"
+#include "src/writer/spirv/binary_writer.h"
+#include "src/writer/spirv/generator.h"
+#include "src/writer/spirv/module_test_helper.h"
+#include "src/writer/spirv/test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+using CompactIdsTest = TestHelper;
+
+/// @returns the words of a module with the given bound and the ids used by a
+/// minimal fragment shader
+std::vector<uint32_t> MakeModule(uint32_t bound,
+                                 uint32_t void_id,
+                                 uint32_t func_type_id,
+                                 uint32_t float_id,
+                                 uint32_t const_id,
+                                 uint32_t func_id,
+                                 uint32_t label_id) {
+  return Assemble(
+      bound,
+      {Prelude(func_id),
+       {
+           {spv::Op::OpTypeVoid, {Operand::Int(void_id)}},
+           {spv::Op::OpTypeFunction,
+            {Operand::Int(func_type_id), Operand::Int(void_id)}},
+           {spv::Op::OpTypeFloat, {Operand::Int(float_id), Operand::Int(32)}},
+           // The literal matches an old ID, and must not be renumbered
+           {spv::Op::OpConstant,
+            {Operand::Int(float_id), Operand::Int(const_id),
+             Operand::Int(10)}},
+           {spv::Op::OpFunction,
+            {Operand::Int(void_id), Operand::Int(func_id),
+             Operand::Int(SpvFunctionControlMaskNone),
+             Operand::Int(func_type_id)}},
+           {spv::Op::OpLabel, {Operand::Int(label_id)}},
+           {spv::Op::OpReturn, {}},
+           {spv::Op::OpFunctionEnd, {}},
+       }});
+}
+
+TEST_F(CompactIdsTest, RenumbersInOrderOfFirstUse) {
+  auto module = MakeModule(20, 10, 12, 15, 17, 18, 19);
+  ASSERT_TRUE(CompactIds(&module));
+  EXPECT_EQ(module, MakeModule(7, 2, 3, 4, 5, 1, 6));
+}
+
+TEST_F(CompactIdsTest, IdOutsideBound) {
+  auto module = MakeModule(19, 10, 12, 15, 17, 18, 19);
+  auto original = module;
+  EXPECT_FALSE(CompactIds(&module));
+  EXPECT_EQ(module, original);
+}
+
+TEST_F(CompactIdsTest, UnknownInstruction) {
+  auto module = MakeModule(20, 10, 12, 15, 17, 18, 19);
+  BinaryWriter bw;
+  bw.WriteInstruction(
+      Instruction{spv::Op::OpUndef, {Operand::Int(15), Operand::Int(11)}});
+  module.insert(module.end(), bw.result().begin(), bw.result().end());
+  auto original = module;
+  EXPECT_FALSE(CompactIds(&module));
+  EXPECT_EQ(module, original);
+}
+
+TEST_F(CompactIdsTest, GeneratorCompactOutput) {
+  auto* g = Var("g", ast::StorageClass::kPrivate, ty.f32(), Expr(1.5f),
+                ast::VariableDecorationList{});
+  AST().AddGlobalVariable(g);
+
+  auto* func =
+      Func("main", ast::VariableList{}, ty.void_(),
+           ast::StatementList{
+               create<ast::AssignmentStatement>(Expr("g"), Expr(2.5f)),
+           },
+           ast::FunctionDecorationList{
+               create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+           });
+  AST().Functions().Add(func);
+
+  ASSERT_TRUE(td.Determine()) << td.error();
+  Build();
+
+  Generator full(built_program());
+  ASSERT_TRUE(full.Generate()) << full.error();
+
+  Generator compact(built_program());
+  compact.set_compact(true);
+  ASSERT_TRUE(compact.Generate()) << compact.error();
+
+  const auto& words = compact.result();
+  ASSERT_GT(words.size(), 5u);
+  EXPECT_LT(words.size(), full.result().size());
+  EXPECT_LE(words[3], full.result()[3]);
+
+  for (size_t i = 5; i < words.size(); i += words[i] >> 16) {
+    ASSERT_NE(words[i] >> 16, 0u);
+    auto op = static_cast<spv::Op>(words[i] & 0xffff);
+    EXPECT_NE(op, spv::Op::OpName);
+    EXPECT_NE(op, spv::Op::OpMemberName);
+  }
+
+  // Compacting an already compact module does not change it.
+  auto recompacted = words;
+  ASSERT_TRUE(CompactIds(&recompacted));
+  EXPECT_EQ(recompacted, words);
+
+  std::vector<uint32_t> streamed;
+  VectorOutputSink sink(&streamed);
+  Generator compact_streamed(built_program());
+  compact_streamed.set_compact(true);
+  ASSERT_TRUE(compact_streamed.Generate(&sink)) << compact_streamed.error();
+  EXPECT_EQ(streamed, words);
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
@@ -0,0 +1,174 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/dedup_functions.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "src/writer/spirv/operand_layout.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+/// A function of the module, as the range of its words
+struct FunctionRange {
+  size_t begin;
+  size_t end;
+  bool removed;
+};
+
+}  // namespace
+
+bool DedupFunctions(std::vector<uint32_t>* module) {
+  if (module->size() < kHeaderWords) {
+    return false;
+  }
+  const uint32_t bound = (*module)[kBoundIndex];
+  uint32_t* words = module->data();
+  const size_t size = module->size();
+
+  // IDs declared outside of the functions, and the IDs of the functions, are
+  // external to every function body. The debug names are skipped, as they
+  // also name the function-local IDs.
+  std::unordered_set<uint32_t> external;
+  std::unordered_set<uint32_t> entry_points;
+  std::vector<FunctionRange> functions;
+  auto add_external = [&](uint32_t* id) { external.insert(*id); };
+  for (size_t i = kHeaderWords; i < size;) {
+    const uint32_t count = words[i] >> 16;
+    if (count == 0 || i + count > size) {
+      return false;
+    }
+    auto op = static_cast<spv::Op>(words[i] & 0xffff);
+    bool in_function = !functions.empty() && functions.back().end == 0;
+    if (op == spv::Op::OpFunction) {
+      if (in_function || count < 3) {
+        return false;
+      }
+      external.insert(words[i + 2]);
+      functions.push_back(FunctionRange{i, 0, false});
+    } else if (op == spv::Op::OpFunctionEnd) {
+      if (!in_function) {
+        return false;
+      }
+      functions.back().end = i + count;
+    } else if (in_function) {
+      if (OperandLayout(op) == nullptr) {
+        return false;
+      }
+    } else if (!functions.empty()) {
+      return false;  // Only functions may follow the first function
+    } else {
+      if (op == spv::Op::OpEntryPoint && count > 2) {
+        entry_points.insert(words[i + 2]);
+      }
+      if (op != spv::Op::OpName && op != spv::Op::OpMemberName &&
+          !ForEachId(op, &words[i + 1], &words[i + count], add_external)) {
+        return false;
+      }
+    }
+    i += count;
+  }
+  if (!functions.empty() && functions.back().end == 0) {
+    return false;
+  }
+
+  // Functions are visited in module order. A callee is declared before its
+  // callers, so calls are redirected before the caller is compared, and
+  // callers of duplicates can be found to be duplicates themselves.
+  std::unordered_map<uint32_t, uint32_t> redirect;
+  std::unordered_map<std::vector<uint32_t>, uint32_t, WordsHasher> canonical;
+  std::unordered_set<uint32_t> removed_ids;
+  std::vector<uint32_t> key;
+  std::unordered_map<uint32_t, uint32_t> local;
+  for (auto& func : functions) {
+    const uint32_t func_id = words[func.begin + 2];
+
+    key.assign(words + func.begin, words + func.end);
+    key[2] = 0;
+    local.clear();
+    for (size_t i = func.begin; i < func.end;) {
+      const uint32_t count = words[i] >> 16;
+      auto op = static_cast<spv::Op>(words[i] & 0xffff);
+      ForEachId(op, &words[i + 1], &words[i + count], [&](uint32_t* id) {
+        auto r = redirect.find(*id);
+        if (r != redirect.end()) {
+          *id = r->second;
+        }
+        auto offset = static_cast<size_t>(id - words) - func.begin;
+        if (offset == 2) {
+          return;  // The OpFunction result ID
+        }
+        if (external.count(*id) != 0) {
+          key[offset] = *id;
+          return;
+        }
+        // Local IDs are numbered past the bound, so they never match an
+        // external ID.
+        auto next = bound + static_cast<uint32_t>(local.size());
+        key[offset] = local.emplace(*id, next).first->second;
+      });
+      i += count;
+    }
+
+    if (entry_points.count(func_id) != 0) {
+      continue;
+    }
+    auto match = canonical.emplace(key, func_id);
+    if (!match.second) {
+      func.removed = true;
+      redirect[func_id] = match.first->second;
+      removed_ids.insert(func_id);
+      for (auto& l : local) {
+        removed_ids.insert(l.first);
+      }
+    }
+  }
+
+  if (removed_ids.empty()) {
+    return true;
+  }
+
+  // Rebuild the module without the removed functions, or the debug names
+  // and decorations that target their IDs.
+  std::vector<uint32_t> out(words, words + kHeaderWords);
+  out.reserve(size);
+  const size_t functions_begin = functions.front().begin;
+  for (size_t i = kHeaderWords; i < functions_begin;) {
+    const uint32_t count = words[i] >> 16;
+    auto op = static_cast<spv::Op>(words[i] & 0xffff);
+    bool targets_removed =
+        (op == spv::Op::OpName || op == spv::Op::OpMemberName ||
+         op == spv::Op::OpDecorate || op == spv::Op::OpMemberDecorate) &&
+        removed_ids.count(words[i + 1]) != 0;
+    if (!targets_removed) {
+      out.insert(out.end(), words + i, words + i + count);
+    }
+    i += count;
+  }
+  for (const auto& func : functions) {
+    if (!func.removed) {
+      out.insert(out.end(), words + func.begin, words + func.end);
+    }
+  }
+  *module = std::move(out);
+  return true;
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
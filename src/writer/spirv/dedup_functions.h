@@ -0,0 +1,43 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_DEDUP_FUNCTIONS_H_
+#define SRC_WRITER_SPIRV_DEDUP_FUNCTIONS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+/// Removes the functions of a SPIR-V module that are identical to an earlier
+/// function, and redirects the calls to them to the earlier function.
+/// Functions are compared after their local IDs are renumbered in order of
+/// first use, so two functions generated from the same body under different
+/// names are identical. Entry points are never removed. The bound is not
+/// changed; use CompactIds() to reclaim the unused IDs.
+/// Only the instructions emitted by the Builder are understood. If the module
+/// contains any other instruction, it is left unchanged.
+/// @param module the words of the module, including the header
+/// @returns true if the module was understood
+bool DedupFunctions(std::vector<uint32_t>* module);
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_DEDUP_FUNCTIONS_H_
@@ -0,0 +1,131 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/dedup_functions.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spirv/unified1/spirv.hpp11"
+#include "src/writer/spirv/module_test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+/// @returns a function with the ID `id` that computes `op` on the constant
+InstructionList Helper(uint32_t id,
+                       uint32_t label_id,
+                       uint32_t value_id,
+                       spv::Op op) {
+  return {
+      {spv::Op::OpFunction,
+       {Operand::Int(1), Operand::Int(id),
+        Operand::Int(SpvFunctionControlMaskNone), Operand::Int(3)}},
+      {spv::Op::OpLabel, {Operand::Int(label_id)}},
+      {op, {Operand::Int(2), Operand::Int(value_id), Operand::Int(4),
+            Operand::Int(4)}},
+      {spv::Op::OpReturn, {}},
+      {spv::Op::OpFunctionEnd, {}},
+  };
+}
+
+/// @returns a function with the ID `id` that calls each of `callees`
+InstructionList Caller(uint32_t id,
+                       uint32_t label_id,
+                       uint32_t first_call_id,
+                       const std::vector<uint32_t>& callees) {
+  InstructionList insts = {
+      {spv::Op::OpFunction,
+       {Operand::Int(1), Operand::Int(id),
+        Operand::Int(SpvFunctionControlMaskNone), Operand::Int(3)}},
+      {spv::Op::OpLabel, {Operand::Int(label_id)}},
+  };
+  for (auto callee : callees) {
+    insts.push_back({spv::Op::OpFunctionCall,
+                     {Operand::Int(1), Operand::Int(first_call_id++),
+                      Operand::Int(callee)}});
+  }
+  insts.push_back({spv::Op::OpReturn, {}});
+  insts.push_back({spv::Op::OpFunctionEnd, {}});
+  return insts;
+}
+
+TEST(DedupFunctionsTest, RemovesDuplicateAndRedirectsCalls) {
+  // a (%10) and b (%11) are identical, c (%17) is not.
+  auto module = Assemble(
+      25, {Prelude(20),
+           {Name(10, "a"), Name(11, "b"), Name(17, "c")},
+           Types(),
+           Helper(10, 13, 14, spv::Op::OpFAdd),
+           Helper(11, 15, 16, spv::Op::OpFAdd),
+           Helper(17, 18, 19, spv::Op::OpFMul),
+           Caller(20, 21, 22, {10, 11, 17})});
+
+  ASSERT_TRUE(DedupFunctions(&module));
+
+  EXPECT_EQ(module, Assemble(25, {Prelude(20),
+                                  {Name(10, "a"), Name(17, "c")},
+                                  Types(),
+                                  Helper(10, 13, 14, spv::Op::OpFAdd),
+                                  Helper(17, 18, 19, spv::Op::OpFMul),
+                                  Caller(20, 21, 22, {10, 10, 17})}));
+}
+
+TEST(DedupFunctionsTest, CallersOfDuplicatesAreDuplicates) {
+  // b (%11) duplicates a (%10), so d (%30) calling b duplicates c (%17)
+  // calling a.
+  auto module = Assemble(40, {Prelude(20), Types(),
+                              Helper(10, 13, 14, spv::Op::OpFAdd),
+                              Helper(11, 15, 16, spv::Op::OpFAdd),
+                              Caller(17, 18, 19, {10}),
+                              Caller(30, 31, 32, {11}),
+                              Caller(20, 21, 22, {17, 30})});
+
+  ASSERT_TRUE(DedupFunctions(&module));
+
+  EXPECT_EQ(module, Assemble(40, {Prelude(20), Types(),
+                                  Helper(10, 13, 14, spv::Op::OpFAdd),
+                                  Caller(17, 18, 19, {10}),
+                                  Caller(20, 21, 22, {17, 17})}));
+}
+
+TEST(DedupFunctionsTest, KeepsEntryPoints) {
+  // The entry point %20 has the same body as %10, but is never removed.
+  auto module = Assemble(25, {Prelude(20), Types(),
+                              Caller(10, 11, 12, {}),
+                              Caller(20, 21, 22, {})});
+  auto original = module;
+
+  ASSERT_TRUE(DedupFunctions(&module));
+  EXPECT_EQ(module, original);
+}
+
+TEST(DedupFunctionsTest, UnknownInstruction) {
+  auto module = Assemble(
+      25, {Prelude(20), Types(), Helper(10, 13, 14, spv::Op::OpFAdd),
+           Helper(11, 15, 16, spv::Op::OpFAdd),
+           {{spv::Op::OpUndef, {Operand::Int(2), Operand::Int(24)}}},
+           Caller(20, 21, 22, {10, 11})});
+  auto original = module;
+
+  EXPECT_FALSE(DedupFunctions(&module));
+  EXPECT_EQ(module, original);
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
@@ -56,20 +56,55 @@ void Function::iterate(std::function<void(const Instruction&)> cb) const {
     cb(inst);
   }
 
-  bool needs_terminator = false;
-  if (instructions_.empty()) {
-    needs_terminator = true;
-  } else {
-    const auto& last = instructions_.back();
-    needs_terminator = !OpIsFunctionTerminator(last.opcode());
-  }
-  if (needs_terminator) {
+  if (!OpIsFunctionTerminator(last_op_)) {
     cb(Instruction{spv::Op::OpReturn, {}});
   }
 
   cb(Instruction{spv::Op::OpFunctionEnd, {}});
 }
 
+void Function::Encode(OutputSink* sink) const {
+  // Recorded instructions are encoded into `words`, which is flushed to the
+  // sink before any of the directly encoded word buffers are written.
+  std::vector<uint32_t> words;
+  auto flush = [&] {
+    if (!words.empty()) {
+      sink->Write(words.data(), words.size());
+      words.clear();
+    }
+  };
+  auto write = [&](const std::vector<uint32_t>& buffer) {
+    if (!buffer.empty()) {
+      flush();
+      sink->Write(buffer.data(), buffer.size());
+    }
+  };
+
+  EncodeInstruction(declaration_.opcode(), declaration_.operands(), &words);
+
+  for (const auto& param : params_) {
+    EncodeInstruction(param.opcode(), param.operands(), &words);
+  }
+
+  EncodeInstruction(spv::Op::OpLabel, {label_op_}, &words);
+
+  for (const auto& var : vars_) {
+    EncodeInstruction(var.opcode(), var.operands(), &words);
+  }
+  write(var_words_);
+  for (const auto& inst : instructions_) {
+    EncodeInstruction(inst.opcode(), inst.operands(), &words);
+  }
+  write(instruction_words_);
+
+  if (!OpIsFunctionTerminator(last_op_)) {
+    EncodeInstruction(spv::Op::OpReturn, {}, &words);
+  }
+
+  EncodeInstruction(spv::Op::OpFunctionEnd, {}, &words);
+  flush();
+}
+
 }  // namespace spirv
 }  // namespace writer
 }  // namespace tint
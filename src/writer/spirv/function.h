@@ -16,11 +16,13 @@
 #define SRC_WRITER_SPIRV_FUNCTION_H_
 
 #include <functional>
+#include <utility>
 #include <vector>
 
 #include "spirv/unified1/spirv.hpp11"
 #include "src/writer/spirv/instruction.h"
 #include "src/writer/spirv/operand.h"
+#include "src/writer/spirv/output_sink.h"
 
 namespace tint {
 namespace writer {
@@ -46,9 +48,21 @@ class Function {
   ~Function();
 
   /// Iterates over the function call the cb on each instruction
+  /// @note only the recorded instructions are visited, so this must not be
+  /// used if set_encode_words() has been enabled.
   /// @param cb the callback to call
   void iterate(std::function<void(const Instruction&)> cb) const;
 
+  /// Streams the binary encoding of the function to `sink`
+  /// @param sink the sink to write to
+  void Encode(OutputSink* sink) const;
+
+  /// Enables direct encoding of the function's variables and instructions.
+  /// When enabled, push_inst() and push_var() encode straight into word
+  /// buffers, and instructions() and variables() remain empty.
+  /// @param enable true to encode words directly
+  void set_encode_words(bool enable) { encode_words_ = enable; }
+
   /// @returns the declaration
   const Instruction& declaration() const { return declaration_; }
 
@@ -58,16 +72,25 @@ class Function {
   /// Adds an instruction to the instruction list
   /// @param op the op to set
   /// @param operands the operands for the instruction
-  void push_inst(spv::Op op, const OperandList& operands) {
-    instructions_.push_back(Instruction{op, operands});
+  void push_inst(spv::Op op, OperandList operands) {
+    last_op_ = op;
+    if (encode_words_) {
+      EncodeInstruction(op, operands, &instruction_words_);
+    } else {
+      instructions_.push_back(Instruction{op, std::move(operands)});
+    }
   }
   /// @returns the instruction list
   const InstructionList& instructions() const { return instructions_; }
 
   /// Adds a variable to the variable list
   /// @param operands the operands for the variable
-  void push_var(const OperandList& operands) {
-    vars_.push_back(Instruction{spv::Op::OpVariable, operands});
+  void push_var(OperandList operands) {
+    if (encode_words_) {
+      EncodeInstruction(spv::Op::OpVariable, operands, &var_words_);
+    } else {
+      vars_.push_back(Instruction{spv::Op::OpVariable, std::move(operands)});
+    }
   }
   /// @returns the variable list
   const InstructionList& variables() const { return vars_; }
@@ -86,6 +109,8 @@ class Function {
     for (const auto& inst : instructions_) {
       size += inst.word_length();
     }
+    size += static_cast<uint32_t>(var_words_.size());
+    size += static_cast<uint32_t>(instruction_words_.size());
     return size;
   }
 
@@ -95,6 +120,11 @@ class Function {
   InstructionList params_;
   InstructionList vars_;
   InstructionList instructions_;
+  bool encode_words_ = false;
+  std::vector<uint32_t> var_words_;
+  std::vector<uint32_t> instruction_words_;
+  // The opcode of the last instruction added with push_inst()
+  spv::Op last_op_ = spv::Op::OpNop;
 };
 
 }  // namespace spirv
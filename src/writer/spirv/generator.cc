@@ -16,13 +16,20 @@
 
 #include <utility>
 
+#include "src/ast/module.h"
+#include "src/writer/spirv/structure_check.h"
+
 namespace tint {
 namespace writer {
 namespace spirv {
 
 Generator::Generator(const Program* program)
-    : builder_(std::make_unique<Builder>(program)),
-      writer_(std::make_unique<BinaryWriter>()) {}
+    : program_(program),
+      builder_(std::make_unique<Builder>(program)),
+      writer_(std::make_unique<BinaryWriter>()) {
+  // The generator never inspects the instructions, so encode them directly.
+  builder_->set_encode_words(true);
+}
 
 Generator::~Generator() = default;
 
@@ -34,11 +41,96 @@ bool Generator::Generate() {
 
   writer_->WriteHeader(builder_->id_bound());
   writer_->WriteBuilder(builder_.get());
+  return PostProcess(writer_.get());
+}
+
+bool Generator::Generate(OutputSink* sink) {
+  if (!builder_->Build()) {
+    set_error(builder_->error());
+    return false;
+  }
+
+  if (compact_ || dedup_functions_ || check_structure_) {
+    // The module passes need the whole module to be assembled.
+    BinaryWriter writer;
+    writer.WriteHeader(builder_->id_bound());
+    writer.WriteBuilder(builder_.get());
+    if (!PostProcess(&writer)) {
+      return false;
+    }
+    sink->Write(writer.result().data(), writer.result().size());
+    return true;
+  }
+
+  BinaryWriter::WriteHeader(builder_->id_bound(), sink);
+  builder_->Encode(sink);
   return true;
 }
 
-bool Generator::GenerateEntryPoint(ast::PipelineStage, const std::string&) {
-  return false;
+bool Generator::GenerateEntryPoint(ast::PipelineStage stage,
+                                   const std::string& name) {
+  auto* func =
+      program_->AST().Functions().Find(program_->Symbols().Get(name), stage);
+  if (func == nullptr) {
+    set_error("Unable to find requested entry point: " + name);
+    return false;
+  }
+
+  if (!builder_->Build()) {
+    set_error(builder_->error());
+    return false;
+  }
+
+  writer_->WriteHeader(builder_->id_bound());
+  if (!writer_->WriteEntryPoint(builder_.get(), func)) {
+    set_error("unable to write entry point: " + name);
+    return false;
+  }
+  return PostProcess(writer_.get());
+}
+
+bool Generator::GenerateEntryPoints(std::vector<EntryPointModule>* modules) {
+  if (!builder_->Build()) {
+    set_error(builder_->error());
+    return false;
+  }
+
+  for (auto* func : program_->AST().Functions()) {
+    if (!func->IsEntryPoint()) {
+      continue;
+    }
+    auto name = program_->Symbols().NameFor(func->symbol());
+
+    BinaryWriter writer;
+    writer.WriteHeader(builder_->id_bound());
+    if (!writer.WriteEntryPoint(builder_.get(), func)) {
+      set_error("unable to write entry point: " + name);
+      return false;
+    }
+    if (!PostProcess(&writer)) {
+      return false;
+    }
+    modules->push_back(
+        EntryPointModule{name, func->pipeline_stage(), writer.result()});
+  }
+  return true;
+}
+
+bool Generator::PostProcess(BinaryWriter* writer) {
+  if (dedup_functions_ && !writer->DedupFunctions()) {
+    set_error("unable to deduplicate the module functions");
+    return false;
+  }
+  if (compact_ && !writer->Compact()) {
+    set_error("unable to renumber the module IDs");
+    return false;
+  }
+  std::string problem;
+  if (check_structure_ && !CheckStructure(writer->result(), &problem)) {
+    set_error("invalid module structure: " + problem);
+    return false;
+  }
+  return true;
 }
 
 }  // namespace spirv
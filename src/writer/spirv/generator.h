@@ -22,12 +22,23 @@
 #include "src/program.h"
 #include "src/writer/spirv/binary_writer.h"
 #include "src/writer/spirv/builder.h"
+#include "src/writer/spirv/output_sink.h"
 #include "src/writer/writer.h"
 
 namespace tint {
 namespace writer {
 namespace spirv {
 
+/// A SPIR-V module holding a single entry point
+struct EntryPointModule {
+  /// The entry point name
+  std::string name;
+  /// The entry point pipeline stage
+  ast::PipelineStage stage;
+  /// The SPIR-V of the module
+  std::vector<uint32_t> spirv;
+};
+
 /// Class to generate SPIR-V from a Tint program
 class Generator : public writer::Writer {
  public:
@@ -42,6 +53,56 @@ class Generator : public writer::Writer {
   /// @returns true on successful generation; false otherwise
   bool Generate() override;
 
+  /// Generates the module and streams it to `sink` as it is assembled. The
+  /// words are not retained, so result() is left empty. With compact output,
+  /// function deduplication or structure checks the module is assembled
+  /// before it is written, as those passes work over the whole module.
+  /// @param sink the sink to write the SPIR-V to
+  /// @returns true on successful generation; false otherwise
+  bool Generate(OutputSink* sink);
+
+  /// Enables the builder's memory access optimizations. Must be called before
+  /// Generate().
+  /// @param enable true to reuse access chains and forward loads and stores
+  /// within basic blocks
+  void set_optimize_memory_accesses(bool enable) {
+    builder_->set_optimize_memory_accesses(enable);
+  }
+
+  /// Enables merged control flow emission, which folds empty blocks and
+  /// generates conditional breaks and continues as single branches. Must be
+  /// called before Generate().
+  /// @param enable true to merge control flow
+  void set_merge_control_flow(bool enable) {
+    builder_->set_merge_control_flow(enable);
+  }
+
+  /// @returns the number of basic blocks generated
+  uint32_t block_count() const { return builder_->block_count(); }
+
+  /// Enables compact output, for the smallest modules. When enabled, the debug
+  /// instructions are omitted and the IDs are renumbered to a dense range,
+  /// giving the minimal bound. Must be called before Generate().
+  /// @param enable true to generate compact output
+  void set_compact(bool enable) {
+    compact_ = enable;
+    builder_->set_strip_debug(enable);
+  }
+
+  /// Enables function deduplication. When enabled, functions that are
+  /// identical to an earlier function, apart from their IDs, are removed and
+  /// calls to them are redirected to the earlier function. Must be called
+  /// before Generate().
+  /// @param enable true to deduplicate functions
+  void set_dedup_functions(bool enable) { dedup_functions_ = enable; }
+
+  /// Enables the structure check of every generated module. When enabled,
+  /// generation fails if CheckStructure() finds a problem with the module.
+  /// This is much cheaper than full validation. Must be called before
+  /// Generate().
+  /// @param enable true to check the structure of the generated modules
+  void set_check_structure(bool enable) { check_structure_ = enable; }
+
   /// Converts a single entry point
   /// @param stage the pipeline stage
   /// @param name the entry point name
@@ -49,12 +110,29 @@ class Generator : public writer::Writer {
   bool GenerateEntryPoint(ast::PipelineStage stage,
                           const std::string& name) override;
 
+  /// Generates a module for each entry point of the program, in a single
+  /// pass. The types, constants and global variables are generated once and
+  /// shared by all the modules, and each module holds only the functions
+  /// reachable from its entry point. result() is left empty.
+  /// @param modules the list to append the modules to
+  /// @returns true on success; false on failure
+  bool GenerateEntryPoints(std::vector<EntryPointModule>* modules);
+
   /// @returns the result data
   const std::vector<uint32_t>& result() const { return writer_->result(); }
 
  private:
+  /// Applies the enabled module passes to the module assembled in `writer`
+  /// @param writer the writer holding the module
+  /// @returns true on success; false on failure
+  bool PostProcess(BinaryWriter* writer);
+
+  const Program* program_;
   std::unique_ptr<Builder> builder_;
   std::unique_ptr<BinaryWriter> writer_;
+  bool compact_ = false;
+  bool dedup_functions_ = false;
+  bool check_structure_ = false;
 };
 
 }  // namespace spirv
@@ -0,0 +1,295 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/generator.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spirv-tools/libspirv.hpp"
+#include "src/ast/assignment_statement.h"
+#include "src/ast/binary_expression.h"
+#include "src/ast/break_statement.h"
+#include "src/ast/call_statement.h"
+#include "src/ast/continue_statement.h"
+#include "src/ast/else_statement.h"
+#include "src/ast/if_statement.h"
+#include "src/ast/loop_statement.h"
+#include "src/ast/stage_decoration.h"
+#include "src/ast/variable_decl_statement.h"
+#include "src/writer/spirv/test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+/// @returns the number of `op` instructions in the module `words`
+size_t CountInstructions(const std::vector<uint32_t>& words, spv::Op op) {
+  size_t count = 0;
+  for (size_t i = 5; i < words.size() && (words[i] >> 16) != 0;
+       i += words[i] >> 16) {
+    if (static_cast<spv::Op>(words[i] & 0xffff) == op) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/// @returns the spirv-tools validation errors for `words`
+std::string Validate(const std::vector<uint32_t>& words) {
+  std::string spv_errors;
+  spvtools::SpirvTools tools(SPV_ENV_VULKAN_1_2);
+  tools.SetMessageConsumer([&spv_errors](spv_message_level_t, const char*,
+                                         const spv_position_t& position,
+                                         const char* message) {
+    spv_errors += "line " + std::to_string(position.index) + ": " +
+                  message + "\n";
+  });
+  if (!tools.Validate(words)) {
+    return spv_errors.empty() ? "validation failed" : spv_errors;
+  }
+  return "";
+}
+
+class GeneratorTest : public TestHelper {
+ public:
+  /// Builds a program with a fragment entry point that calls `helper`, a
+  /// vertex entry point, and a function that neither of them calls
+  void BuildEntryPoints() {
+    // var<private> g : f32;
+    // fn helper() -> void { g = 1.0; }
+    // fn unused() -> void { var u : f32; u = 2.0; }
+    // [[stage(fragment)]] fn frag_main() -> void { helper(); }
+    // [[stage(vertex)]] fn vert_main() -> void { var v : f32; v = g; }
+    AST().AddGlobalVariable(Var("g", ast::StorageClass::kPrivate, ty.f32()));
+
+    AST().Functions().Add(
+        Func("helper", ast::VariableList{}, ty.void_(),
+             ast::StatementList{
+                 create<ast::AssignmentStatement>(Expr("g"), Expr(1.f)),
+             },
+             ast::FunctionDecorationList{}));
+
+    AST().Functions().Add(Func(
+        "unused", ast::VariableList{}, ty.void_(),
+        ast::StatementList{
+            create<ast::VariableDeclStatement>(
+                Var("u", ast::StorageClass::kFunction, ty.f32())),
+            create<ast::AssignmentStatement>(Expr("u"), Expr(2.f)),
+        },
+        ast::FunctionDecorationList{}));
+
+    AST().Functions().Add(
+        Func("frag_main", ast::VariableList{}, ty.void_(),
+             ast::StatementList{
+                 create<ast::CallStatement>(Call("helper")),
+             },
+             ast::FunctionDecorationList{
+                 create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+             }));
+
+    AST().Functions().Add(Func(
+        "vert_main", ast::VariableList{}, ty.void_(),
+        ast::StatementList{
+            create<ast::VariableDeclStatement>(
+                Var("v", ast::StorageClass::kFunction, ty.f32())),
+            create<ast::AssignmentStatement>(Expr("v"), Expr("g")),
+        },
+        ast::FunctionDecorationList{
+            create<ast::StageDecoration>(ast::PipelineStage::kVertex),
+        }));
+
+    ASSERT_TRUE(td.Determine()) << td.error();
+    Build();
+  }
+};
+
+TEST_F(GeneratorTest, GenerateEntryPoints) {
+  BuildEntryPoints();
+
+  Generator gen(built_program());
+  std::vector<EntryPointModule> modules;
+  ASSERT_TRUE(gen.GenerateEntryPoints(&modules)) << gen.error();
+  EXPECT_TRUE(gen.result().empty());
+
+  ASSERT_EQ(modules.size(), 2u);
+  EXPECT_EQ(modules[0].name, "frag_main");
+  EXPECT_EQ(modules[0].stage, ast::PipelineStage::kFragment);
+  EXPECT_EQ(modules[1].name, "vert_main");
+  EXPECT_EQ(modules[1].stage, ast::PipelineStage::kVertex);
+
+  // frag_main and helper
+  const auto& frag = modules[0].spirv;
+  EXPECT_EQ(CountInstructions(frag, spv::Op::OpEntryPoint), 1u);
+  EXPECT_EQ(CountInstructions(frag, spv::Op::OpFunction), 2u);
+  // g, helper and frag_main
+  EXPECT_EQ(CountInstructions(frag, spv::Op::OpName), 3u);
+  EXPECT_EQ(Validate(frag), "");
+
+  // vert_main only
+  const auto& vert = modules[1].spirv;
+  EXPECT_EQ(CountInstructions(vert, spv::Op::OpEntryPoint), 1u);
+  EXPECT_EQ(CountInstructions(vert, spv::Op::OpFunction), 1u);
+  // g, vert_main and v
+  EXPECT_EQ(CountInstructions(vert, spv::Op::OpName), 3u);
+  EXPECT_EQ(Validate(vert), "");
+}
+
+TEST_F(GeneratorTest, GenerateEntryPoint_MatchesGenerateEntryPoints) {
+  BuildEntryPoints();
+
+  Generator all(built_program());
+  std::vector<EntryPointModule> modules;
+  ASSERT_TRUE(all.GenerateEntryPoints(&modules)) << all.error();
+  ASSERT_EQ(modules.size(), 2u);
+
+  Generator single(built_program());
+  ASSERT_TRUE(single.GenerateEntryPoint(ast::PipelineStage::kVertex,
+                                        "vert_main"))
+      << single.error();
+  EXPECT_EQ(single.result(), modules[1].spirv);
+}
+
+TEST_F(GeneratorTest, GenerateEntryPoint_Missing) {
+  BuildEntryPoints();
+
+  Generator gen(built_program());
+  EXPECT_FALSE(gen.GenerateEntryPoint(ast::PipelineStage::kFragment,
+                                      "vert_main"));
+  EXPECT_EQ(gen.error(), "Unable to find requested entry point: vert_main");
+}
+
+TEST_F(GeneratorTest, CheckStructure) {
+  BuildEntryPoints();
+
+  Generator gen(built_program());
+  gen.set_check_structure(true);
+  ASSERT_TRUE(gen.Generate()) << gen.error();
+
+  Generator per_entry_point(built_program());
+  per_entry_point.set_check_structure(true);
+  std::vector<EntryPointModule> modules;
+  ASSERT_TRUE(per_entry_point.GenerateEntryPoints(&modules))
+      << per_entry_point.error();
+}
+
+TEST_F(GeneratorTest, DedupFunctions) {
+  // var<private> g : f32;
+  // fn a() -> void { g = 1.0; }
+  // fn b() -> void { g = 1.0; }
+  // [[stage(fragment)]] fn main() -> void { a(); b(); }
+  AST().AddGlobalVariable(Var("g", ast::StorageClass::kPrivate, ty.f32()));
+  for (auto* name : {"a", "b"}) {
+    AST().Functions().Add(
+        Func(name, ast::VariableList{}, ty.void_(),
+             ast::StatementList{
+                 create<ast::AssignmentStatement>(Expr("g"), Expr(1.f)),
+             },
+             ast::FunctionDecorationList{}));
+  }
+  AST().Functions().Add(
+      Func("main", ast::VariableList{}, ty.void_(),
+           ast::StatementList{
+               create<ast::CallStatement>(Call("a")),
+               create<ast::CallStatement>(Call("b")),
+           },
+           ast::FunctionDecorationList{
+               create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+           }));
+  ASSERT_TRUE(td.Determine()) << td.error();
+  Build();
+
+  Generator plain(built_program());
+  ASSERT_TRUE(plain.Generate()) << plain.error();
+  EXPECT_EQ(CountInstructions(plain.result(), spv::Op::OpFunction), 3u);
+
+  Generator dedup(built_program());
+  dedup.set_dedup_functions(true);
+  ASSERT_TRUE(dedup.Generate()) << dedup.error();
+  EXPECT_EQ(CountInstructions(dedup.result(), spv::Op::OpFunction), 2u);
+  EXPECT_EQ(CountInstructions(dedup.result(), spv::Op::OpFunctionCall), 2u);
+  EXPECT_EQ(Validate(dedup.result()), "");
+}
+
+TEST_F(GeneratorTest, MergeControlFlow) {
+  // var<private> g : i32;
+  // [[stage(fragment)]] fn main() -> void {
+  //   loop {
+  //     if (g > 4) { break; }
+  //     if (g == 2) { continue; }
+  //     if (g == 3) {
+  //     } elseif (g == 1) {
+  //       g = 0;
+  //     }
+  //     continuing {
+  //       g = g + 1;
+  //     }
+  //   }
+  // }
+  auto cmp = [&](ast::BinaryOp op, int value) {
+    return create<ast::BinaryExpression>(op, Expr("g"), Expr(value));
+  };
+  auto block = [&](ast::Statement* stmt) {
+    return create<ast::BlockStatement>(ast::StatementList{stmt});
+  };
+  auto* empty = create<ast::BlockStatement>(ast::StatementList{});
+
+  AST().AddGlobalVariable(Var("g", ast::StorageClass::kPrivate, ty.i32()));
+  auto* loop = create<ast::LoopStatement>(
+      create<ast::BlockStatement>(ast::StatementList{
+          create<ast::IfStatement>(cmp(ast::BinaryOp::kGreaterThan, 4),
+                                   block(create<ast::BreakStatement>()),
+                                   ast::ElseStatementList{}),
+          create<ast::IfStatement>(cmp(ast::BinaryOp::kEqual, 2),
+                                   block(create<ast::ContinueStatement>()),
+                                   ast::ElseStatementList{}),
+          create<ast::IfStatement>(
+              cmp(ast::BinaryOp::kEqual, 3), empty,
+              ast::ElseStatementList{
+                  create<ast::ElseStatement>(
+                      cmp(ast::BinaryOp::kEqual, 1),
+                      block(create<ast::AssignmentStatement>(Expr("g"),
+                                                             Expr(0)))),
+              }),
+      }),
+      block(create<ast::AssignmentStatement>(Expr("g"), Add("g", 1))));
+  AST().Functions().Add(
+      Func("main", ast::VariableList{}, ty.void_(), ast::StatementList{loop},
+           ast::FunctionDecorationList{
+               create<ast::StageDecoration>(ast::PipelineStage::kFragment),
+           }));
+  ASSERT_TRUE(td.Determine()) << td.error();
+  Build();
+
+  Generator plain(built_program());
+  ASSERT_TRUE(plain.Generate()) << plain.error();
+  EXPECT_EQ(Validate(plain.result()), "");
+
+  Generator merged(built_program());
+  merged.set_merge_control_flow(true);
+  merged.set_check_structure(true);
+  ASSERT_TRUE(merged.Generate()) << merged.error();
+  EXPECT_EQ(Validate(merged.result()), "");
+
+  EXPECT_LT(merged.block_count(), plain.block_count());
+  EXPECT_EQ(CountInstructions(merged.result(), spv::Op::OpLabel),
+            merged.block_count());
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
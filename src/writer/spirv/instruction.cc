@@ -14,6 +14,7 @@
 
 #include "src/writer/spirv/instruction.h"
 
+#include <cstring>
 #include <utility>
 
 namespace tint {
@@ -35,6 +36,32 @@ uint32_t Instruction::word_length() const {
   return size;
 }
 
+void EncodeInstruction(spv::Op op,
+                       const OperandList& operands,
+                       std::vector<uint32_t>* out) {
+  uint32_t word_length = 1;  // Initial 1 for the op and size
+  for (const auto& operand : operands) {
+    word_length += operand.length();
+  }
+  out->push_back(word_length << 16 | static_cast<uint32_t>(op));
+
+  for (const auto& operand : operands) {
+    if (operand.IsFloat()) {
+      auto f = operand.to_f();
+      uint32_t bits = 0;
+      memcpy(&bits, &f, sizeof(bits));
+      out->push_back(bits);
+    } else if (operand.IsInt()) {
+      out->push_back(operand.to_i());
+    } else {
+      auto idx = out->size();
+      const auto& str = operand.to_s();
+      out->resize(idx + operand.length(), 0);
+      memcpy(out->data() + idx, str.c_str(), str.size() + 1);
+    }
+  }
+}
+
 }  // namespace spirv
 }  // namespace writer
 }  // namespace tint
@@ -52,6 +52,15 @@ class Instruction {
 /// A list of instructions
 using InstructionList = std::vector<Instruction>;
 
+/// Appends the binary encoding of an instruction to `out`. String operands are
+/// packed inline, nul-terminated and padded to a word boundary.
+/// @param op the instruction opcode
+/// @param operands the instruction operands
+/// @param out the word buffer to append to
+void EncodeInstruction(spv::Op op,
+                       const OperandList& operands,
+                       std::vector<uint32_t>* out);
+
 }  // namespace spirv
 }  // namespace writer
 }  // namespace tint
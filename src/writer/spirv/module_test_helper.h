@@ -0,0 +1,90 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_MODULE_TEST_HELPER_H_
+#define SRC_WRITER_SPIRV_MODULE_TEST_HELPER_H_
+
+#include <string>
+#include <vector>
+
+#include "spirv/unified1/spirv.hpp11"
+#include "src/writer/spirv/binary_writer.h"
+#include "src/writer/spirv/instruction.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+// Helpers for testing the passes that work on a whole assembled module, by
+// building the module from hand-written instructions.
+
+/// @param id the ID to name
+/// @param name the name
+/// @returns the OpName instruction naming `id`
+inline Instruction Name(uint32_t id, const std::string& name) {
+  return Instruction{spv::Op::OpName,
+                     {Operand::Int(id), Operand::String(name)}};
+}
+
+/// @param main_id the ID of the entry point function
+/// @returns the instructions of a fragment shader module, up to and including
+/// the name of the entry point `main_id`
+inline InstructionList Prelude(uint32_t main_id) {
+  return {
+      {spv::Op::OpCapability, {Operand::Int(SpvCapabilityShader)}},
+      {spv::Op::OpMemoryModel,
+       {Operand::Int(SpvAddressingModelLogical),
+        Operand::Int(SpvMemoryModelGLSL450)}},
+      {spv::Op::OpEntryPoint,
+       {Operand::Int(SpvExecutionModelFragment), Operand::Int(main_id),
+        Operand::String("main")}},
+      {spv::Op::OpExecutionMode,
+       {Operand::Int(main_id), Operand::Int(SpvExecutionModeOriginUpperLeft)}},
+      Name(main_id, "main"),
+  };
+}
+
+/// @returns the void type %1, f32 type %2, function type %3 and f32
+/// constant %4
+inline InstructionList Types() {
+  return {
+      {spv::Op::OpTypeVoid, {Operand::Int(1)}},
+      {spv::Op::OpTypeFloat, {Operand::Int(2), Operand::Int(32)}},
+      {spv::Op::OpTypeFunction, {Operand::Int(3), Operand::Int(1)}},
+      {spv::Op::OpConstant,
+       {Operand::Int(2), Operand::Int(4), Operand::Float(1.0f)}},
+  };
+}
+
+/// @param bound the ID bound of the module
+/// @param parts the instructions of the module, in order
+/// @returns the words of the module
+inline std::vector<uint32_t> Assemble(
+    uint32_t bound,
+    const std::vector<InstructionList>& parts) {
+  BinaryWriter bw;
+  bw.WriteHeader(bound);
+  for (const auto& part : parts) {
+    for (const auto& inst : part) {
+      bw.WriteInstruction(inst);
+    }
+  }
+  return bw.result();
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_MODULE_TEST_HELPER_H_
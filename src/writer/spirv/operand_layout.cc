@@ -0,0 +1,194 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/operand_layout.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+size_t WordsHasher::operator()(const std::vector<uint32_t>& words) const {
+  size_t hash = words.size();
+  for (auto word : words) {
+    hash = hash * 31 + word;
+  }
+  return hash;
+}
+
+const char* OperandLayout(spv::Op op) {
+  switch (op) {
+    case spv::Op::OpCapability:
+    case spv::Op::OpMemoryModel:
+      return "L";
+    case spv::Op::OpExtInstImport:
+    case spv::Op::OpName:
+      return "is";
+    case spv::Op::OpMemberName:
+      return "ils";
+    case spv::Op::OpEntryPoint:
+      return "lisI";
+    case spv::Op::OpExecutionMode:
+    case spv::Op::OpDecorate:
+    case spv::Op::OpTypeInt:
+    case spv::Op::OpTypeFloat:
+    case spv::Op::OpSelectionMerge:
+      return "iL";
+    case spv::Op::OpMemberDecorate:
+      return "ilL";
+    case spv::Op::OpTypeVector:
+    case spv::Op::OpTypeMatrix:
+      return "iil";
+    case spv::Op::OpTypePointer:
+      return "ili";
+    case spv::Op::OpTypeImage:
+    case spv::Op::OpConstant:
+    case spv::Op::OpSpecConstant:
+    case spv::Op::OpLoopMerge:
+      return "iiL";
+    case spv::Op::OpVariable:
+    case spv::Op::OpSpecConstantOp:
+      return "iilI";
+    case spv::Op::OpFunction:
+      return "iili";
+    case spv::Op::OpExtInst:
+      return "iiilI";
+    case spv::Op::OpArrayLength:
+      return "iiil";
+    case spv::Op::OpCompositeExtract:
+      return "iiiL";
+    case spv::Op::OpVectorShuffle:
+      return "iiiiL";
+    case spv::Op::OpSwitch:
+      return "iiP";
+    case spv::Op::OpImageWrite:
+      return "iiiM";
+    case spv::Op::OpImageFetch:
+    case spv::Op::OpImageRead:
+    case spv::Op::OpImageSampleImplicitLod:
+    case spv::Op::OpImageSampleExplicitLod:
+      return "iiiiM";
+    case spv::Op::OpImageSampleDrefExplicitLod:
+      return "iiiiiM";
+
+    case spv::Op::OpAccessChain:
+    case spv::Op::OpAll:
+    case spv::Op::OpAny:
+    case spv::Op::OpBitCount:
+    case spv::Op::OpBitReverse:
+    case spv::Op::OpBitcast:
+    case spv::Op::OpBitwiseAnd:
+    case spv::Op::OpBitwiseOr:
+    case spv::Op::OpBitwiseXor:
+    case spv::Op::OpBranch:
+    case spv::Op::OpBranchConditional:
+    case spv::Op::OpCompositeConstruct:
+    case spv::Op::OpConstantComposite:
+    case spv::Op::OpConstantFalse:
+    case spv::Op::OpConstantNull:
+    case spv::Op::OpConstantTrue:
+    case spv::Op::OpConvertFToS:
+    case spv::Op::OpConvertFToU:
+    case spv::Op::OpConvertSToF:
+    case spv::Op::OpConvertUToF:
+    case spv::Op::OpCopyObject:
+    case spv::Op::OpDPdx:
+    case spv::Op::OpDPdxCoarse:
+    case spv::Op::OpDPdxFine:
+    case spv::Op::OpDPdy:
+    case spv::Op::OpDPdyCoarse:
+    case spv::Op::OpDPdyFine:
+    case spv::Op::OpDot:
+    case spv::Op::OpFAdd:
+    case spv::Op::OpFDiv:
+    case spv::Op::OpFMod:
+    case spv::Op::OpFMul:
+    case spv::Op::OpFNegate:
+    case spv::Op::OpFOrdEqual:
+    case spv::Op::OpFOrdGreaterThan:
+    case spv::Op::OpFOrdGreaterThanEqual:
+    case spv::Op::OpFOrdLessThan:
+    case spv::Op::OpFOrdLessThanEqual:
+    case spv::Op::OpFOrdNotEqual:
+    case spv::Op::OpFSub:
+    case spv::Op::OpFunctionCall:
+    case spv::Op::OpFunctionEnd:
+    case spv::Op::OpFunctionParameter:
+    case spv::Op::OpFwidth:
+    case spv::Op::OpFwidthCoarse:
+    case spv::Op::OpFwidthFine:
+    case spv::Op::OpIAdd:
+    case spv::Op::OpIEqual:
+    case spv::Op::OpIMul:
+    case spv::Op::OpINotEqual:
+    case spv::Op::OpISub:
+    case spv::Op::OpImageQueryLevels:
+    case spv::Op::OpImageQuerySamples:
+    case spv::Op::OpImageQuerySize:
+    case spv::Op::OpImageQuerySizeLod:
+    case spv::Op::OpIsInf:
+    case spv::Op::OpIsNan:
+    case spv::Op::OpKill:
+    case spv::Op::OpLabel:
+    case spv::Op::OpLoad:
+    case spv::Op::OpLogicalNot:
+    case spv::Op::OpMatrixTimesMatrix:
+    case spv::Op::OpMatrixTimesScalar:
+    case spv::Op::OpMatrixTimesVector:
+    case spv::Op::OpNop:
+    case spv::Op::OpPhi:
+    case spv::Op::OpReturn:
+    case spv::Op::OpReturnValue:
+    case spv::Op::OpSDiv:
+    case spv::Op::OpSGreaterThan:
+    case spv::Op::OpSGreaterThanEqual:
+    case spv::Op::OpSLessThan:
+    case spv::Op::OpSLessThanEqual:
+    case spv::Op::OpSMod:
+    case spv::Op::OpSNegate:
+    case spv::Op::OpSampledImage:
+    case spv::Op::OpSelect:
+    case spv::Op::OpShiftLeftLogical:
+    case spv::Op::OpShiftRightArithmetic:
+    case spv::Op::OpShiftRightLogical:
+    case spv::Op::OpSpecConstantComposite:
+    case spv::Op::OpSpecConstantFalse:
+    case spv::Op::OpSpecConstantTrue:
+    case spv::Op::OpStore:
+    case spv::Op::OpTypeArray:
+    case spv::Op::OpTypeBool:
+    case spv::Op::OpTypeFunction:
+    case spv::Op::OpTypeRuntimeArray:
+    case spv::Op::OpTypeSampledImage:
+    case spv::Op::OpTypeSampler:
+    case spv::Op::OpTypeStruct:
+    case spv::Op::OpTypeVoid:
+    case spv::Op::OpUDiv:
+    case spv::Op::OpUGreaterThan:
+    case spv::Op::OpUGreaterThanEqual:
+    case spv::Op::OpULessThan:
+    case spv::Op::OpULessThanEqual:
+    case spv::Op::OpUMod:
+    case spv::Op::OpVectorExtractDynamic:
+    case spv::Op::OpVectorTimesMatrix:
+    case spv::Op::OpVectorTimesScalar:
+      return "I";
+
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
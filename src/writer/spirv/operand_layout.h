@@ -0,0 +1,105 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_OPERAND_LAYOUT_H_
+#define SRC_WRITER_SPIRV_OPERAND_LAYOUT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "spirv/unified1/spirv.hpp11"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+/// The number of words in the SPIR-V header
+constexpr size_t kHeaderWords = 5;
+/// The index of the ID bound in the SPIR-V header
+constexpr size_t kBoundIndex = 3;
+
+/// Hashes a sequence of words, such as the operands of an instruction or the
+/// instructions of a function
+struct WordsHasher {
+  /// @param words the words to hash
+  /// @returns the hash of `words`
+  size_t operator()(const std::vector<uint32_t>& words) const;
+};
+
+/// @returns the layout of the operands of `op`, or nullptr if `op` is not
+/// emitted by the Builder. Each character describes the next operand:
+///   'i' an ID, 'l' a literal word, 's' a nul-terminated string.
+/// An upper case character describes all of the remaining operands:
+///   'I' IDs, 'L' literal words, 'P' (literal, ID) pairs, and
+///   'M' optional image operands: a literal mask followed by IDs.
+const char* OperandLayout(spv::Op op);
+
+/// Calls `cb` with a pointer to each ID word of the instruction operands in
+/// [begin, end). `WORD` is `uint32_t` or `const uint32_t`.
+/// @returns false if the operands do not match the layout of `op`
+template <typename WORD, typename F>
+bool ForEachId(spv::Op op, WORD* begin, WORD* end, F&& cb) {
+  const char* layout = OperandLayout(op);
+  if (layout == nullptr) {
+    return false;
+  }
+
+  WORD* word = begin;
+  for (; *layout != '\0' && word != end; layout++) {
+    switch (*layout) {
+      case 'i':
+        cb(word++);
+        break;
+      case 'l':
+        word++;
+        break;
+      case 's':
+        // The string ends with the word holding its nul terminator
+        while (word != end && (*word++ >> 24) != 0) {
+        }
+        break;
+      case 'I':
+        for (; word != end; word++) {
+          cb(word);
+        }
+        break;
+      case 'L':
+        word = end;
+        break;
+      case 'P':
+        while (word != end) {
+          word++;
+          if (word != end) {
+            cb(word++);
+          }
+        }
+        break;
+      case 'M':
+        word++;
+        for (; word != end; word++) {
+          cb(word);
+        }
+        break;
+    }
+  }
+  return word == end;
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_OPERAND_LAYOUT_H_
@@ -0,0 +1,33 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/output_sink.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+OutputSink::~OutputSink() = default;
+
+VectorOutputSink::VectorOutputSink(std::vector<uint32_t>* out) : out_(out) {}
+
+VectorOutputSink::~VectorOutputSink() = default;
+
+void VectorOutputSink::Write(const uint32_t* words, size_t count) {
+  out_->insert(out_->end(), words, words + count);
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
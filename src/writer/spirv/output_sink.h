@@ -0,0 +1,61 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_OUTPUT_SINK_H_
+#define SRC_WRITER_SPIRV_OUTPUT_SINK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+/// OutputSink receives the words of a SPIR-V module as it is assembled. The
+/// spans are written in module order, and are only valid for the duration of
+/// the call to Write().
+class OutputSink {
+ public:
+  virtual ~OutputSink();
+
+  /// Writes the next span of words of the module
+  /// @param words the pointer to the first word
+  /// @param count the number of words
+  virtual void Write(const uint32_t* words, size_t count) = 0;
+};
+
+/// VectorOutputSink is an OutputSink that appends the words to a vector
+class VectorOutputSink : public OutputSink {
+ public:
+  /// Constructor
+  /// @param out the vector to append to. Must outlive the sink.
+  explicit VectorOutputSink(std::vector<uint32_t>* out);
+  ~VectorOutputSink() override;
+
+  /// Appends the words to the vector
+  /// @param words the pointer to the first word
+  /// @param count the number of words
+  void Write(const uint32_t* words, size_t count) override;
+
+ private:
+  std::vector<uint32_t>* const out_;
+};
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_OUTPUT_SINK_H_
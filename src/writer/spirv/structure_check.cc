@@ -0,0 +1,537 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/structure_check.h"
+
+#include <stddef.h>
+
+#include <unordered_set>
+
+#include "spirv/unified1/spirv.h"
+#include "src/writer/spirv/operand_layout.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+/// The sections of the logical layout of a module, in order
+enum class Section {
+  kCapability,
+  kExtInstImport,
+  kMemoryModel,
+  kEntryPoint,
+  kExecutionMode,
+  kDebug,
+  kAnnotation,
+  kGlobal,
+  kFunction,
+};
+
+/// Where the checker is within the current function
+enum class FunctionState {
+  /// Outside of any function
+  kNone,
+  /// After OpFunction, before the first block
+  kParameters,
+  /// Inside a block
+  kBlock,
+  /// After a merge instruction, which must be followed by a branch
+  kMerge,
+  /// After a block terminator
+  kTerminated,
+};
+
+/// The definition of an ID
+struct Definition {
+  /// The word offset of the defining instruction, 0 if not defined
+  size_t word = 0;
+  /// The opcode of the defining instruction
+  spv::Op op = spv::Op::OpNop;
+  /// The ID of the function holding the definition, 0 at module scope
+  uint32_t function = 0;
+};
+
+bool IsType(spv::Op op) {
+  switch (op) {
+    case spv::Op::OpTypeArray:
+    case spv::Op::OpTypeBool:
+    case spv::Op::OpTypeFloat:
+    case spv::Op::OpTypeFunction:
+    case spv::Op::OpTypeImage:
+    case spv::Op::OpTypeInt:
+    case spv::Op::OpTypeMatrix:
+    case spv::Op::OpTypePointer:
+    case spv::Op::OpTypeRuntimeArray:
+    case spv::Op::OpTypeSampledImage:
+    case spv::Op::OpTypeSampler:
+    case spv::Op::OpTypeStruct:
+    case spv::Op::OpTypeVector:
+    case spv::Op::OpTypeVoid:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// @returns true if `op` belongs in the section of types, constants and
+/// global variables
+bool IsGlobal(spv::Op op) {
+  if (IsType(op)) {
+    return true;
+  }
+  switch (op) {
+    case spv::Op::OpConstant:
+    case spv::Op::OpConstantComposite:
+    case spv::Op::OpConstantFalse:
+    case spv::Op::OpConstantNull:
+    case spv::Op::OpConstantTrue:
+    case spv::Op::OpSpecConstant:
+    case spv::Op::OpSpecConstantComposite:
+    case spv::Op::OpSpecConstantFalse:
+    case spv::Op::OpSpecConstantOp:
+    case spv::Op::OpSpecConstantTrue:
+    case spv::Op::OpVariable:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// @returns the section holding `op` when it is used at module scope
+Section SectionOf(spv::Op op) {
+  switch (op) {
+    case spv::Op::OpCapability:
+      return Section::kCapability;
+    case spv::Op::OpExtInstImport:
+      return Section::kExtInstImport;
+    case spv::Op::OpMemoryModel:
+      return Section::kMemoryModel;
+    case spv::Op::OpEntryPoint:
+      return Section::kEntryPoint;
+    case spv::Op::OpExecutionMode:
+      return Section::kExecutionMode;
+    case spv::Op::OpName:
+    case spv::Op::OpMemberName:
+      return Section::kDebug;
+    case spv::Op::OpDecorate:
+    case spv::Op::OpMemberDecorate:
+      return Section::kAnnotation;
+    case spv::Op::OpFunction:
+      return Section::kFunction;
+    default:
+      return Section::kGlobal;
+  }
+}
+
+/// @returns the operand index of the result ID of `op`, or -1 if `op` has no
+/// result. A result at index 1 follows the result type.
+int ResultIndex(spv::Op op) {
+  if (IsType(op)) {
+    return 0;
+  }
+  switch (op) {
+    case spv::Op::OpExtInstImport:
+    case spv::Op::OpLabel:
+      return 0;
+    case spv::Op::OpBranch:
+    case spv::Op::OpBranchConditional:
+    case spv::Op::OpCapability:
+    case spv::Op::OpDecorate:
+    case spv::Op::OpEntryPoint:
+    case spv::Op::OpExecutionMode:
+    case spv::Op::OpFunctionEnd:
+    case spv::Op::OpImageWrite:
+    case spv::Op::OpKill:
+    case spv::Op::OpLoopMerge:
+    case spv::Op::OpMemberDecorate:
+    case spv::Op::OpMemberName:
+    case spv::Op::OpMemoryModel:
+    case spv::Op::OpName:
+    case spv::Op::OpNop:
+    case spv::Op::OpReturn:
+    case spv::Op::OpReturnValue:
+    case spv::Op::OpSelectionMerge:
+    case spv::Op::OpStore:
+    case spv::Op::OpSwitch:
+      return -1;
+    default:
+      return 1;
+  }
+}
+
+bool IsBranch(spv::Op op) {
+  return op == spv::Op::OpBranch || op == spv::Op::OpBranchConditional ||
+         op == spv::Op::OpSwitch;
+}
+
+bool IsTerminator(spv::Op op) {
+  return IsBranch(op) || op == spv::Op::OpReturn ||
+         op == spv::Op::OpReturnValue || op == spv::Op::OpKill;
+}
+
+/// @returns true if operand `index` of the function instruction `op` may
+/// reference an ID that is defined later in the module
+bool MayForwardReference(spv::Op op, size_t index) {
+  switch (op) {
+    case spv::Op::OpBranch:
+    case spv::Op::OpLoopMerge:
+    case spv::Op::OpPhi:
+    case spv::Op::OpSelectionMerge:
+      return true;
+    case spv::Op::OpBranchConditional:
+    case spv::Op::OpSwitch:
+      // Everything but the condition or selector is a label
+      return index > 0;
+    case spv::Op::OpFunctionCall:
+      return index == 2;
+    default:
+      return false;
+  }
+}
+
+/// @returns the minimum number of operand words of an instruction with the
+/// operand `layout`
+uint32_t MinOperandWords(const char* layout) {
+  uint32_t count = 0;
+  for (; *layout >= 'a' && *layout <= 'z'; layout++) {
+    count++;
+  }
+  return count;
+}
+
+std::string IdName(uint32_t id) {
+  return "%" + std::to_string(id);
+}
+
+/// Checks a module in two passes: the first checks the layout and records
+/// the ID definitions, the second checks the ID uses.
+class Checker {
+ public:
+  Checker(const std::vector<uint32_t>& module, std::string* error)
+      : words_(module.data()), size_(module.size()), error_(error) {}
+
+  bool Run() {
+    if (size_ < kHeaderWords || words_[0] != spv::MagicNumber) {
+      return Fail(0, "missing SPIR-V header");
+    }
+    bound_ = words_[kBoundIndex];
+    defs_.resize(bound_);
+    return CheckLayout() && CheckUses() && CheckBuffers();
+  }
+
+ private:
+  bool Fail(size_t word, const std::string& msg) {
+    *error_ = "instruction at word " + std::to_string(word) + ": " + msg;
+    return false;
+  }
+
+  bool CheckLayout() {
+    auto section = Section::kCapability;
+    auto state = FunctionState::kNone;
+    uint32_t function = 0;
+    uint32_t blocks = 0;
+    bool memory_model = false;
+    bool in_prologue = false;
+
+    for (size_t i = kHeaderWords; i < size_;) {
+      const uint32_t count = words_[i] >> 16;
+      if (count == 0 || i + count > size_) {
+        return Fail(i, "bad word count");
+      }
+      auto op = static_cast<spv::Op>(words_[i] & 0xffff);
+      const char* layout = OperandLayout(op);
+      if (layout == nullptr) {
+        return Fail(i, "unknown opcode " + std::to_string(words_[i] & 0xffff));
+      }
+      if (count - 1 < MinOperandWords(layout)) {
+        return Fail(i, "missing operands");
+      }
+
+      if (state == FunctionState::kNone) {
+        auto s = SectionOf(op);
+        if (s == Section::kGlobal && !IsGlobal(op)) {
+          return Fail(i, "instruction is not allowed at module scope");
+        }
+        if (s < section) {
+          return Fail(i, "instruction is out of section order");
+        }
+        if (s > Section::kMemoryModel && !memory_model) {
+          return Fail(i, "missing OpMemoryModel");
+        }
+        if (op == spv::Op::OpMemoryModel) {
+          if (memory_model) {
+            return Fail(i, "duplicate OpMemoryModel");
+          }
+          memory_model = true;
+        }
+        section = s;
+      } else if (op == spv::Op::OpFunction ||
+                 SectionOf(op) != Section::kGlobal ||
+                 (IsGlobal(op) && op != spv::Op::OpVariable)) {
+        return Fail(i, "instruction is not allowed in a function");
+      }
+
+      int result = ResultIndex(op);
+      if (result >= 0) {
+        if (static_cast<uint32_t>(result) + 1 >= count) {
+          return Fail(i, "missing result ID");
+        }
+        uint32_t id = words_[i + 1 + result];
+        if (id == 0 || id >= bound_) {
+          return Fail(i, "result ID " + IdName(id) + " is outside the bound");
+        }
+        if (defs_[id].word != 0) {
+          return Fail(i, "ID " + IdName(id) + " is defined more than once");
+        }
+        defs_[id].word = i;
+        defs_[id].op = op;
+        defs_[id].function = function;
+      }
+
+      switch (op) {
+        case spv::Op::OpEntryPoint:
+          entry_points_.insert(words_[i + 2]);
+          break;
+        case spv::Op::OpDecorate:
+          if (count > 2 && (words_[i + 2] == SpvDecorationBlock ||
+                            words_[i + 2] == SpvDecorationBufferBlock)) {
+            block_structs_.insert(words_[i + 1]);
+          }
+          break;
+        case spv::Op::OpVariable:
+          if (state == FunctionState::kNone) {
+            if (words_[i + 3] == SpvStorageClassUniform ||
+                words_[i + 3] == SpvStorageClassStorageBuffer) {
+              buffers_.push_back(i);
+            }
+            break;
+          }
+          if (blocks != 1 || !in_prologue) {
+            return Fail(i,
+                        "function variable is not at the start of the first "
+                        "block");
+          }
+          break;
+        default:
+          break;
+      }
+
+      switch (op) {
+        case spv::Op::OpFunction:
+          state = FunctionState::kParameters;
+          function = words_[i + 2];
+          blocks = 0;
+          break;
+        case spv::Op::OpFunctionParameter:
+          if (state != FunctionState::kParameters) {
+            return Fail(i, "parameter is not at the start of the function");
+          }
+          break;
+        case spv::Op::OpLabel:
+          if (state == FunctionState::kBlock ||
+              state == FunctionState::kMerge) {
+            return Fail(i, "previous block is not terminated");
+          }
+          state = FunctionState::kBlock;
+          blocks++;
+          in_prologue = blocks == 1;
+          break;
+        case spv::Op::OpFunctionEnd:
+          if (blocks == 0) {
+            return Fail(i, "function has no blocks");
+          }
+          if (state != FunctionState::kTerminated) {
+            return Fail(i, "last block is not terminated");
+          }
+          state = FunctionState::kNone;
+          function = 0;
+          break;
+        default:
+          if (state == FunctionState::kNone) {
+            break;
+          }
+          if (state == FunctionState::kParameters) {
+            return Fail(i, "instruction is before the first block");
+          }
+          if (state == FunctionState::kTerminated) {
+            return Fail(i, "instruction is after the block terminator");
+          }
+          if (state == FunctionState::kMerge && !IsBranch(op)) {
+            return Fail(i, "merge instruction is not followed by a branch");
+          }
+          if (op != spv::Op::OpVariable) {
+            in_prologue = false;
+          }
+          if (op == spv::Op::OpSelectionMerge || op == spv::Op::OpLoopMerge) {
+            state = FunctionState::kMerge;
+          } else if (IsTerminator(op)) {
+            state = FunctionState::kTerminated;
+          } else {
+            state = FunctionState::kBlock;
+          }
+          break;
+      }
+      i += count;
+    }
+
+    if (state != FunctionState::kNone) {
+      return Fail(size_, "function is missing OpFunctionEnd");
+    }
+    if (!memory_model) {
+      return Fail(size_, "missing OpMemoryModel");
+    }
+    return true;
+  }
+
+  bool CheckUses() {
+    uint32_t function = 0;
+    for (size_t i = kHeaderWords; i < size_;) {
+      const uint32_t count = words_[i] >> 16;
+      auto op = static_cast<spv::Op>(words_[i] & 0xffff);
+      if (op == spv::Op::OpFunction) {
+        function = words_[i + 2];
+      }
+
+      // The debug, annotation and entry point instructions come before the
+      // definitions that they refer to.
+      const bool header = SectionOf(op) < Section::kGlobal;
+      const int result = ResultIndex(op);
+      const uint32_t* operands = &words_[i + 1];
+      std::string problem;
+      auto check_use = [&](const uint32_t* word) {
+        auto index = static_cast<size_t>(word - operands);
+        if (problem.empty() && static_cast<int>(index) != result) {
+          problem = CheckUse(i, *word, header, function,
+                             MayForwardReference(op, index));
+        }
+      };
+      if (!ForEachId(op, operands, &words_[i + count], check_use)) {
+        return Fail(i, "operands do not match the opcode");
+      }
+      if (!problem.empty()) {
+        return Fail(i, problem);
+      }
+      if (result == 1 && !IsType(defs_[words_[i + 1]].op)) {
+        return Fail(i, "result type " + IdName(words_[i + 1]) +
+                           " is not a type");
+      }
+      if (!CheckTarget(i, op)) {
+        return false;
+      }
+
+      if (op == spv::Op::OpFunctionEnd) {
+        function = 0;
+      }
+      i += count;
+    }
+    return true;
+  }
+
+  /// @returns a description of the problem with the use of `id` by the
+  /// instruction at word `i`, or an empty string if the use is valid
+  std::string CheckUse(size_t i,
+                       uint32_t id,
+                       bool header,
+                       uint32_t function,
+                       bool may_forward) const {
+    if (id == 0 || id >= bound_ || defs_[id].word == 0) {
+      return "ID " + IdName(id) + " is not defined";
+    }
+    if (header) {
+      return "";
+    }
+    auto& def = defs_[id];
+    if (def.word > i && !may_forward) {
+      return "ID " + IdName(id) + " is used before it is defined";
+    }
+    if (def.function != 0 && def.function != function) {
+      return "ID " + IdName(id) + " is used outside of its function";
+    }
+    return "";
+  }
+
+  /// Checks the target of the entry point, execution mode and struct member
+  /// instruction at word `i`
+  bool CheckTarget(size_t i, spv::Op op) {
+    switch (op) {
+      case spv::Op::OpEntryPoint:
+        if (defs_[words_[i + 2]].op != spv::Op::OpFunction) {
+          return Fail(i, "entry point " + IdName(words_[i + 2]) +
+                             " is not a function");
+        }
+        return true;
+      case spv::Op::OpExecutionMode:
+        if (entry_points_.count(words_[i + 1]) == 0) {
+          return Fail(i, "execution mode target " + IdName(words_[i + 1]) +
+                             " is not an entry point");
+        }
+        return true;
+      case spv::Op::OpMemberDecorate:
+      case spv::Op::OpMemberName: {
+        auto& def = defs_[words_[i + 1]];
+        if (def.op != spv::Op::OpTypeStruct) {
+          return Fail(i, "member target " + IdName(words_[i + 1]) +
+                             " is not a struct");
+        }
+        uint32_t members = (words_[def.word] >> 16) - 2;
+        if (words_[i + 2] >= members) {
+          return Fail(i, "member " + std::to_string(words_[i + 2]) +
+                             " of " + IdName(words_[i + 1]) +
+                             " does not exist");
+        }
+        return true;
+      }
+      default:
+        return true;
+    }
+  }
+
+  /// Checks that the uniform and storage buffer variables point to a Block
+  /// decorated struct
+  bool CheckBuffers() {
+    for (auto i : buffers_) {
+      auto& ptr = defs_[words_[i + 1]];
+      uint32_t type = ptr.op == spv::Op::OpTypePointer
+                          ? words_[ptr.word + 3]
+                          : 0;
+      if (type == 0 || defs_[type].op != spv::Op::OpTypeStruct ||
+          block_structs_.count(type) == 0) {
+        return Fail(i, "buffer variable " + IdName(words_[i + 2]) +
+                           " does not have a Block decorated struct type");
+      }
+    }
+    return true;
+  }
+
+  const uint32_t* words_;
+  size_t size_;
+  std::string* error_;
+  uint32_t bound_ = 0;
+  std::vector<Definition> defs_;
+  std::unordered_set<uint32_t> entry_points_;
+  std::unordered_set<uint32_t> block_structs_;
+  // The word offsets of the uniform and storage buffer variables
+  std::vector<size_t> buffers_;
+};
+
+}  // namespace
+
+bool CheckStructure(const std::vector<uint32_t>& module, std::string* error) {
+  return Checker(module, error).Run();
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
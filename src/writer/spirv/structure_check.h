@@ -0,0 +1,47 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_STRUCTURE_CHECK_H_
+#define SRC_WRITER_SPIRV_STRUCTURE_CHECK_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+/// Checks the structure of a SPIR-V module emitted by the Builder, in time
+/// linear in the size of the module. This catches the errors a bad emitter
+/// makes, at a fraction of the cost of full validation:
+/// * instructions outside of their logical layout section,
+/// * IDs used before their definition, defined twice, outside of the bound,
+///   or used outside of the function that defines them,
+/// * blocks that are not terminated, or with instructions after their
+///   terminator,
+/// * decorations, names and entry points with bad targets, and buffer
+///   variables whose type is missing the Block decoration.
+/// Only the instructions emitted by the Builder are understood.
+/// @param module the words of the module, including the header
+/// @param error set to a description of the first problem found
+/// @returns true if no problem was found
+bool CheckStructure(const std::vector<uint32_t>& module, std::string* error);
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_STRUCTURE_CHECK_H_
@@ -0,0 +1,184 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/structure_check.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spirv/unified1/spirv.hpp11"
+#include "src/writer/spirv/module_test_helper.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+using ::testing::HasSubstr;
+
+/// @returns the function %5, with the label %6, holding `body`
+InstructionList Main(const InstructionList& body) {
+  InstructionList insts = {
+      {spv::Op::OpFunction,
+       {Operand::Int(1), Operand::Int(5),
+        Operand::Int(SpvFunctionControlMaskNone), Operand::Int(3)}},
+      {spv::Op::OpLabel, {Operand::Int(6)}},
+  };
+  insts.insert(insts.end(), body.begin(), body.end());
+  insts.push_back({spv::Op::OpFunctionEnd, {}});
+  return insts;
+}
+
+Instruction FAdd(uint32_t id, uint32_t lhs, uint32_t rhs) {
+  return {spv::Op::OpFAdd, {Operand::Int(2), Operand::Int(id),
+                            Operand::Int(lhs), Operand::Int(rhs)}};
+}
+
+/// @returns the error from checking `module`, or an empty string if the
+/// check passed
+std::string Check(const std::vector<uint32_t>& module) {
+  std::string error;
+  if (CheckStructure(module, &error)) {
+    return "";
+  }
+  EXPECT_FALSE(error.empty());
+  return error;
+}
+
+TEST(StructureCheckTest, Valid) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({FAdd(7, 4, 4), FAdd(8, 7, 4), {spv::Op::OpReturn, {}}})});
+  EXPECT_EQ(Check(module), "");
+}
+
+TEST(StructureCheckTest, Valid_ForwardBranch) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({{spv::Op::OpBranch, {Operand::Int(7)}},
+                 {spv::Op::OpLabel, {Operand::Int(7)}},
+                 {spv::Op::OpReturn, {}}})});
+  EXPECT_EQ(Check(module), "");
+}
+
+TEST(StructureCheckTest, MissingHeader) {
+  EXPECT_THAT(Check({}), HasSubstr("missing SPIR-V header"));
+}
+
+TEST(StructureCheckTest, UndefinedId) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({FAdd(7, 4, 9), {spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("ID %9 is not defined"));
+}
+
+TEST(StructureCheckTest, IdOutsideBound) {
+  auto module = Assemble(
+      8, {Prelude(5), Types(), Main({FAdd(9, 4, 4), {spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("result ID %9 is outside the bound"));
+}
+
+TEST(StructureCheckTest, UseBeforeDefinition) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({FAdd(7, 8, 4), FAdd(8, 4, 4), {spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("ID %8 is used before it is defined"));
+}
+
+TEST(StructureCheckTest, DuplicateDefinition) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({FAdd(7, 4, 4), FAdd(7, 4, 4), {spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("ID %7 is defined more than once"));
+}
+
+TEST(StructureCheckTest, SectionOrder) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           {Name(4, "c")},
+           Main({{spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("out of section order"));
+}
+
+TEST(StructureCheckTest, UnterminatedBlock) {
+  auto module = Assemble(10, {Prelude(5), Types(), Main({FAdd(7, 4, 4)})});
+  EXPECT_THAT(Check(module), HasSubstr("last block is not terminated"));
+}
+
+TEST(StructureCheckTest, InstructionAfterTerminator) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({{spv::Op::OpReturn, {}}, FAdd(7, 4, 4)})});
+  EXPECT_THAT(Check(module), HasSubstr("after the block terminator"));
+}
+
+TEST(StructureCheckTest, MergeWithoutBranch) {
+  auto module = Assemble(
+      10, {Prelude(5), Types(),
+           Main({{spv::Op::OpSelectionMerge,
+                  {Operand::Int(7), Operand::Int(SpvSelectionControlMaskNone)}},
+                 {spv::Op::OpReturn, {}},
+                 {spv::Op::OpLabel, {Operand::Int(7)}},
+                 {spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("not followed by a branch"));
+}
+
+TEST(StructureCheckTest, MemberDecorationOfNonStruct) {
+  auto module = Assemble(
+      10, {Prelude(5),
+           {{spv::Op::OpMemberDecorate,
+             {Operand::Int(2), Operand::Int(0),
+              Operand::Int(SpvDecorationOffset), Operand::Int(0)}}},
+           Types(), Main({{spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module), HasSubstr("member target %2 is not a struct"));
+}
+
+TEST(StructureCheckTest, BufferWithoutBlockDecoration) {
+  auto module = Assemble(
+      12, {Prelude(5), Types(),
+           {{spv::Op::OpTypeStruct, {Operand::Int(9), Operand::Int(2)}},
+            {spv::Op::OpTypePointer,
+             {Operand::Int(10), Operand::Int(SpvStorageClassStorageBuffer),
+              Operand::Int(9)}},
+            {spv::Op::OpVariable,
+             {Operand::Int(10), Operand::Int(11),
+              Operand::Int(SpvStorageClassStorageBuffer)}}},
+           Main({{spv::Op::OpReturn, {}}})});
+  EXPECT_THAT(Check(module),
+              HasSubstr("buffer variable %11 does not have a Block decorated "
+                        "struct type"));
+}
+
+TEST(StructureCheckTest, IdUsedOutsideOfItsFunction) {
+  auto other = InstructionList{
+      {spv::Op::OpFunction,
+       {Operand::Int(1), Operand::Int(8),
+        Operand::Int(SpvFunctionControlMaskNone), Operand::Int(3)}},
+      {spv::Op::OpLabel, {Operand::Int(9)}},
+      FAdd(10, 7, 4),
+      {spv::Op::OpReturn, {}},
+      {spv::Op::OpFunctionEnd, {}},
+  };
+  auto module = Assemble(
+      12, {Prelude(5), Types(), Main({FAdd(7, 4, 4), {spv::Op::OpReturn, {}}}),
+           other});
+  EXPECT_THAT(Check(module),
+              HasSubstr("ID %7 is used outside of its function"));
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
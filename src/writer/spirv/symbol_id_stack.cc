@@ -0,0 +1,80 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/symbol_id_stack.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+SymbolIdStack::SymbolIdStack() = default;
+
+SymbolIdStack::~SymbolIdStack() = default;
+
+void SymbolIdStack::push_scope() {
+  scope_starts_.push_back(shadowed_.size());
+}
+
+void SymbolIdStack::pop_scope() {
+  if (scope_starts_.empty()) {
+    return;
+  }
+  auto start = scope_starts_.back();
+  scope_starts_.pop_back();
+  while (shadowed_.size() > start) {
+    auto& entry = shadowed_.back();
+    ids_[entry.symbol] = entry.id;
+    shadowed_.pop_back();
+  }
+}
+
+void SymbolIdStack::set_global(const Symbol& symbol, uint32_t id) {
+  auto& current = slot(symbol);
+  // If a non-global scope shadows the symbol then the outermost saved entry
+  // holds the global ID.
+  for (auto& entry : shadowed_) {
+    if (entry.symbol == symbol.value()) {
+      entry.id = id;
+      return;
+    }
+  }
+  current = id;
+}
+
+void SymbolIdStack::set(const Symbol& symbol, uint32_t id) {
+  auto& current = slot(symbol);
+  if (!scope_starts_.empty()) {
+    shadowed_.push_back({symbol.value(), current});
+  }
+  current = id;
+}
+
+bool SymbolIdStack::get(const Symbol& symbol, uint32_t* id) const {
+  if (symbol.value() >= ids_.size() || ids_[symbol.value()] == 0) {
+    return false;
+  }
+  *id = ids_[symbol.value()];
+  return true;
+}
+
+uint32_t& SymbolIdStack::slot(const Symbol& symbol) {
+  if (symbol.value() >= ids_.size()) {
+    ids_.resize(symbol.value() + 1, 0);
+  }
+  return ids_[symbol.value()];
+}
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
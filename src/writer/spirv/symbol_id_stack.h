@@ -0,0 +1,82 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WRITER_SPIRV_SYMBOL_ID_STACK_H_
+#define SRC_WRITER_SPIRV_SYMBOL_ID_STACK_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "src/symbol.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+
+/// A scope stack mapping symbols to SPIR-V result IDs.
+/// Symbols are small dense integers and SPIR-V IDs are never 0, so the IDs
+/// are held in a single vector indexed by symbol value. Shadowed IDs are
+/// saved in an undo log and restored when their scope is popped, so pushing
+/// and popping scopes never allocates a map.
+class SymbolIdStack {
+ public:
+  /// Constructor
+  SymbolIdStack();
+  ~SymbolIdStack();
+
+  /// Push a new scope on to the stack
+  void push_scope();
+
+  /// Pop the scope off the top of the stack. The global scope can not be
+  /// popped.
+  void pop_scope();
+
+  /// Sets the ID of `symbol` in the global scope
+  /// @param symbol the symbol
+  /// @param id the SPIR-V ID
+  void set_global(const Symbol& symbol, uint32_t id);
+
+  /// Sets the ID of `symbol` in the top most scope of the stack
+  /// @param symbol the symbol
+  /// @param id the SPIR-V ID
+  void set(const Symbol& symbol, uint32_t id);
+
+  /// Retrieves the ID of `symbol` from the inner most scope declaring it
+  /// @param symbol the symbol to look for
+  /// @param id where to place the ID
+  /// @returns true if the symbol was found, false otherwise
+  bool get(const Symbol& symbol, uint32_t* id) const;
+
+ private:
+  struct Shadowed {
+    uint32_t symbol;
+    uint32_t id;
+  };
+
+  uint32_t& slot(const Symbol& symbol);
+
+  // The current ID of each symbol, indexed by symbol value. 0 if unset.
+  std::vector<uint32_t> ids_;
+  // The IDs replaced by `set()` in the non-global scopes, innermost last
+  std::vector<Shadowed> shadowed_;
+  // The size of `shadowed_` when each non-global scope was pushed
+  std::vector<size_t> scope_starts_;
+};
+
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
+
+#endif  // SRC_WRITER_SPIRV_SYMBOL_ID_STACK_H_
@@ -0,0 +1,112 @@
+// Copyright 2021 The Tint Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/writer/spirv/symbol_id_stack.h"
+
+#include "gtest/gtest.h"
+
+namespace tint {
+namespace writer {
+namespace spirv {
+namespace {
+
+using SymbolIdStackTest = testing::Test;
+
+TEST_F(SymbolIdStackTest, Global) {
+  SymbolIdStack s;
+  Symbol sym(1);
+  s.set_global(sym, 5);
+
+  uint32_t id = 0;
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 5u);
+}
+
+TEST_F(SymbolIdStackTest, Global_CanNotPop) {
+  SymbolIdStack s;
+  Symbol sym(1);
+  s.set_global(sym, 5);
+  s.pop_scope();
+
+  uint32_t id = 0;
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 5u);
+}
+
+TEST_F(SymbolIdStackTest, Missing) {
+  SymbolIdStack s;
+  s.set_global(Symbol(1), 5);
+
+  uint32_t id = 0;
+  EXPECT_FALSE(s.get(Symbol(2), &id));
+  EXPECT_FALSE(s.get(Symbol(100), &id));
+}
+
+TEST_F(SymbolIdStackTest, Scope_RemovedOnPop) {
+  SymbolIdStack s;
+  Symbol sym(3);
+  s.push_scope();
+  s.set(sym, 7);
+
+  uint32_t id = 0;
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 7u);
+
+  s.pop_scope();
+  EXPECT_FALSE(s.get(sym, &id));
+}
+
+TEST_F(SymbolIdStackTest, Scope_ShadowRestoredOnPop) {
+  SymbolIdStack s;
+  Symbol sym(2);
+  s.set_global(sym, 5);
+  s.push_scope();
+  s.set(sym, 6);
+  s.push_scope();
+  s.set(sym, 7);
+  s.set(sym, 8);
+
+  uint32_t id = 0;
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 8u);
+
+  s.pop_scope();
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 6u);
+
+  s.pop_scope();
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 5u);
+}
+
+TEST_F(SymbolIdStackTest, SetGlobal_WhileShadowed) {
+  SymbolIdStack s;
+  Symbol sym(1);
+  s.push_scope();
+  s.set(sym, 6);
+  s.set_global(sym, 5);
+
+  uint32_t id = 0;
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 6u);
+
+  s.pop_scope();
+  EXPECT_TRUE(s.get(sym, &id));
+  EXPECT_EQ(id, 5u);
+}
+
+}  // namespace
+}  // namespace spirv
+}  // namespace writer
+}  // namespace tint
@@ -48,6 +48,10 @@ class TestHelperBase : public ProgramBuilder, public BASE {
     return *spirv_builder;
   }
 
+  /// @returns the program created by Build(), or nullptr if Build() has not
+  /// been called
+  const Program* built_program() const { return program_.get(); }
+
   /// The type determiner
   TypeDeterminer td;
 